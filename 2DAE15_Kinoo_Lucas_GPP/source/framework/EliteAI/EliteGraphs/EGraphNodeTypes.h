@@ -89,6 +89,7 @@ namespace Elite
 			: GraphNode2D(index, pos), m_LineIdx(lineIdx) {}
 		virtual ~NavGraphNode() = default;
 		int GetLineIndex() const { return m_LineIdx; };
+		void SetLineIndex(int lineIdx) { m_LineIdx = lineIdx; }
 	protected:
 		int m_LineIdx;
 	};
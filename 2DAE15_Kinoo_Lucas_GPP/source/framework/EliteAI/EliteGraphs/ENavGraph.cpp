@@ -1,26 +1,48 @@
 #include "stdafx.h"
 #include "ENavGraph.h"
 #include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EAStar.h"
+#include "framework/EliteGeometry/EGeometry2DOperations.h"
 
 using namespace Elite;
 
-Elite::NavGraph::NavGraph(const Polygon& contourMesh, float playerRadius = 1.0f) :
+Elite::NavGraph::NavGraph(const Polygon& contourMesh, float playerRadius /*= 1.0f*/, float tileSize /*= 0.0f*/) :
 	Graph2D(false),
-	m_pNavMeshPolygon(nullptr)
+	m_pNavMeshPolygon(nullptr),
+	m_ContourMesh(contourMesh.GetPoints()),
+	m_PlayerRadius(playerRadius),
+	m_TileSize(tileSize)
 {
-	//Create the navigation mesh (polygon of navigatable area= Contour - Static Shapes)
-	m_pNavMeshPolygon = new Polygon(contourMesh); // Create copy on heap
+	for (const auto& child : contourMesh.GetChildren())
+		m_ContourMesh.AddChild(child);
 
 	//Get all shapes from all static rigidbodies with NavigationCollider flag
 	auto vShapes = PHYSICSWORLD->GetAllStaticShapesInWorld(PhysicsFlags::NavigationCollider);
 
-	//Store all children
+	//Store all children, they are obstacles that can be removed again
 	for (auto shape : vShapes)
 	{
 		shape.ExpandShape(playerRadius);
-		m_pNavMeshPolygon->AddChild(shape);
+		m_vObstacles.push_back(shape);
 	}
 
+	if (IsTiled())
+	{
+		//Tiles cover the bounds of the contour, the last column/row can be smaller
+		m_TilesOrigin = Vector2(m_ContourMesh.GetPosVertMinXPos(), m_ContourMesh.GetPosVertMinYPos());
+		m_TilesEnd = Vector2(m_ContourMesh.GetPosVertMaxXPos(), m_ContourMesh.GetPosVertMaxYPos());
+		m_TileCols = max(1, static_cast<int>(ceilf((m_TilesEnd.x - m_TilesOrigin.x) / m_TileSize)));
+		m_TileRows = max(1, static_cast<int>(ceilf((m_TilesEnd.y - m_TilesOrigin.y) / m_TileSize)));
+		m_vTiles.resize(m_TileCols * m_TileRows);
+
+		LoadAllTiles();
+		return;
+	}
+
+	//Create the navigation mesh (polygon of navigatable area= Contour - Static Shapes)
+	m_pNavMeshPolygon = new Polygon(contourMesh); // Create copy on heap
+	for (const auto& obstacle : m_vObstacles)
+		m_pNavMeshPolygon->AddChild(obstacle);
+
 	//Triangulate
 	m_pNavMeshPolygon->Triangulate();
 
@@ -33,29 +55,230 @@ Elite::NavGraph::~NavGraph()
 	delete m_pNavMeshPolygon;
 	m_pNavMeshPolygon = nullptr;
 
+	for (auto& mesh : m_vTileMeshes)
+		SAFE_DELETE(mesh.pPolygon);
+
 	// Cleanup the connections
 }
 
 int Elite::NavGraph::GetNodeIdxFromLineIdx(int lineIdx) const
 {
-	auto nodeIt = std::find_if(m_Nodes.begin(), m_Nodes.end(), [lineIdx](const NavGraphNode* n) { return n->GetLineIndex() == lineIdx; });
-	if (nodeIt != m_Nodes.end())
+	if (IsTiled())
 	{
-		return (*nodeIt)->GetIndex();
+		const int meshIdx = lineIdx >> TileLineBits;
+		const int meshLineIdx = lineIdx & ((1 << TileLineBits) - 1);
+		if (lineIdx < 0 || meshIdx >= static_cast<int>(m_vTileMeshes.size()) || meshLineIdx >= static_cast<int>(m_vTileMeshes[meshIdx].vLineToNode.size()))
+			return invalid_node_index;
+
+		return m_vTileMeshes[meshIdx].vLineToNode[meshLineIdx];
 	}
 
-	return invalid_node_index;
+	if (lineIdx < 0 || lineIdx >= static_cast<int>(m_vLineToNode.size()))
+		return invalid_node_index;
+
+	return m_vLineToNode[lineIdx];
 }
 
 Elite::Polygon* Elite::NavGraph::GetNavMeshPolygon() const
 {
+	//A tiled graph has no single polygon, every tile has its own
+	ELITE_ASSERT(!IsTiled(), "A tiled navigation graph has no single polygon, use GetNavMeshPolygons().");
 	return m_pNavMeshPolygon;
 }
 
+std::vector<Elite::Polygon*> Elite::NavGraph::GetNavMeshPolygons() const
+{
+	if (!IsTiled())
+		return { m_pNavMeshPolygon };
+
+	std::vector<Polygon*> vpPolygons;
+	for (const auto& mesh : m_vTileMeshes)
+	{
+		if (mesh.pPolygon)
+			vpPolygons.push_back(mesh.pPolygon);
+	}
+	return vpPolygons;
+}
+
+const Elite::Triangle* Elite::NavGraph::GetTriangleFromPosition(const Vector2& position) const
+{
+	if (!IsTiled())
+		return m_pNavMeshPolygon->GetTriangleFromPosition(position);
+
+	//Positions on the border between tiles can round to either tile, so also check the tiles around it
+	const float epsilon = 1e-3f;
+	const Vector2 offsets[5] = { ZeroVector2, Vector2(-epsilon, -epsilon), Vector2(epsilon, -epsilon), Vector2(-epsilon, epsilon), Vector2(epsilon, epsilon) };
+	for (const auto& offset : offsets)
+	{
+		const int tileIdx = GetTileIdxFromPosition(position + offset);
+		if (tileIdx == -1)
+			continue;
+
+		for (const int meshIdx : m_vTiles[tileIdx].vMeshIndices)
+		{
+			if (const auto pTriangle = m_vTileMeshes[meshIdx].pPolygon->GetTriangleFromPosition(position))
+				return pTriangle;
+		}
+	}
+	return nullptr;
+}
+
+std::array<int, 3> Elite::NavGraph::GetNodeIndicesOfTriangle(const Triangle* pTriangle) const
+{
+	//Node on each line of the triangle, invalid_node_index for lines on the border of the mesh
+	std::array<int, 3> nodeIndices{ { invalid_node_index, invalid_node_index, invalid_node_index } };
+	int lineOffset = 0;
+	if (!GetPolygonOfTriangle(pTriangle, lineOffset))
+		return nodeIndices;
+
+	for (int i = 0; i < 3; ++i)
+		nodeIndices[i] = GetNodeIdxFromLineIdx(lineOffset + pTriangle->metaData.IndexLines[i]);
+	return nodeIndices;
+}
+
+const Elite::Line* Elite::NavGraph::GetLine(int lineIdx) const
+{
+	if (IsTiled())
+	{
+		const int meshIdx = lineIdx >> TileLineBits;
+		const int meshLineIdx = lineIdx & ((1 << TileLineBits) - 1);
+		if (lineIdx < 0 || meshIdx >= static_cast<int>(m_vTileMeshes.size()) || !m_vTileMeshes[meshIdx].pPolygon
+			|| meshLineIdx >= static_cast<int>(m_vTileMeshes[meshIdx].pPolygon->GetLines().size()))
+			return nullptr;
+
+		return m_vTileMeshes[meshIdx].pPolygon->GetLines()[meshLineIdx];
+	}
+
+	if (lineIdx < 0 || lineIdx >= static_cast<int>(m_pNavMeshPolygon->GetLines().size()))
+		return nullptr;
+
+	return m_pNavMeshPolygon->GetLines()[lineIdx];
+}
+
+bool Elite::NavGraph::Raycast(const Vector2& start, const Vector2& end, Vector2* pHitPosition /*= nullptr*/) const
+{
+	//Walk from triangle to triangle over the lines the segment crosses, until the triangle containing the end is reached (clear)
+	//or the segment leaves through a line on the border of the navigation mesh (hit)
+	const Triangle* pTriangle = GetTriangleFromPosition(start);
+	if (!pTriangle)
+	{
+		if (pHitPosition)
+			*pHitPosition = start;
+		return false;
+	}
+
+	const Vector2 direction = end - start;
+	const float length = direction.Magnitude();
+	int lineOffset = 0;
+	const Polygon* pPolygon = GetPolygonOfTriangle(pTriangle, lineOffset);
+
+	//Every step moves further along the segment, the step limit only guards against numerical dead ends
+	const int maxSteps = 1 << 16;
+	float previousExitDistance = 0.0f;
+	int entryLineIdx = -1;
+	for (int step = 0; step < maxSteps && pPolygon; ++step)
+	{
+		if (PointInTriangle(end, pTriangle->p1, pTriangle->p2, pTriangle->p3, true))
+			return true;
+
+		//The segment leaves the triangle through the crossed line furthest along it (not the line it came in through)
+		float exitDistance = -FLT_MAX;
+		int exitLineIdx = -1;
+		for (const int lineIdx : pTriangle->metaData.IndexLines)
+		{
+			if (lineIdx == entryLineIdx)
+				continue;
+
+			const Line* pLine = pPolygon->GetLines()[lineIdx];
+			const Vector2 lineDirection = pLine->p2 - pLine->p1;
+			const float denominator = Cross(direction, lineDirection);
+			if (abs(denominator) <= FLT_EPSILON)
+				continue;
+
+			const Vector2 toLine = pLine->p1 - start;
+			const float t = Cross(toLine, lineDirection) / denominator; //Along the segment
+			const float s = Cross(toLine, direction) / denominator; //Along the line
+			const float epsilon = 1e-4f;
+			if (s >= -epsilon && s <= 1.0f + epsilon && t > exitDistance)
+			{
+				exitDistance = t;
+				exitLineIdx = lineIdx;
+			}
+		}
+		if (exitLineIdx == -1 || exitDistance < previousExitDistance - 1e-4f)
+			break;
+		previousExitDistance = exitDistance;
+
+		const Vector2 exitPosition = start + direction * Clamp(exitDistance, 0.0f, 1.0f);
+		const Triangle* pNextTriangle = nullptr;
+		for (const auto pLineTriangle : pPolygon->GetTrianglesFromLineIndex(exitLineIdx))
+		{
+			if (pLineTriangle != pTriangle)
+				pNextTriangle = pLineTriangle;
+		}
+
+		//Lines on the border of a tile continue in the neighbouring tile
+		if (!pNextTriangle && IsTiled() && length > FLT_EPSILON)
+		{
+			const Triangle* pTileTriangle = GetTriangleFromPosition(exitPosition + direction * (1e-3f / length));
+			if (pTileTriangle != pTriangle)
+				pNextTriangle = pTileTriangle;
+		}
+
+		if (!pNextTriangle)
+		{
+			if (pHitPosition)
+				*pHitPosition = exitPosition;
+			return false;
+		}
+
+		//Lines on a tile border are not shared with the triangle on the other side
+		const Polygon* pNextPolygon = GetPolygonOfTriangle(pNextTriangle, lineOffset);
+		entryLineIdx = (pNextPolygon == pPolygon) ? exitLineIdx : -1;
+		pTriangle = pNextTriangle;
+		pPolygon = pNextPolygon;
+	}
+
+	//Numerical dead end, report a hit where the walk stopped
+	if (pHitPosition)
+		*pHitPosition = start + direction * previousExitDistance;
+	return false;
+}
+
+const Elite::Polygon* Elite::NavGraph::GetPolygonOfTriangle(const Triangle* pTriangle, int& lineOffset) const
+{
+	lineOffset = 0;
+	if (!pTriangle)
+		return nullptr;
+	if (!IsTiled())
+		return m_pNavMeshPolygon;
+
+	//Find the mesh owning the triangle, it is one of the meshes of the tile its center is in
+	const int tileIdx = GetTileIdxFromPosition(pTriangle->GetCenter());
+	if (tileIdx == -1)
+		return nullptr;
+
+	const int triangleIdx = pTriangle->metaData.IndexTriangle;
+	for (const int meshIdx : m_vTiles[tileIdx].vMeshIndices)
+	{
+		const auto& vpTriangles = m_vTileMeshes[meshIdx].pPolygon->GetTriangles();
+		if (triangleIdx >= 0 && triangleIdx < static_cast<int>(vpTriangles.size()) && vpTriangles[triangleIdx] == pTriangle)
+		{
+			lineOffset = meshIdx << TileLineBits;
+			return m_vTileMeshes[meshIdx].pPolygon;
+		}
+	}
+	return nullptr;
+}
+
 // TODO: Test implementation
 void Elite::NavGraph::CreateNavigationGraph()
 {
+	LogIfIncomplete(*m_pNavMeshPolygon);
+
 	//1. Go over all the edges of the navigationmesh and create nodes
+	m_vLineToNode.assign(m_pNavMeshPolygon->GetLines().size(), invalid_node_index);
+	m_vFreeNodeIndices.clear();
 
 	// Loop over all the lines (Tip: use GetLines()) of the Polygon
 	// For each line:
@@ -67,7 +290,7 @@ void Elite::NavGraph::CreateNavigationGraph()
 			// Create a NavGraphNode on the graph
 				// Position it in the middle of the line
 				// And give it the lineIdx
-			AddNode(new NavGraphNode(GetNextFreeNodeIndex(), line->index, (line->p1 + line->p2) / 2.0f));
+			AddNavigationNode(line->index);
 		}
 	}
 
@@ -111,3 +334,680 @@ void Elite::NavGraph::CreateNavigationGraph()
 
 	//3. Set the connections cost to the actual distance
 }
+
+int Elite::NavGraph::AddObstacle(const Polygon& shape)
+{
+	//Obstacles are holes in the navigation mesh (clockwise), grown with the player radius
+	Polygon obstacle(shape.GetPoints());
+	obstacle.OrientateWithChildren(Winding::CW);
+	obstacle.ExpandShape(m_PlayerRadius);
+	int obstacleId;
+	if (m_vFreeObstacleIds.empty())
+	{
+		obstacleId = static_cast<int>(m_vObstacles.size());
+		m_vObstacles.push_back(obstacle);
+	}
+	else
+	{
+		obstacleId = m_vFreeObstacleIds.back();
+		m_vFreeObstacleIds.pop_back();
+		m_vObstacles[obstacleId] = obstacle;
+	}
+	m_AreObstaclesDirty = true;
+
+	if (IsTiled())
+	{
+		//Tiles are small, build the loaded tiles under the obstacle again
+		ReloadTilesOverlapping(obstacle);
+		return obstacleId;
+	}
+
+	TriangulationPatch patch;
+	if (m_pNavMeshPolygon->InsertHole(obstacle, &patch))
+		ApplyPatch(patch);
+	else
+		RebuildNavigationMesh(); //Overlapping the border or other obstacles
+
+	return obstacleId;
+}
+
+void Elite::NavGraph::RemoveObstacle(int obstacleId)
+{
+	if (obstacleId < 0 || obstacleId >= static_cast<int>(m_vObstacles.size()) || m_vObstacles[obstacleId].GetAmountVertices() == 0)
+		return;
+
+	if (IsTiled())
+	{
+		const Polygon obstacle = m_vObstacles[obstacleId];
+		m_vObstacles[obstacleId] = Polygon();
+		m_vFreeObstacleIds.push_back(obstacleId);
+		m_AreObstaclesDirty = true;
+		ReloadTilesOverlapping(obstacle);
+		return;
+	}
+
+	TriangulationPatch patch;
+	const bool isPatched = m_pNavMeshPolygon->RemoveHole(m_vObstacles[obstacleId], &patch);
+	m_vObstacles[obstacleId] = Polygon();
+	m_vFreeObstacleIds.push_back(obstacleId);
+
+	if (isPatched)
+		ApplyPatch(patch);
+	else
+		RebuildNavigationMesh();
+}
+
+void Elite::NavGraph::LogIfIncomplete(const Polygon& mesh)
+{
+	if (mesh.IsTriangulatedCompletely() || m_IsIncompleteMeshLogged)
+		return;
+
+	LogMessage("WARNING: the navigation mesh could only be triangulated partly, part of the navigatable area is missing!\n");
+	m_IsIncompleteMeshLogged = true;
+}
+
+void Elite::NavGraph::RebuildNavigationMesh()
+{
+	//Triangulate the contour with all the remaining obstacles again and recreate the graph
+	delete m_pNavMeshPolygon;
+	m_pNavMeshPolygon = new Polygon(m_ContourMesh);
+	for (const auto& obstacle : m_vObstacles)
+	{
+		if (obstacle.GetAmountVertices() > 0)
+			m_pNavMeshPolygon->AddChild(obstacle);
+	}
+	m_pNavMeshPolygon->Triangulate();
+
+	Clear();
+	CreateNavigationGraph();
+}
+
+void Elite::NavGraph::ApplyPatch(const TriangulationPatch& patch)
+{
+	//Same order as the polygon changed: remove, move, add. The graph functions fire the OnGraphModified notifications.
+	//1. Connections that went through the removed triangles (their nodes might still exist)
+	for (const auto& lines : patch.RemovedTriangleLines)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			const int from = GetNodeIdxFromLineIdx(lines[i]);
+			const int to = GetNodeIdxFromLineIdx(lines[(i + 1) % 3]);
+			if (from != invalid_node_index && to != invalid_node_index && GetConnection(from, to))
+				RemoveConnection(from, to);
+		}
+	}
+
+	//2. Nodes of the lines that are gone
+	for (const int lineIdx : patch.RemovedLines)
+	{
+		const int nodeIdx = GetNodeIdxFromLineIdx(lineIdx);
+		if (nodeIdx == invalid_node_index)
+			continue;
+
+		RemoveNode(nodeIdx);
+		m_vFreeNodeIndices.push_back(nodeIdx);
+		m_vLineToNode[lineIdx] = invalid_node_index;
+	}
+
+	//3. Lines that moved to another index
+	for (const auto& move : patch.MovedLines)
+	{
+		const int nodeIdx = m_vLineToNode[move.first];
+		m_vLineToNode[move.second] = nodeIdx;
+		m_vLineToNode[move.first] = invalid_node_index;
+		if (nodeIdx != invalid_node_index)
+			GetNode(nodeIdx)->SetLineIndex(move.second);
+	}
+	m_vLineToNode.resize(m_pNavMeshPolygon->GetLines().size(), invalid_node_index);
+
+	//4. Nodes on the new shared lines and the connections of the new triangles
+	const auto& triangles = m_pNavMeshPolygon->GetTriangles();
+	for (const int triangleIdx : patch.AddedTriangles)
+	{
+		for (const int lineIdx : triangles[triangleIdx]->metaData.IndexLines)
+		{
+			if (GetNodeIdxFromLineIdx(lineIdx) == invalid_node_index && m_pNavMeshPolygon->GetTrianglesFromLineIndex(lineIdx).size() > 1)
+				AddNavigationNode(lineIdx);
+		}
+
+		ConnectTriangle(triangles[triangleIdx]);
+	}
+}
+
+int Elite::NavGraph::AddNavigationNode(int lineIdx)
+{
+	//Node in the middle of the line, reusing the index of a removed node when possible
+	const auto pLine = GetLine(lineIdx);
+	const auto position = (pLine->p1 + pLine->p2) / 2.0f;
+
+	int nodeIdx;
+	if (m_vFreeNodeIndices.empty())
+	{
+		nodeIdx = GetNextFreeNodeIndex();
+		AddNode(new NavGraphNode(nodeIdx, lineIdx, position));
+	}
+	else
+	{
+		nodeIdx = m_vFreeNodeIndices.back();
+		m_vFreeNodeIndices.pop_back();
+		const auto pRemovedNode = m_Nodes[nodeIdx];
+		AddNode(new NavGraphNode(nodeIdx, lineIdx, position));
+		delete pRemovedNode;
+	}
+
+	SetNodeIdxOfLine(lineIdx, nodeIdx);
+	return nodeIdx;
+}
+
+void Elite::NavGraph::SetNodeIdxOfLine(int lineIdx, int nodeIdx)
+{
+	if (IsTiled())
+		m_vTileMeshes[lineIdx >> TileLineBits].vLineToNode[lineIdx & ((1 << TileLineBits) - 1)] = nodeIdx;
+	else
+		m_vLineToNode[lineIdx] = nodeIdx;
+}
+
+void Elite::NavGraph::ConnectTriangle(const Triangle* pTriangle, int lineOffset /*= 0*/)
+{
+	//Connect the nodes on the lines of the triangle with each other
+	const auto nodeIndices = std::array<int, 3>{ {
+		GetNodeIdxFromLineIdx(lineOffset + pTriangle->metaData.IndexLines[0]),
+		GetNodeIdxFromLineIdx(lineOffset + pTriangle->metaData.IndexLines[1]),
+		GetNodeIdxFromLineIdx(lineOffset + pTriangle->metaData.IndexLines[2]) } };
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const int from = nodeIndices[i];
+		const int to = nodeIndices[(i + 1) % 3];
+		if (from != invalid_node_index && to != invalid_node_index && IsUniqueConnection(from, to))
+			AddConnection(new GraphConnection2D(from, to, Distance(GetNodePos(from), GetNodePos(to))));
+	}
+}
+
+void Elite::NavGraph::LoadAllTiles()
+{
+	std::vector<int> tileIndices;
+	for (int tileIdx = 0; tileIdx < static_cast<int>(m_vTiles.size()); ++tileIdx)
+	{
+		if (!m_vTiles[tileIdx].isLoaded)
+			tileIndices.push_back(tileIdx);
+	}
+	LoadTiles(tileIndices);
+}
+
+void Elite::NavGraph::UpdateLoadedTiles(const Vector2& center, float radius)
+{
+	std::vector<int> tileIndices;
+	for (int tileIdx = 0; tileIdx < static_cast<int>(m_vTiles.size()); ++tileIdx)
+	{
+		Vector2 tileMin, tileMax;
+		GetTileBounds(tileIdx, tileMin, tileMax);
+		const bool isNeeded = tileMin.x <= center.x + radius && tileMax.x >= center.x - radius
+			&& tileMin.y <= center.y + radius && tileMax.y >= center.y - radius;
+
+		if (!isNeeded && m_vTiles[tileIdx].isLoaded)
+			UnloadTile(tileIdx);
+		else if (isNeeded && !m_vTiles[tileIdx].isLoaded)
+			tileIndices.push_back(tileIdx);
+	}
+	LoadTiles(tileIndices);
+}
+
+void Elite::NavGraph::GetTileBounds(int tileIdx, Vector2& tileMin, Vector2& tileMax) const
+{
+	//Neighbours calculate their shared border the same way, so it is exactly the same value
+	const int col = tileIdx % m_TileCols;
+	const int row = tileIdx / m_TileCols;
+	tileMin = Vector2(m_TilesOrigin.x + col * m_TileSize, m_TilesOrigin.y + row * m_TileSize);
+	tileMax.x = (col == m_TileCols - 1) ? m_TilesEnd.x : m_TilesOrigin.x + (col + 1) * m_TileSize;
+	tileMax.y = (row == m_TileRows - 1) ? m_TilesEnd.y : m_TilesOrigin.y + (row + 1) * m_TileSize;
+}
+
+int Elite::NavGraph::GetTileIdxFromPosition(const Vector2& position) const
+{
+	if (position.x < m_TilesOrigin.x || position.y < m_TilesOrigin.y || position.x > m_TilesEnd.x || position.y > m_TilesEnd.y)
+		return -1;
+
+	const int col = min(static_cast<int>((position.x - m_TilesOrigin.x) / m_TileSize), m_TileCols - 1);
+	const int row = min(static_cast<int>((position.y - m_TilesOrigin.y) / m_TileSize), m_TileRows - 1);
+	return row * m_TileCols + col;
+}
+
+int Elite::NavGraph::GetTileSideOfLine(int tileIdx, const Line& line) const
+{
+	const float epsilon = 1e-3f;
+	Vector2 tileMin, tileMax;
+	GetTileBounds(tileIdx, tileMin, tileMax);
+
+	if (abs(line.p1.y - tileMin.y) <= epsilon && abs(line.p2.y - tileMin.y) <= epsilon)
+		return 0;
+	if (abs(line.p1.x - tileMax.x) <= epsilon && abs(line.p2.x - tileMax.x) <= epsilon)
+		return 1;
+	if (abs(line.p1.y - tileMax.y) <= epsilon && abs(line.p2.y - tileMax.y) <= epsilon)
+		return 2;
+	if (abs(line.p1.x - tileMin.x) <= epsilon && abs(line.p2.x - tileMin.x) <= epsilon)
+		return 3;
+	return -1;
+}
+
+int Elite::NavGraph::GetNeighbourTileIdx(int tileIdx, int side) const
+{
+	int col = tileIdx % m_TileCols;
+	int row = tileIdx / m_TileCols;
+	switch (side)
+	{
+	case 0: --row; break;
+	case 1: ++col; break;
+	case 2: ++row; break;
+	case 3: --col; break;
+	default: return -1;
+	}
+
+	if (col < 0 || col >= m_TileCols || row < 0 || row >= m_TileRows)
+		return -1;
+	return row * m_TileCols + col;
+}
+
+void Elite::NavGraph::LoadTiles(const std::vector<int>& tileIndices)
+{
+	if (tileIndices.empty())
+		return;
+
+	//Obstacles of the contour and the (expanded) colliders, merged once so the tiles never clip overlapping obstacles.
+	//Only read while building the tiles.
+	if (m_AreObstaclesDirty)
+	{
+		std::vector<Polygon> obstacles = m_ContourMesh.GetChildren();
+		for (const auto& obstacle : m_vObstacles)
+		{
+			if (obstacle.GetAmountVertices() > 0)
+				obstacles.push_back(obstacle);
+		}
+
+		m_vMergedObstacles = UnionPolygons(obstacles);
+		for (auto& obstacle : m_vMergedObstacles)
+			obstacle.OrientateWithChildren(Winding::CW);
+		m_AreObstaclesDirty = false;
+	}
+	const auto& obstacles = m_vMergedObstacles;
+
+	//Triangulate the tiles in parallel, a block per tile because tiles differ a lot in cost
+	std::vector<std::vector<Polygon*>> vTileMeshes(tileIndices.size());
+	const auto& contour = m_ContourMesh.GetPoints();
+	JOBSYSTEM->ParallelFor(static_cast<int>(tileIndices.size()), 1, [this, &tileIndices, &contour, &obstacles, &vTileMeshes](int begin, int end, int)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			Vector2 tileMin, tileMax;
+			GetTileBounds(tileIndices[i], tileMin, tileMax);
+			vTileMeshes[i] = BuildTileMeshes(tileMin, tileMax, contour, obstacles);
+		}
+	});
+
+	//Adding nodes and connections is not thread safe and links to the neighbours, do it afterwards tile by tile
+	for (size_t i = 0; i < tileIndices.size(); ++i)
+	{
+		auto& tile = m_vTiles[tileIndices[i]];
+		for (const auto pPolygon : vTileMeshes[i])
+		{
+			//Their line indices would not fit in a graph line index
+			const bool hasTooManyLines = pPolygon->GetLines().size() >= (1u << TileLineBits);
+			const bool hasTooManyMeshes = m_vFreeTileMeshIndices.empty() && static_cast<int>(m_vTileMeshes.size()) >= MaxTileMeshes;
+			if (hasTooManyLines || hasTooManyMeshes)
+			{
+				if (!m_IsDroppedTileMeshLogged)
+				{
+					if (hasTooManyLines)
+						LogMessage("WARNING: tile %d has too many lines, it is left out of the navigation mesh! Use smaller tiles.\n", tileIndices[i]);
+					else
+						LogMessage("WARNING: too many tile meshes, tile %d is left out of the navigation mesh! Use bigger tiles.\n", tileIndices[i]);
+					m_IsDroppedTileMeshLogged = true;
+				}
+				delete pPolygon;
+				continue;
+			}
+
+			int meshIdx = static_cast<int>(m_vTileMeshes.size());
+			if (m_vFreeTileMeshIndices.empty())
+				m_vTileMeshes.emplace_back();
+			else
+			{
+				meshIdx = m_vFreeTileMeshIndices.back();
+				m_vFreeTileMeshIndices.pop_back();
+			}
+
+			LogIfIncomplete(*pPolygon);
+			auto& mesh = m_vTileMeshes[meshIdx];
+			mesh.pPolygon = pPolygon;
+			mesh.tileIdx = tileIndices[i];
+			mesh.vLineToNode.assign(pPolygon->GetLines().size(), invalid_node_index);
+			tile.vMeshIndices.push_back(meshIdx);
+		}
+		tile.isLoaded = true;
+
+		LinkTile(tileIndices[i]);
+	}
+}
+
+void Elite::NavGraph::UnloadTile(int tileIdx)
+{
+	auto& tile = m_vTiles[tileIdx];
+	for (const int meshIdx : tile.vMeshIndices)
+	{
+		auto& mesh = m_vTileMeshes[meshIdx];
+
+		//Portal nodes are also used by the mesh on the other side of the border
+		for (const auto& portal : mesh.vPortals)
+		{
+			auto& otherMesh = m_vTileMeshes[portal.otherMeshIdx];
+			otherMesh.vLineToNode[portal.otherLineIdx] = invalid_node_index;
+			otherMesh.vPortals.erase(std::find_if(otherMesh.vPortals.begin(), otherMesh.vPortals.end(), [&](const TilePortal& otherPortal)
+				{
+					return otherPortal.lineIdx == portal.otherLineIdx && otherPortal.otherMeshIdx == meshIdx;
+				}));
+		}
+
+		for (const int nodeIdx : mesh.vLineToNode)
+		{
+			if (nodeIdx == invalid_node_index)
+				continue;
+
+			RemoveNode(nodeIdx);
+			m_vFreeNodeIndices.push_back(nodeIdx);
+		}
+
+		SAFE_DELETE(mesh.pPolygon);
+		mesh.tileIdx = -1;
+		mesh.vLineToNode.clear();
+		mesh.vPortals.clear();
+		m_vFreeTileMeshIndices.push_back(meshIdx);
+	}
+
+	tile.vMeshIndices.clear();
+	tile.isLoaded = false;
+}
+
+void Elite::NavGraph::ReloadTilesOverlapping(const Polygon& obstacle)
+{
+	std::vector<int> tileIndices;
+	for (int tileIdx = 0; tileIdx < static_cast<int>(m_vTiles.size()); ++tileIdx)
+	{
+		Vector2 tileMin, tileMax;
+		GetTileBounds(tileIdx, tileMin, tileMax);
+		if (m_vTiles[tileIdx].isLoaded
+			&& obstacle.GetPosVertMinXPos() <= tileMax.x && obstacle.GetPosVertMaxXPos() >= tileMin.x
+			&& obstacle.GetPosVertMinYPos() <= tileMax.y && obstacle.GetPosVertMaxYPos() >= tileMin.y)
+		{
+			UnloadTile(tileIdx);
+			tileIndices.push_back(tileIdx);
+		}
+	}
+	LoadTiles(tileIndices);
+}
+
+void Elite::NavGraph::LinkTile(int tileIdx)
+{
+	const float epsilonSquared = 1e-6f;
+	const auto& tile = m_vTiles[tileIdx];
+
+	//1. Nodes on the lines shared by two triangles of the same mesh
+	for (const int meshIdx : tile.vMeshIndices)
+	{
+		const auto pPolygon = m_vTileMeshes[meshIdx].pPolygon;
+		for (const auto pLine : pPolygon->GetLines())
+		{
+			if (pPolygon->GetTrianglesFromLineIndex(pLine->index).size() > 1)
+				AddNavigationNode((meshIdx << TileLineBits) | pLine->index);
+		}
+	}
+
+	//2. Portals, lines on the border that are also a line of a loaded neighbour. Both tiles cut the obstacles
+	//on their shared border the same way, so the border lines match.
+	for (const int meshIdx : tile.vMeshIndices)
+	{
+		const auto pPolygon = m_vTileMeshes[meshIdx].pPolygon;
+		for (const auto pLine : pPolygon->GetLines())
+		{
+			const int side = GetTileSideOfLine(tileIdx, *pLine);
+			const int neighbourIdx = GetNeighbourTileIdx(tileIdx, side);
+			if (neighbourIdx == -1 || !m_vTiles[neighbourIdx].isLoaded)
+				continue;
+
+			for (const int neighbourMeshIdx : m_vTiles[neighbourIdx].vMeshIndices)
+			{
+				const auto pNeighbourPolygon = m_vTileMeshes[neighbourMeshIdx].pPolygon;
+				const auto& vpNeighbourLines = pNeighbourPolygon->GetLines();
+				const auto it = std::find_if(vpNeighbourLines.begin(), vpNeighbourLines.end(), [&](const Line* pOther)
+					{
+						return (DistanceSquared(pOther->p1, pLine->p1) <= epsilonSquared && DistanceSquared(pOther->p2, pLine->p2) <= epsilonSquared)
+							|| (DistanceSquared(pOther->p1, pLine->p2) <= epsilonSquared && DistanceSquared(pOther->p2, pLine->p1) <= epsilonSquared);
+					});
+				if (it == vpNeighbourLines.end())
+					continue;
+
+				const int nodeIdx = AddNavigationNode((meshIdx << TileLineBits) | pLine->index);
+				SetNodeIdxOfLine((neighbourMeshIdx << TileLineBits) | (*it)->index, nodeIdx);
+				m_vTileMeshes[meshIdx].vPortals.push_back({ pLine->index, neighbourMeshIdx, (*it)->index });
+				m_vTileMeshes[neighbourMeshIdx].vPortals.push_back({ (*it)->index, meshIdx, pLine->index });
+
+				//The triangle on the other side was connected before this node existed
+				ConnectTriangle(pNeighbourPolygon->GetTrianglesFromLineIndex((*it)->index)[0], neighbourMeshIdx << TileLineBits);
+				break;
+			}
+		}
+	}
+
+	//3. Connections between the nodes of every triangle
+	for (const int meshIdx : tile.vMeshIndices)
+	{
+		for (const auto pTriangle : m_vTileMeshes[meshIdx].pPolygon->GetTriangles())
+			ConnectTriangle(pTriangle, meshIdx << TileLineBits);
+	}
+}
+
+std::vector<Elite::Polygon*> Elite::NavGraph::BuildTileMeshes(const Vector2& tileMin, const Vector2& tileMax, const std::vector<Vector2>& contour, const std::vector<Polygon>& obstacles)
+{
+	//Runs on a worker thread, only reads the contour and the obstacles (no cached polygon data) and creates new polygons
+	const float epsilon = 1e-4f;
+	const float width = tileMax.x - tileMin.x;
+	const float height = tileMax.y - tileMin.y;
+	const float perimeter = 2.0f * (width + height);
+
+	//Distance along the border, counter clockwise from the bottom left corner (-1 when not on the border)
+	const auto getBorderPosition = [&](const Vector2& p)
+	{
+		if (abs(p.y - tileMin.y) <= epsilon && p.x < tileMax.x - epsilon)
+			return p.x - tileMin.x;
+		if (abs(p.x - tileMax.x) <= epsilon && p.y < tileMax.y - epsilon)
+			return width + p.y - tileMin.y;
+		if (abs(p.y - tileMax.y) <= epsilon && p.x > tileMin.x + epsilon)
+			return width + height + tileMax.x - p.x;
+		if (abs(p.x - tileMin.x) <= epsilon)
+			return 2.0f * width + height + tileMax.y - p.y;
+		return -1.0f;
+	};
+	const auto isOnSameSide = [&](const Vector2& a, const Vector2& b)
+	{
+		return (abs(a.y - tileMin.y) <= epsilon && abs(b.y - tileMin.y) <= epsilon) || (abs(a.x - tileMax.x) <= epsilon && abs(b.x - tileMax.x) <= epsilon)
+			|| (abs(a.y - tileMax.y) <= epsilon && abs(b.y - tileMax.y) <= epsilon) || (abs(a.x - tileMin.x) <= epsilon && abs(b.x - tileMin.x) <= epsilon);
+	};
+
+	//The part of a shape inside the tile, counter clockwise without duplicate points. Empty when no area of it is inside.
+	const auto clipToTile = [&](const std::vector<Vector2>& points)
+	{
+		auto clipped = ClipPolygonToRect(points, tileMin, tileMax);
+		clipped.erase(std::unique(clipped.begin(), clipped.end(), [&](const Vector2& a, const Vector2& b) { return DistanceSquared(a, b) <= epsilon * epsilon; }), clipped.end());
+		while (clipped.size() > 1 && DistanceSquared(clipped.front(), clipped.back()) <= epsilon * epsilon)
+			clipped.pop_back();
+		if (clipped.size() < 3)
+			return std::vector<Vector2>{};
+
+		auto area = 0.0f;
+		for (size_t i = 0; i < clipped.size(); ++i)
+			area += Cross(clipped[i], clipped[(i + 1) % clipped.size()]);
+		if (abs(area) * 0.5f <= epsilon)
+			return std::vector<Vector2>{};
+		if (area < 0.0f)
+			std::reverse(clipped.begin(), clipped.end()); //Counter clockwise, walking along the border in the same direction as the tile
+		return clipped;
+	};
+
+	//1. Clip the contour and the obstacles to the tile, the parts of them that cross the tile cut pieces out of its outline.
+	//A cut keeps the navigatable area on its left, it goes from where it enters the border to where it leaves it again.
+	struct Cut
+	{
+		float entry;
+		float exit;
+		std::vector<Vector2> points;
+	};
+	std::vector<Cut> cuts;
+	//Every edge leaving the border starts a cut, it ends where the clipped shape reaches the border again.
+	//Returns false when all edges are on the border, then the shape covers the whole tile.
+	const auto addCuts = [&](const std::vector<Vector2>& clipped, const std::vector<float>& borderPositions, bool isObstacle)
+	{
+		const size_t amountCuts = cuts.size();
+		const int amountPoints = static_cast<int>(clipped.size());
+		for (int i = 0; i < amountPoints; ++i)
+		{
+			if (borderPositions[i] < 0.0f || isOnSameSide(clipped[i], clipped[(i + 1) % amountPoints]))
+				continue;
+
+			Cut cut{};
+			cut.points.push_back(clipped[i]);
+			int j = (i + 1) % amountPoints;
+			for (; borderPositions[j] < 0.0f; j = (j + 1) % amountPoints)
+				cut.points.push_back(clipped[j]);
+			cut.points.push_back(clipped[j]);
+
+			//The area is outside an obstacle, so its cut runs clockwise around it
+			cut.entry = isObstacle ? borderPositions[j] : borderPositions[i];
+			cut.exit = isObstacle ? borderPositions[i] : borderPositions[j];
+			if (isObstacle)
+				std::reverse(cut.points.begin(), cut.points.end());
+			cuts.push_back(cut);
+		}
+		return cuts.size() > amountCuts;
+	};
+
+	//The tiles cover the bounds of the contour, so the contour always reaches the border of a tile it is in
+	const auto contourInTile = clipToTile(contour);
+	if (contourInTile.empty())
+		return {};
+	std::vector<float> contourBorderPositions(contourInTile.size());
+	std::transform(contourInTile.begin(), contourInTile.end(), contourBorderPositions.begin(), getBorderPosition);
+	const bool isTileInContour = !addCuts(contourInTile, contourBorderPositions, false);
+
+	//Obstacles inside are holes
+	std::vector<std::vector<Vector2>> holes;
+	for (const auto& obstacle : obstacles)
+	{
+		//Skip obstacles outside the tile
+		const auto& points = obstacle.GetPoints();
+		if (points.size() < 3
+			|| std::all_of(points.begin(), points.end(), [&](const Vector2& p) { return p.x <= tileMin.x; })
+			|| std::all_of(points.begin(), points.end(), [&](const Vector2& p) { return p.x >= tileMax.x; })
+			|| std::all_of(points.begin(), points.end(), [&](const Vector2& p) { return p.y <= tileMin.y; })
+			|| std::all_of(points.begin(), points.end(), [&](const Vector2& p) { return p.y >= tileMax.y; }))
+			continue;
+
+		const auto clipped = clipToTile(points);
+		if (clipped.empty())
+			continue;
+
+		std::vector<float> borderPositions(clipped.size());
+		std::transform(clipped.begin(), clipped.end(), borderPositions.begin(), getBorderPosition);
+		if (std::all_of(borderPositions.begin(), borderPositions.end(), [](float position) { return position < 0.0f; }))
+		{
+			holes.push_back(clipped);
+			continue;
+		}
+
+		if (!addCuts(clipped, borderPositions, true))
+			return {};
+	}
+
+	//2. Walk along the border, every cut that is reached is followed to where it leaves the border again.
+	//Obstacles crossing the whole tile split it in multiple outlines.
+	std::vector<std::vector<Vector2>> outlines;
+	if (cuts.empty())
+		outlines.push_back({ tileMin, { tileMax.x, tileMin.y }, tileMax, { tileMin.x, tileMax.y } });
+
+	const Vector2 corners[4] = { tileMin, { tileMax.x, tileMin.y }, tileMax, { tileMin.x, tileMax.y } };
+	const float cornerPositions[4] = { 0.0f, width, width + height, 2.0f * width + height };
+	std::vector<bool> isCutUsed(cuts.size(), false);
+	for (size_t firstCut = 0; firstCut < cuts.size(); ++firstCut)
+	{
+		if (isCutUsed[firstCut])
+			continue;
+
+		std::vector<Vector2> outline;
+		size_t currentCut = firstCut;
+		do
+		{
+			isCutUsed[currentCut] = true;
+			outline.insert(outline.end(), cuts[currentCut].points.begin(), cuts[currentCut].points.end());
+
+			//Closest cut further along the border. A cut entering where the current one leaves only follows it directly when the area
+			//between them is on the inside of the tile, else the area just touches the border there and the border is walked first.
+			const float exit = cuts[currentCut].exit;
+			const auto& currentPoints = cuts[currentCut].points;
+			const Vector2 exitDirection = currentPoints[currentPoints.size() - 1] - currentPoints[currentPoints.size() - 2];
+			size_t nextCut = currentCut;
+			float nextDistance = FLT_MAX;
+			for (size_t i = 0; i < cuts.size(); ++i)
+			{
+				float distance = cuts[i].entry - exit;
+				const bool isTouching = abs(distance) < epsilon
+					&& (i == currentCut || Cross(cuts[i].points[1] - cuts[i].points[0], -exitDirection) <= 0.0f);
+				if (distance < -epsilon || isTouching)
+					distance += perimeter;
+				if (distance < nextDistance)
+				{
+					nextDistance = distance;
+					nextCut = i;
+				}
+			}
+
+			//Corners passed on the way to it
+			std::vector<std::pair<float, int>> passedCorners;
+			for (int i = 0; i < 4; ++i)
+			{
+				float distance = cornerPositions[i] - exit;
+				if (distance < epsilon)
+					distance += perimeter;
+				if (distance < nextDistance - epsilon)
+					passedCorners.push_back({ distance, i });
+			}
+			std::sort(passedCorners.begin(), passedCorners.end());
+			for (const auto& corner : passedCorners)
+				outline.push_back(corners[corner.second]);
+
+			currentCut = nextCut;
+		} while (!isCutUsed[currentCut]);
+
+		//Back at the start, else overlapping obstacles mixed up the cuts
+		if (currentCut != firstCut)
+			continue;
+
+		outline.erase(std::unique(outline.begin(), outline.end(), [&](const Vector2& a, const Vector2& b) { return DistanceSquared(a, b) <= epsilon * epsilon; }), outline.end());
+		while (outline.size() > 1 && DistanceSquared(outline.front(), outline.back()) <= epsilon * epsilon)
+			outline.pop_back();
+		if (outline.size() >= 3)
+			outlines.push_back(outline);
+	}
+
+	//3. Triangulate every outline with the holes inside it
+	std::vector<Polygon*> vpMeshes;
+	for (const auto& outline : outlines)
+	{
+		const auto pPolygon = new Polygon(outline);
+		for (const auto& hole : holes)
+		{
+			if ((outlines.size() == 1 && isTileInContour) || IsPointInPolygon(outline, hole.front()))
+				pPolygon->AddChild(Polygon(hole));
+		}
+		pPolygon->Triangulate();
+		vpMeshes.push_back(pPolygon);
+	}
+	return vpMeshes;
+}
@@ -9,17 +9,99 @@ namespace Elite
 	class NavGraph final : public Graph2D<NavGraphNode, GraphConnection2D>
 	{
 	public:
-		NavGraph(const Polygon& baseMesh, float playerRadius);
+		//A tileSize > 0 splits the bounds of the base mesh in tiles of that size, each tile is triangulated on its own (in parallel)
+		//and stitched to its neighbours through the lines on their shared border. Without tiles one polygon covers the whole base mesh.
+		NavGraph(const Polygon& baseMesh, float playerRadius, float tileSize = 0.0f);
 		~NavGraph();
 
 		int GetNodeIdxFromLineIdx(int lineIdx) const;
-		Polygon* GetNavMeshPolygon() const;
+		Polygon* GetNavMeshPolygon() const; //Only without tiles (asserts and returns nullptr when tiled), GetNavMeshPolygons() works in both modes
+		std::vector<Polygon*> GetNavMeshPolygons() const; //The polygon of every loaded tile
+
+		//Navigation mesh queries that work with and without tiles
+		const Triangle* GetTriangleFromPosition(const Vector2& position) const;
+		std::array<int, 3> GetNodeIndicesOfTriangle(const Triangle* pTriangle) const;
+		const Line* GetLine(int lineIdx) const;
+
+		//Straight line query: walks the triangles crossed by the segment, so the cost grows with the amount of triangles crossed.
+		//Returns true when the whole segment is on the navigation mesh, else false with pHitPosition where it leaves the mesh.
+		bool Raycast(const Vector2& start, const Vector2& end, Vector2* pHitPosition = nullptr) const;
+
+		//Dynamic obstacles (doors, barricades, ...), expanded with the player radius like the static colliders.
+		//Only the navigation mesh around the obstacle is rebuild, returns an id to remove the obstacle again.
+		int AddObstacle(const Polygon& shape);
+		void RemoveObstacle(int obstacleId);
+
+		//Tiles, only the loaded tiles are part of the graph. All tiles are loaded on construction.
+		bool IsTiled() const { return m_TileSize > 0.0f; }
+		void LoadAllTiles();
+		void UpdateLoadedTiles(const Vector2& center, float radius); //Only keep the tiles overlapping the square around center loaded
 
 	private:
+		//Border line of a tile mesh that shares its node with the matching line of a mesh in the neighbouring tile
+		struct TilePortal final
+		{
+			int lineIdx = -1;
+			int otherMeshIdx = -1;
+			int otherLineIdx = -1;
+		};
+		//Part of the navigation mesh inside a tile, a tile can have multiple when obstacles cut it in pieces
+		struct TileMesh final
+		{
+			Polygon* pPolygon = nullptr;
+			int tileIdx = -1;
+			std::vector<int> vLineToNode;
+			std::vector<TilePortal> vPortals; //Their lines in the neighbouring meshes lose the node when this mesh is unloaded
+		};
+		struct Tile final
+		{
+			bool isLoaded = false;
+			std::vector<int> vMeshIndices;
+		};
+		static const int TileLineBits = 16; //Line indices in tiled mode are (mesh index << TileLineBits) | line index in that mesh
+		static const int MaxTileMeshes = 1 << (31 - TileLineBits); //So those line indices stay positive
+
 		//--- Datamembers ---
 		Polygon* m_pNavMeshPolygon = nullptr; //Polygon that represents navigation mesh
+		Polygon m_ContourMesh; //Navigatable area without obstacles, used when the whole mesh has to be rebuild
+		float m_PlayerRadius = 1.0f;
+		std::vector<Polygon> m_vObstacles; //Expanded obstacle shapes, indexed by obstacle id (empty once removed)
+		std::vector<int> m_vFreeObstacleIds; //Ids of removed obstacles, reused for new obstacles
+		std::vector<int> m_vLineToNode; //Node index for each line of the navigation mesh
+		std::vector<int> m_vFreeNodeIndices; //Indices of removed nodes, reused for new nodes
+
+		float m_TileSize = 0.0f;
+		Vector2 m_TilesOrigin = {};
+		Vector2 m_TilesEnd = {};
+		int m_TileCols = 0;
+		int m_TileRows = 0;
+		std::vector<Tile> m_vTiles;
+		std::vector<TileMesh> m_vTileMeshes;
+		std::vector<int> m_vFreeTileMeshIndices;
+		std::vector<Polygon> m_vMergedObstacles; //Union of the contour children and obstacles, the input of the tiles
+		bool m_AreObstaclesDirty = true;
+		bool m_IsIncompleteMeshLogged = false; //Only the first partly triangulated mesh is logged, the mesh is rebuilt often
+		bool m_IsDroppedTileMeshLogged = false; //Only the first tile mesh left out is logged, tiles are loaded again while streaming
 
 		void CreateNavigationGraph();
+		void LogIfIncomplete(const Polygon& mesh);
+		void RebuildNavigationMesh();
+		void ApplyPatch(const TriangulationPatch& patch);
+		int AddNavigationNode(int lineIdx);
+		void SetNodeIdxOfLine(int lineIdx, int nodeIdx);
+		void ConnectTriangle(const Triangle* pTriangle, int lineOffset = 0);
+		const Polygon* GetPolygonOfTriangle(const Triangle* pTriangle, int& lineOffset) const; //lineOffset turns its line indices into graph line indices
+
+		//Tiles
+		void GetTileBounds(int tileIdx, Vector2& tileMin, Vector2& tileMax) const;
+		int GetTileIdxFromPosition(const Vector2& position) const;
+		int GetTileSideOfLine(int tileIdx, const Line& line) const; //0 bottom, 1 right, 2 top, 3 left, -1 not on a side
+		int GetNeighbourTileIdx(int tileIdx, int side) const;
+		void LoadTiles(const std::vector<int>& tileIndices);
+		void UnloadTile(int tileIdx);
+		void ReloadTilesOverlapping(const Polygon& obstacle);
+		void LinkTile(int tileIdx);
+		static std::vector<Polygon*> BuildTileMeshes(const Vector2& tileMin, const Vector2& tileMax, const std::vector<Vector2>& contour, const std::vector<Polygon>& obstacles);
 
 	private:
 		NavGraph(const NavGraph& other) = delete;
@@ -0,0 +1,187 @@
+#include "stdafx.h"
+#include "ENavMeshQuery.h"
+
+Elite::NavMeshQuery::NavMeshQuery(NavGraph const* pNavGraph, Heuristic hFunction /*= HeuristicFunctions::Manhattan*/) :
+	m_pNavGraph(pNavGraph),
+	m_HeuristicFunction(hFunction)
+{
+}
+
+int Elite::NavMeshQuery::FindPath(const Vector2& startPos, const Vector2& endPos, Span<Vector2> path)
+{
+	if (!FindSmoothPath(startPos, endPos))
+		return 0;
+
+	const int amountPoints = static_cast<int>(m_vPath.size());
+	std::copy(m_vPath.begin(), m_vPath.begin() + min(amountPoints, path.size()), path.begin());
+	return amountPoints;
+}
+
+bool Elite::NavMeshQuery::FindPath(const Vector2& startPos, const Vector2& endPos, std::vector<Vector2>& path)
+{
+	path.clear();
+	if (!FindSmoothPath(startPos, endPos))
+		return false;
+
+	path.insert(path.end(), m_vPath.begin(), m_vPath.end());
+	return true;
+}
+
+void Elite::NavMeshQuery::SetDebugOutput(std::vector<Vector2>* pNodePositions, std::vector<Portal>* pPortals)
+{
+	m_pDebugNodePositions = pNodePositions;
+	m_pDebugPortals = pPortals;
+}
+
+bool Elite::NavMeshQuery::FindSmoothPath(const Vector2& startPos, const Vector2& endPos)
+{
+	m_vPath.clear();
+	if (m_pDebugNodePositions)
+		m_pDebugNodePositions->clear();
+	if (m_pDebugPortals)
+		m_pDebugPortals->clear();
+
+	//Get the start and end triangle
+	const Triangle* pStartTriangle = m_pNavGraph ? m_pNavGraph->GetTriangleFromPosition(startPos) : nullptr;
+	const Triangle* pEndTriangle = m_pNavGraph ? m_pNavGraph->GetTriangleFromPosition(endPos) : nullptr;
+	if (!pStartTriangle || !pEndTriangle)
+		return false;
+
+	//Same triangle or a straight line on the mesh, no search needed
+	if (pStartTriangle == pEndTriangle || m_pNavGraph->Raycast(startPos, endPos))
+	{
+		m_vPath.push_back(endPos);
+		return true;
+	}
+
+	if (!FindNodePath(startPos, endPos, m_pNavGraph->GetNodeIndicesOfTriangle(pStartTriangle), m_pNavGraph->GetNodeIndicesOfTriangle(pEndTriangle)))
+		return false;
+
+	if (m_pDebugNodePositions)
+	{
+		for (const int nodeIdx : m_vNodePath)
+			m_pDebugNodePositions->push_back(GetNodePosition(nodeIdx, startPos, endPos));
+	}
+
+	//Portals: degenerate ones on the start and end, the lines of the nodes in between
+	m_vPortals.clear();
+	m_vPortals.emplace_back(Line(startPos, startPos));
+	Vector2 previousPosition = startPos;
+	for (size_t i = 1; i < m_vNodePath.size() - 1; ++i)
+	{
+		const NavGraphNode* pNode = m_pNavGraph->GetNode(m_vNodePath[i]);
+		m_vPortals.push_back(SSFA::CreatePortal(*m_pNavGraph->GetLine(pNode->GetLineIndex()), previousPosition));
+		previousPosition = pNode->GetPosition();
+	}
+	m_vPortals.emplace_back(Line(endPos, endPos));
+
+	if (m_pDebugPortals)
+		m_pDebugPortals->insert(m_pDebugPortals->end(), m_vPortals.begin(), m_vPortals.end());
+
+	SSFA::OptimizePortals(m_vPortals, m_vPath);
+	return true;
+}
+
+bool Elite::NavMeshQuery::FindNodePath(const Vector2& startPos, const Vector2& endPos, const std::array<int, 3>& startNodes, const std::array<int, 3>& endNodes)
+{
+	//The graph can change between queries (obstacles, tiles), grow the records with it
+	const int amountNodes = m_pNavGraph->GetNrOfNodes();
+	const int startNodeIdx = amountNodes;
+	const int endNodeIdx = amountNodes + 1;
+	if (static_cast<int>(m_vNodeRecords.size()) < amountNodes + 2)
+		m_vNodeRecords.resize(amountNodes + 2);
+
+	//New query id instead of clearing the records, they only have to be reset when the id wraps around
+	if (++m_QueryId == 0)
+	{
+		for (auto& record : m_vNodeRecords)
+			record.queryId = 0;
+		m_QueryId = 1;
+	}
+
+	m_vOpenList.clear();
+	VisitNode(startNodeIdx, invalid_node_index, 0.f, startPos, endPos);
+
+	const auto isEndNode = [&endNodes](int nodeIdx) { return nodeIdx == endNodes[0] || nodeIdx == endNodes[1] || nodeIdx == endNodes[2]; };
+
+	bool isEndReached = false;
+	while (!m_vOpenList.empty())
+	{
+		std::pop_heap(m_vOpenList.begin(), m_vOpenList.end());
+		const OpenRecord current = m_vOpenList.back();
+		m_vOpenList.pop_back();
+
+		//Skip outdated entries, the node was reached cheaper afterwards
+		NodeRecord& currentRecord = m_vNodeRecords[current.nodeIdx];
+		if (currentRecord.isClosed || current.costSoFar != currentRecord.costSoFar)
+			continue;
+		currentRecord.isClosed = true;
+
+		if (current.nodeIdx == endNodeIdx)
+		{
+			isEndReached = true;
+			break;
+		}
+
+		if (current.nodeIdx == startNodeIdx)
+		{
+			//Virtual start node: connected to the nodes on the lines of the start triangle
+			for (const int nodeIdx : startNodes)
+			{
+				if (nodeIdx == invalid_node_index)
+					continue;
+				const Vector2 position = m_pNavGraph->GetNode(nodeIdx)->GetPosition();
+				VisitNode(nodeIdx, startNodeIdx, Distance(startPos, position), position, endPos);
+			}
+			continue;
+		}
+
+		const Vector2 currentPosition = m_pNavGraph->GetNode(current.nodeIdx)->GetPosition();
+		for (const auto pConnection : m_pNavGraph->GetNodeConnections(current.nodeIdx))
+		{
+			const int nodeIdx = pConnection->GetTo();
+			VisitNode(nodeIdx, current.nodeIdx, current.costSoFar + pConnection->GetCost(), m_pNavGraph->GetNode(nodeIdx)->GetPosition(), endPos);
+		}
+
+		//Virtual end node: connected to the nodes on the lines of the end triangle
+		if (isEndNode(current.nodeIdx))
+			VisitNode(endNodeIdx, current.nodeIdx, current.costSoFar + Distance(currentPosition, endPos), endPos, endPos);
+	}
+
+	if (!isEndReached)
+		return false;
+
+	//Walk back from the end node
+	m_vNodePath.clear();
+	for (int nodeIdx = endNodeIdx; nodeIdx != invalid_node_index; nodeIdx = m_vNodeRecords[nodeIdx].previousNodeIdx)
+		m_vNodePath.push_back(nodeIdx);
+	std::reverse(m_vNodePath.begin(), m_vNodePath.end());
+	return true;
+}
+
+void Elite::NavMeshQuery::VisitNode(int nodeIdx, int previousNodeIdx, float costSoFar, const Vector2& position, const Vector2& endPos)
+{
+	//Keep the existing record when it is at least as cheap, closed nodes can be opened again (the heuristic can overestimate)
+	NodeRecord& record = m_vNodeRecords[nodeIdx];
+	if (record.queryId == m_QueryId && record.costSoFar <= costSoFar)
+		return;
+
+	record.queryId = m_QueryId;
+	record.costSoFar = costSoFar;
+	record.previousNodeIdx = previousNodeIdx;
+	record.isClosed = false;
+
+	const Vector2 toDestination = endPos - position;
+	m_vOpenList.push_back(OpenRecord{ nodeIdx, costSoFar, costSoFar + m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y)) });
+	std::push_heap(m_vOpenList.begin(), m_vOpenList.end());
+}
+
+Elite::Vector2 Elite::NavMeshQuery::GetNodePosition(int nodeIdx, const Vector2& startPos, const Vector2& endPos) const
+{
+	const int amountNodes = m_pNavGraph->GetNrOfNodes();
+	if (nodeIdx == amountNodes)
+		return startPos;
+	if (nodeIdx == amountNodes + 1)
+		return endPos;
+	return m_pNavGraph->GetNode(nodeIdx)->GetPosition();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include "framework/EliteMath/EMath.h"
+#include "framework/EliteAI/EliteGraphs/ENavGraph.h"
+#include "framework/EliteAI/EliteNavigation/ENavigation.h"
+#include "framework/EliteAI/EliteNavigation/Algorithms/EPathSmoothing.h"
+
+namespace Elite
+{
+	//Reusable path query on a navigation graph. The search runs on the graph itself, the start and end position are virtual nodes
+	//connected to the lines of their triangle. Everything a query needs lives in buffers owned by the query, so once these have grown
+	//big enough (after the first queries) a query allocates nothing. Use one query per thread.
+	class NavMeshQuery final
+	{
+	public:
+		explicit NavMeshQuery(NavGraph const* pNavGraph, Heuristic hFunction = HeuristicFunctions::Manhattan);
+
+		//Writes the smoothed path (the start position excluded) into path, returns the amount of points of the path (0 when there is none).
+		//Only the first path.size() points are written when the path is longer, query again with a bigger span in that case.
+		int FindPath(const Vector2& startPos, const Vector2& endPos, Span<Vector2> path);
+		//Same, the vector is resized to the path (only allocates when it has to grow). Returns false when there is no path.
+		bool FindPath(const Vector2& startPos, const Vector2& endPos, std::vector<Vector2>& path);
+
+		//Opt-in debug output, every query fills these while they are set (nullptr to stop)
+		void SetDebugOutput(std::vector<Vector2>* pNodePositions, std::vector<Portal>* pPortals);
+		void SetNavGraph(NavGraph const* pNavGraph) { m_pNavGraph = pNavGraph; }
+
+	private:
+		//Search state of a node, only valid when queryId is the id of the running query (no clearing between queries)
+		struct NodeRecord final
+		{
+			float costSoFar = 0.f;
+			int previousNodeIdx = invalid_node_index;
+			unsigned int queryId = 0;
+			bool isClosed = false;
+		};
+		//Entry of the open list (binary heap), outdated once the node got a cheaper record
+		struct OpenRecord final
+		{
+			int nodeIdx = invalid_node_index;
+			float costSoFar = 0.f;
+			float estimatedTotalCost = 0.f;
+
+			//Reversed, so the std heap functions put the cheapest record on top
+			bool operator<(const OpenRecord& other) const { return estimatedTotalCost > other.estimatedTotalCost; }
+		};
+
+		//--- Datamembers ---
+		NavGraph const* m_pNavGraph = nullptr;
+		Heuristic m_HeuristicFunction = nullptr;
+		unsigned int m_QueryId = 0;
+
+		//Scratch buffers, reused by every query
+		std::vector<NodeRecord> m_vNodeRecords; //Graph nodes, followed by the start and end node
+		std::vector<OpenRecord> m_vOpenList;
+		std::vector<int> m_vNodePath;
+		std::vector<Portal> m_vPortals;
+		std::vector<Vector2> m_vPath;
+
+		std::vector<Vector2>* m_pDebugNodePositions = nullptr;
+		std::vector<Portal>* m_pDebugPortals = nullptr;
+
+		bool FindSmoothPath(const Vector2& startPos, const Vector2& endPos);
+		bool FindNodePath(const Vector2& startPos, const Vector2& endPos, const std::array<int, 3>& startNodes, const std::array<int, 3>& endNodes);
+		void VisitNode(int nodeIdx, int previousNodeIdx, float costSoFar, const Vector2& position, const Vector2& endPos);
+		Vector2 GetNodePosition(int nodeIdx, const Vector2& startPos, const Vector2& endPos) const;
+	};
+}
@@ -3,6 +3,7 @@
 #include <vector>
 #include "framework/EliteGeometry/EGeometry2DTypes.h"
 #include "framework/EliteAI/EliteGraphs/EGraphNodeTypes.h"
+#include "framework/EliteAI/EliteGraphs/ENavGraph.h"
 
 namespace Elite
 {
@@ -27,35 +28,37 @@ namespace Elite
 		static std::vector<Portal> FindPortals(
 			const std::vector<NavGraphNode*>& nodePath,
 			Polygon const* navMeshPolygon)
+		{
+			return FindPortals(nodePath, [navMeshPolygon](int lineIdx) { return navMeshPolygon->GetLines()[lineIdx]; });
+		}
+
+		//Line indices of tiled navigation graphs are not indices in a single polygon, the graph looks them up
+		static std::vector<Portal> FindPortals(
+			const std::vector<NavGraphNode*>& nodePath,
+			NavGraph const* pNavGraph)
+		{
+			return FindPortals(nodePath, [pNavGraph](int lineIdx) { return pNavGraph->GetLine(lineIdx); });
+		}
+
+		static std::vector<Portal> FindPortals(
+			const std::vector<NavGraphNode*>& nodePath,
+			const std::function<Line const* (int)>& getLine)
 		{
 			//Container
 			std::vector<Portal> vPortals = {};
 
 			vPortals.emplace_back(Line(nodePath[0]->GetPosition(), nodePath[0]->GetPosition()));
 
-			std::vector<Line*> lines = navMeshPolygon->GetLines();
-
 			//For each node received, get its corresponding line
 			for (size_t nodeIdx = 1; nodeIdx < nodePath.size() - 1; ++nodeIdx)
 			{
 				//Local variables
 				NavGraphNode const* pNode = nodePath[nodeIdx]; //Store node, except last node, because this is our target node!
-				Line const* pLine = lines[pNode->GetLineIndex()];
-
-				//Redetermine it's "orientation" based on the required path (left-right vs right-left) - p1 should be right point
-				Vector2 centerLine = (pLine->p1 + pLine->p2) / 2.0f;
+				Line const* pLine = getLine(pNode->GetLineIndex());
 				Vector2 previousPosition = nodeIdx == 0 ? nodePath[0]->GetPosition() : nodePath[nodeIdx - 1]->GetPosition();
 
-				float cross = Cross((centerLine - previousPosition), (pLine->p1 - previousPosition));
-
-				Line portalLine = {};
-				if (cross > 0)//Left
-					portalLine = Line(pLine->p2, pLine->p1);
-				else //Right
-					portalLine = Line(pLine->p1, pLine->p2);
-
 				//Store portal
-				vPortals.emplace_back(portalLine);
+				vPortals.emplace_back(CreatePortal(*pLine, previousPosition));
 			}
 			//Add degenerate portal to force end evaluation
 			vPortals.emplace_back(Line(nodePath[nodePath.size() - 1]->GetPosition(), nodePath[nodePath.size() - 1]->GetPosition()));
@@ -63,10 +66,30 @@ namespace Elite
 			return vPortals;
 		}
 
+		//Portal over the line, coming from previousPosition
+		static Portal CreatePortal(const Line& line, const Vector2& previousPosition)
+		{
+			//Redetermine it's "orientation" based on the required path (left-right vs right-left) - p1 should be right point
+			Vector2 centerLine = (line.p1 + line.p2) / 2.0f;
+			float cross = Cross((centerLine - previousPosition), (line.p1 - previousPosition));
+
+			if (cross > 0)//Left
+				return Portal(Line(line.p2, line.p1));
+			return Portal(Line(line.p1, line.p2)); //Right
+		}
+
 		static std::vector<Vector2> OptimizePortals(const std::vector<Portal>& portals)
 		{
-			//P1 == right point of portal, P2 == left point of portal
 			std::vector<Vector2> vPath{};
+			OptimizePortals(portals, vPath);
+			return vPath;
+		}
+
+		//Writes the path into vPath (cleared first), reusing its memory
+		static void OptimizePortals(const std::vector<Portal>& portals, std::vector<Vector2>& vPath)
+		{
+			//P1 == right point of portal, P2 == left point of portal
+			vPath.clear();
 			const unsigned int amtPortals{ portals.size() };
 
 			int apexIdx{ 0 };
@@ -145,8 +168,6 @@ namespace Elite
 
 			// Add last path point (You can use the last portal p1 or p2 points as both are equal to the endPoint of the path
 			vPath.push_back(portals[amtPortals - 1].Line.p2);
-
-			return vPath;
 		}
 	private:
 		SSFA() = default;
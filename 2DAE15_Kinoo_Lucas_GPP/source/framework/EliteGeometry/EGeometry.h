@@ -9,6 +9,9 @@
 
 /* --- UTILITIES --- */
 #include "EGeometry2DUtilities.h"
+#include "EGeometry2DBatchUtilities.h"
 /* --- TYPES --- */
 #include "EGeometry2DTypes.h"
+/* --- OPERATIONS --- */
+#include "EGeometry2DOperations.h"
 #endif
@@ -0,0 +1,314 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// EGeometry2DBatchUtilities.cpp: Implementation of the batched 2D Geometry Utilities.
+/*=============================================================================*/
+#include "stdafx.h"
+#include "EGeometry2DBatchUtilities.h"
+#include "EGeometry2DUtilities.h"
+#include "ESimd.h"
+
+namespace
+{
+	//Every lane does exactly the same operations, in the same order, as the scalar functions so the results are identical
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	using Elite::Simd;
+	using Float = Simd::Float;
+	const int AllLanes = (1 << Simd::Width) - 1;
+
+	//A point and a triangle per lane, either of them can be the same in every lane
+	struct Lanes final
+	{
+		Float pointX, pointY;
+		Float tipX, tipY;
+		Float prevX, prevY;
+		Float nextX, nextY;
+	};
+
+	//DistanceSquarePointToLine
+	Float DistanceSquarePointToLine(Float p1X, Float p1Y, Float p2X, Float p2Y, Float pointX, Float pointY)
+	{
+		const Float lineX = Simd::Sub(p2X, p1X);
+		const Float lineY = Simd::Sub(p2Y, p1Y);
+		const Float p1p2_squareDistance = Simd::Add(Simd::Mul(lineX, lineX), Simd::Mul(lineY, lineY));
+		const Float toPointX = Simd::Sub(pointX, p1X);
+		const Float toPointY = Simd::Sub(pointY, p1Y);
+		const Float dp = Simd::Div(Simd::Add(Simd::Mul(toPointX, lineX), Simd::Mul(toPointY, lineY)), p1p2_squareDistance);
+
+		const Float p1_squareDistance = Simd::Add(Simd::Mul(toPointX, toPointX), Simd::Mul(toPointY, toPointY));
+		const Float onLine_squareDistance = Simd::Sub(p1_squareDistance, Simd::Mul(Simd::Mul(dp, dp), p1p2_squareDistance));
+		const Float toEndX = Simd::Sub(pointX, p2X);
+		const Float toEndY = Simd::Sub(pointY, p2Y);
+		const Float p2_squareDistance = Simd::Add(Simd::Mul(toEndX, toEndX), Simd::Mul(toEndY, toEndY));
+
+		//dp < 0 -> p1, dp <= 1 -> on the line, else (also NaN) p2
+		return Simd::Select(Simd::Less(dp, Simd::Set(0.f)), p1_squareDistance,
+			Simd::Select(Simd::LessEqual(dp, Simd::Set(1.f)), onLine_squareDistance, p2_squareDistance));
+	}
+
+	//PointInTriangleBoundingBox, returns the bits of the lanes that are outside
+	int OutsideTriangleBoundingBox(const Lanes& l)
+	{
+		const Float epsilon = Simd::Set(FLT_EPSILON);
+		const Float xMin = Simd::Sub(Simd::Min(l.tipX, Simd::Min(l.prevX, l.nextX)), epsilon);
+		const Float xMax = Simd::Add(Simd::Max(l.tipX, Simd::Max(l.prevX, l.nextX)), epsilon);
+		const Float yMin = Simd::Sub(Simd::Min(l.tipY, Simd::Min(l.prevY, l.nextY)), epsilon);
+		const Float yMax = Simd::Add(Simd::Max(l.tipY, Simd::Max(l.prevY, l.nextY)), epsilon);
+		return Simd::Bits(Simd::Or(Simd::Or(Simd::Less(l.pointX, xMin), Simd::Less(xMax, l.pointX)),
+			Simd::Or(Simd::Less(l.pointY, yMin), Simd::Less(yMax, l.pointY))));
+	}
+
+	//PointInTriangle, returns the bits of the lanes that are inside
+	int InsideTriangle(const Lanes& l, bool onLineAllowed)
+	{
+		const int candidates = ~OutsideTriangleBoundingBox(l) & AllLanes;
+		if (candidates == 0)
+			return 0;
+
+		//Barycentric coordinates
+		const Float v0X = Simd::Sub(l.prevX, l.tipX), v0Y = Simd::Sub(l.prevY, l.tipY);
+		const Float v1X = Simd::Sub(l.nextX, l.tipX), v1Y = Simd::Sub(l.nextY, l.tipY);
+		const Float v2X = Simd::Sub(l.pointX, l.tipX), v2Y = Simd::Sub(l.pointY, l.tipY);
+
+		const Float dot00 = Simd::Add(Simd::Mul(v0X, v0X), Simd::Mul(v0Y, v0Y));
+		const Float dot01 = Simd::Add(Simd::Mul(v0X, v1X), Simd::Mul(v0Y, v1Y));
+		const Float dot02 = Simd::Add(Simd::Mul(v0X, v2X), Simd::Mul(v0Y, v2Y));
+		const Float dot11 = Simd::Add(Simd::Mul(v1X, v1X), Simd::Mul(v1Y, v1Y));
+		const Float dot12 = Simd::Add(Simd::Mul(v1X, v2X), Simd::Mul(v1Y, v2Y));
+
+		const Float invDenom = Simd::Div(Simd::Set(1.f), Simd::Sub(Simd::Mul(dot00, dot11), Simd::Mul(dot01, dot01)));
+		const Float u = Simd::Mul(Simd::Sub(Simd::Mul(dot11, dot02), Simd::Mul(dot01, dot12)), invDenom);
+		const Float v = Simd::Mul(Simd::Sub(Simd::Mul(dot00, dot12), Simd::Mul(dot01, dot02)), invDenom);
+
+		const Float zero = Simd::Set(0.f);
+		const Float one = Simd::Set(1.f);
+		const int outside = Simd::Bits(Simd::Or(Simd::Or(Simd::Or(Simd::Less(u, zero), Simd::Less(v, zero)), Simd::Or(Simd::Less(one, u), Simd::Less(one, v))),
+			Simd::Less(one, Simd::Add(u, v))));
+
+		int inside = candidates & ~outside;
+		if (onLineAllowed && (candidates & outside) != 0)
+		{
+			//Special case where the barycentric coordinates are not enough for on line detection
+			const Float epsilon = Simd::Set(FLT_EPSILON);
+			const Float onLine = Simd::Or(Simd::Or(
+				Simd::LessEqual(DistanceSquarePointToLine(l.tipX, l.tipY, l.nextX, l.nextY, l.pointX, l.pointY), epsilon),
+				Simd::LessEqual(DistanceSquarePointToLine(l.nextX, l.nextY, l.prevX, l.prevY, l.pointX, l.pointY), epsilon)),
+				Simd::LessEqual(DistanceSquarePointToLine(l.prevX, l.prevY, l.tipX, l.tipY, l.pointX, l.pointY), epsilon));
+			inside |= candidates & outside & Simd::Bits(onLine);
+		}
+		return inside;
+	}
+
+	//Lanes for points [i, i + Width) against one triangle
+	void SetPoints(Lanes& l, const float* pointsX, const float* pointsY, int i)
+	{
+		l.pointX = Simd::Load(pointsX + i);
+		l.pointY = Simd::Load(pointsY + i);
+	}
+	void SetTriangle(Lanes& l, const Elite::Vector2& tip, const Elite::Vector2& prev, const Elite::Vector2& next)
+	{
+		l.tipX = Simd::Set(tip.x); l.tipY = Simd::Set(tip.y);
+		l.prevX = Simd::Set(prev.x); l.prevY = Simd::Set(prev.y);
+		l.nextX = Simd::Set(next.x); l.nextY = Simd::Set(next.y);
+	}
+
+	//Lanes for one point against triangles [i, i + Width)
+	void SetPoint(Lanes& l, const Elite::Vector2& point)
+	{
+		l.pointX = Simd::Set(point.x);
+		l.pointY = Simd::Set(point.y);
+	}
+	void SetTriangles(Lanes& l, const Elite::TriangleBatch& triangles, int i)
+	{
+		l.tipX = Simd::Load(&triangles.tipX[i]); l.tipY = Simd::Load(&triangles.tipY[i]);
+		l.prevX = Simd::Load(&triangles.prevX[i]); l.prevY = Simd::Load(&triangles.prevY[i]);
+		l.nextX = Simd::Load(&triangles.nextX[i]); l.nextY = Simd::Load(&triangles.nextY[i]);
+	}
+
+	void StoreBits(int bits, bool* pResults)
+	{
+		for (int lane = 0; lane < Simd::Width; ++lane)
+			pResults[lane] = (bits & (1 << lane)) != 0;
+	}
+
+	int FirstBit(int bits)
+	{
+		int lane = 0;
+		while ((bits & (1 << lane)) == 0)
+			++lane;
+		return lane;
+	}
+	const int BatchWidth = Simd::Width;
+#else
+	const int BatchWidth = 0; //No SIMD, only the scalar loops
+#endif
+
+	//The points/triangles that do not fill a whole batch anymore use the scalar functions
+	int GetBatchedCount(int count)
+	{
+		return (BatchWidth == 0) ? 0 : count - count % max(BatchWidth, 1);
+	}
+}
+
+#pragma region TriangleBatch
+void Elite::TriangleBatch::Clear()
+{
+	tipX.clear(); tipY.clear();
+	prevX.clear(); prevY.clear();
+	nextX.clear(); nextY.clear();
+}
+
+void Elite::TriangleBatch::Reserve(size_t amount)
+{
+	tipX.reserve(amount); tipY.reserve(amount);
+	prevX.reserve(amount); prevY.reserve(amount);
+	nextX.reserve(amount); nextY.reserve(amount);
+}
+
+void Elite::TriangleBatch::Add(const Vector2& tip, const Vector2& prev, const Vector2& next)
+{
+	tipX.push_back(tip.x); tipY.push_back(tip.y);
+	prevX.push_back(prev.x); prevY.push_back(prev.y);
+	nextX.push_back(next.x); nextY.push_back(next.y);
+}
+
+void Elite::TriangleBatch::Replace(int first, int count, const TriangleBatch& triangles)
+{
+	const auto replace = [first, count](std::vector<float>& values, const std::vector<float>& newValues)
+	{
+		values.erase(values.begin() + first, values.begin() + first + count);
+		values.insert(values.begin() + first, newValues.begin(), newValues.end());
+	};
+	replace(tipX, triangles.tipX); replace(tipY, triangles.tipY);
+	replace(prevX, triangles.prevX); replace(prevY, triangles.prevY);
+	replace(nextX, triangles.nextX); replace(nextY, triangles.nextY);
+}
+
+void Elite::TriangleBatch::Rotate(int first, int middle, int last)
+{
+	const auto rotate = [first, middle, last](std::vector<float>& values)
+	{
+		std::rotate(values.begin() + first, values.begin() + middle, values.begin() + last);
+	};
+	rotate(tipX); rotate(tipY);
+	rotate(prevX); rotate(prevY);
+	rotate(nextX); rotate(nextY);
+}
+#pragma endregion //TriangleBatch
+
+#pragma region Functions
+void Elite::PointsInTriangleBoundingBox(const float* pointsX, const float* pointsY, int count,
+	const Vector2& tip, const Vector2& prev, const Vector2& next, bool* pResults)
+{
+	const int batchedCount = GetBatchedCount(count);
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	Lanes lanes;
+	SetTriangle(lanes, tip, prev, next);
+	for (int i = 0; i < batchedCount; i += Simd::Width)
+	{
+		SetPoints(lanes, pointsX, pointsY, i);
+		StoreBits(~OutsideTriangleBoundingBox(lanes), pResults + i);
+	}
+#endif
+	for (int i = batchedCount; i < count; ++i)
+		pResults[i] = PointInTriangleBoundingBox(Vector2(pointsX[i], pointsY[i]), tip, prev, next);
+}
+
+void Elite::PointsInTriangle(const float* pointsX, const float* pointsY, int count,
+	const Vector2& tip, const Vector2& prev, const Vector2& next, bool* pResults, bool onLineAllowed /*= false*/)
+{
+	const int batchedCount = GetBatchedCount(count);
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	Lanes lanes;
+	SetTriangle(lanes, tip, prev, next);
+	for (int i = 0; i < batchedCount; i += Simd::Width)
+	{
+		SetPoints(lanes, pointsX, pointsY, i);
+		StoreBits(InsideTriangle(lanes, onLineAllowed), pResults + i);
+	}
+#endif
+	for (int i = batchedCount; i < count; ++i)
+		pResults[i] = PointInTriangle(Vector2(pointsX[i], pointsY[i]), tip, prev, next, onLineAllowed);
+}
+
+int Elite::FindPointInTriangle(const float* pointsX, const float* pointsY, int count,
+	const Vector2& tip, const Vector2& prev, const Vector2& next, bool onLineAllowed /*= false*/)
+{
+	const int batchedCount = GetBatchedCount(count);
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	Lanes lanes;
+	SetTriangle(lanes, tip, prev, next);
+	for (int i = 0; i < batchedCount; i += Simd::Width)
+	{
+		SetPoints(lanes, pointsX, pointsY, i);
+		const int inside = InsideTriangle(lanes, onLineAllowed);
+		if (inside != 0)
+			return i + FirstBit(inside);
+	}
+#endif
+	for (int i = batchedCount; i < count; ++i)
+	{
+		if (PointInTriangle(Vector2(pointsX[i], pointsY[i]), tip, prev, next, onLineAllowed))
+			return i;
+	}
+	return -1;
+}
+
+void Elite::DistancesSquarePointsToLine(const Vector2& p1, const Vector2& p2, const float* pointsX, const float* pointsY, int count, float* pDistances)
+{
+	const int batchedCount = GetBatchedCount(count);
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	const Float p1X = Simd::Set(p1.x), p1Y = Simd::Set(p1.y);
+	const Float p2X = Simd::Set(p2.x), p2Y = Simd::Set(p2.y);
+	for (int i = 0; i < batchedCount; i += Simd::Width)
+		Simd::Store(pDistances + i, ::DistanceSquarePointToLine(p1X, p1Y, p2X, p2Y, Simd::Load(pointsX + i), Simd::Load(pointsY + i)));
+#endif
+	for (int i = batchedCount; i < count; ++i)
+		pDistances[i] = DistanceSquarePointToLine(p1, p2, Vector2(pointsX[i], pointsY[i]));
+}
+
+void Elite::PointInTriangles(const Vector2& point, const TriangleBatch& triangles, int first, int count, bool* pResults, bool onLineAllowed /*= false*/)
+{
+	const int batchedCount = GetBatchedCount(count);
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	Lanes lanes;
+	SetPoint(lanes, point);
+	for (int i = 0; i < batchedCount; i += Simd::Width)
+	{
+		SetTriangles(lanes, triangles, first + i);
+		StoreBits(InsideTriangle(lanes, onLineAllowed), pResults + i);
+	}
+#endif
+	for (int i = batchedCount; i < count; ++i)
+	{
+		const int t = first + i;
+		pResults[i] = PointInTriangle(point, Vector2(triangles.tipX[t], triangles.tipY[t]), Vector2(triangles.prevX[t], triangles.prevY[t]),
+			Vector2(triangles.nextX[t], triangles.nextY[t]), onLineAllowed);
+	}
+}
+
+int Elite::FindTriangleContainingPoint(const Vector2& point, const TriangleBatch& triangles, int first, int count, bool onLineAllowed /*= false*/)
+{
+	const int batchedCount = GetBatchedCount(count);
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	Lanes lanes;
+	SetPoint(lanes, point);
+	for (int i = 0; i < batchedCount; i += Simd::Width)
+	{
+		SetTriangles(lanes, triangles, first + i);
+		const int inside = InsideTriangle(lanes, onLineAllowed);
+		if (inside != 0)
+			return first + i + FirstBit(inside);
+	}
+#endif
+	for (int i = batchedCount; i < count; ++i)
+	{
+		const int t = first + i;
+		if (PointInTriangle(point, Vector2(triangles.tipX[t], triangles.tipY[t]), Vector2(triangles.prevX[t], triangles.prevY[t]),
+			Vector2(triangles.nextX[t], triangles.nextY[t]), onLineAllowed))
+			return t;
+	}
+	return -1;
+}
+#pragma endregion //Functions
@@ -0,0 +1,56 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// EGeometry2DBatchUtilities.h: Batched (SIMD) versions of the 2D Geometry Utilities.
+/*=============================================================================*/
+#ifndef ELITE_GEOMETRY_2D_BATCH_UTILITIES
+#define ELITE_GEOMETRY_2D_BATCH_UTILITIES
+
+//SSE2 is always available on x64 and the default for x86 (/arch:SSE2), AVX2 only when compiling with /arch:AVX2.
+//Without either the batched functions loop over the scalar ones. Every path returns exactly the same results as the scalar
+//functions, as long as the compiler does not contract the scalar math into fused multiply-adds (/fp:precise, -ffp-contract=off).
+#if defined(__AVX2__)
+#define ELITE_SIMD_AVX2
+#endif
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ELITE_SIMD_SSE2
+#endif
+
+namespace Elite
+{
+	/* --- TYPES --- */
+	/*! Triangles stored as structure of arrays, so one point can be tested against multiple triangles at once. */
+	struct TriangleBatch final
+	{
+		std::vector<float> tipX, tipY;
+		std::vector<float> prevX, prevY;
+		std::vector<float> nextX, nextY;
+
+		void Clear();
+		void Reserve(size_t amount);
+		void Add(const Vector2& tip, const Vector2& prev, const Vector2& next);
+		void Replace(int first, int count, const TriangleBatch& triangles); //The triangles [first, first + count) by all the given ones
+		void Rotate(int first, int middle, int last); //Like std::rotate, triangle middle becomes triangle first
+		int Size() const { return static_cast<int>(tipX.size()); }
+	};
+
+	/* --- FUNCTIONS --- */
+	/*! Multiple points against one triangle, pResults[i] = PointInTriangleBoundingBox(point i, tip, prev, next). */
+	void PointsInTriangleBoundingBox(const float* pointsX, const float* pointsY, int count,
+		const Vector2& tip, const Vector2& prev, const Vector2& next, bool* pResults);
+	/*! Multiple points against one triangle, pResults[i] = PointInTriangle(point i, tip, prev, next, onLineAllowed). */
+	void PointsInTriangle(const float* pointsX, const float* pointsY, int count,
+		const Vector2& tip, const Vector2& prev, const Vector2& next, bool* pResults, bool onLineAllowed = false);
+	/*! Index of the first point inside the triangle (same test as PointInTriangle), -1 if none. Stops at the first block with a hit. */
+	int FindPointInTriangle(const float* pointsX, const float* pointsY, int count,
+		const Vector2& tip, const Vector2& prev, const Vector2& next, bool onLineAllowed = false);
+	/*! Multiple points against one line, pDistances[i] = DistanceSquarePointToLine(p1, p2, point i). */
+	void DistancesSquarePointsToLine(const Vector2& p1, const Vector2& p2, const float* pointsX, const float* pointsY, int count, float* pDistances);
+
+	/*! One point against the triangles [first, first + count) of the batch, pResults[i] = PointInTriangle(point, triangle first + i, onLineAllowed). */
+	void PointInTriangles(const Vector2& point, const TriangleBatch& triangles, int first, int count, bool* pResults, bool onLineAllowed = false);
+	/*! Index (in the batch) of the first triangle in [first, first + count) containing the point, -1 if none. */
+	int FindTriangleContainingPoint(const Vector2& point, const TriangleBatch& triangles, int first, int count, bool onLineAllowed = false);
+}
+#endif
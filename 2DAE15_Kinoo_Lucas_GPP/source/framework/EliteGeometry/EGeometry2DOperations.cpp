@@ -0,0 +1,413 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// EGeometry2DOperations.cpp: Implementation of the operations on multiple 2D polygons.
+/*=============================================================================*/
+#include "stdafx.h"
+#include "EGeometry2DOperations.h"
+#include <numeric>
+#include <cfloat>
+#include <unordered_set>
+
+namespace
+{
+	//Points snapped to a grid, so equal points are exactly equal and orientation tests are exact
+	const double GridResolution = 1024.0;
+
+	struct GridPoint final
+	{
+		long long x = 0;
+		long long y = 0;
+
+		bool operator==(const GridPoint& p) const { return x == p.x && y == p.y; }
+		bool operator!=(const GridPoint& p) const { return !(*this == p); }
+		long long GetKey() const { return static_cast<long long>((static_cast<unsigned long long>(x) << 32) ^ (static_cast<unsigned long long>(y) & 0xFFFFFFFF)); }
+	};
+
+	struct Edge final
+	{
+		GridPoint a;
+		GridPoint b;
+		int ring = -1;
+		std::vector<GridPoint> splits; //Points where other edges cross or touch this edge
+	};
+
+	GridPoint Snap(double x, double y)
+	{
+		return { llround(x * GridResolution), llround(y * GridResolution) };
+	}
+
+	//Sign of the cross product (b - a) x (c - a), exact
+	int Orientation(const GridPoint& a, const GridPoint& b, const GridPoint& c)
+	{
+		const long long cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		return (cross > 0) ? 1 : ((cross < 0) ? -1 : 0);
+	}
+
+	//Point on the segment (already known to be on its line), excluding the end points
+	bool IsStrictlyInside(const Edge& edge, const GridPoint& p)
+	{
+		const double dotStart = static_cast<double>(p.x - edge.a.x) * (edge.b.x - edge.a.x) + static_cast<double>(p.y - edge.a.y) * (edge.b.y - edge.a.y);
+		const double dotEnd = static_cast<double>(p.x - edge.b.x) * (edge.a.x - edge.b.x) + static_cast<double>(p.y - edge.b.y) * (edge.a.y - edge.b.y);
+		return dotStart > 0.0 && dotEnd > 0.0;
+	}
+
+	void AddSplit(Edge& edge, const GridPoint& p)
+	{
+		if (p != edge.a && p != edge.b)
+			edge.splits.push_back(p);
+	}
+
+	void IntersectEdges(Edge& e1, Edge& e2)
+	{
+		const int o1 = Orientation(e1.a, e1.b, e2.a);
+		const int o2 = Orientation(e1.a, e1.b, e2.b);
+		const int o3 = Orientation(e2.a, e2.b, e1.a);
+		const int o4 = Orientation(e2.a, e2.b, e1.b);
+
+		//Collinear, split both at the end points of the other that are inside
+		if (o1 == 0 && o2 == 0)
+		{
+			if (IsStrictlyInside(e1, e2.a)) AddSplit(e1, e2.a);
+			if (IsStrictlyInside(e1, e2.b)) AddSplit(e1, e2.b);
+			if (IsStrictlyInside(e2, e1.a)) AddSplit(e2, e1.a);
+			if (IsStrictlyInside(e2, e1.b)) AddSplit(e2, e1.b);
+			return;
+		}
+
+		if (o1 * o2 > 0 || o3 * o4 > 0)
+			return;
+
+		//Touching, an end point on the other edge
+		if (o1 == 0) AddSplit(e1, e2.a);
+		if (o2 == 0) AddSplit(e1, e2.b);
+		if (o3 == 0) AddSplit(e2, e1.a);
+		if (o4 == 0) AddSplit(e2, e1.b);
+		if (o1 == 0 || o2 == 0 || o3 == 0 || o4 == 0)
+			return;
+
+		//Crossing, both get the same (snapped) point
+		const double d1x = static_cast<double>(e1.b.x - e1.a.x), d1y = static_cast<double>(e1.b.y - e1.a.y);
+		const double d2x = static_cast<double>(e2.b.x - e2.a.x), d2y = static_cast<double>(e2.b.y - e2.a.y);
+		const double t = (static_cast<double>(e2.a.x - e1.a.x) * d2y - static_cast<double>(e2.a.y - e1.a.y) * d2x) / (d1x * d2y - d1y * d2x);
+		const GridPoint p = Snap((e1.a.x + t * d1x) / GridResolution, (e1.a.y + t * d1y) / GridResolution);
+		AddSplit(e1, p);
+		AddSplit(e2, p);
+	}
+
+	//Even-odd point in ring test
+	bool IsPointInRing(const std::vector<GridPoint>& ring, double x, double y)
+	{
+		bool isInside = false;
+		for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+		{
+			const double xi = static_cast<double>(ring[i].x), yi = static_cast<double>(ring[i].y);
+			const double xj = static_cast<double>(ring[j].x), yj = static_cast<double>(ring[j].y);
+			if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+				isInside = !isInside;
+		}
+		return isInside;
+	}
+
+	//Union of rings (counter clockwise, overlapping bounds), returns the outer loops
+	std::vector<std::vector<Elite::Vector2>> UnionRings(const std::vector<std::vector<GridPoint>>& rings)
+	{
+		//1. Find where the edges cross or touch, sweeping over the edges sorted on their smallest x.
+		//Only edges that overlap in x (the active ones) can intersect.
+		std::vector<Edge> edges;
+		for (int ringIdx = 0; ringIdx < static_cast<int>(rings.size()); ++ringIdx)
+		{
+			const auto& ring = rings[ringIdx];
+			for (size_t i = 0; i < ring.size(); ++i)
+			{
+				Edge edge{};
+				edge.a = ring[i];
+				edge.b = ring[(i + 1) % ring.size()];
+				edge.ring = ringIdx;
+				edges.push_back(edge);
+			}
+		}
+
+		std::vector<int> sortedEdges(edges.size());
+		std::iota(sortedEdges.begin(), sortedEdges.end(), 0);
+		std::sort(sortedEdges.begin(), sortedEdges.end(), [&edges](int e1, int e2) { return min(edges[e1].a.x, edges[e1].b.x) < min(edges[e2].a.x, edges[e2].b.x); });
+
+		std::vector<int> activeEdges;
+		for (const int edgeIdx : sortedEdges)
+		{
+			auto& edge = edges[edgeIdx];
+			const long long minX = min(edge.a.x, edge.b.x);
+			const long long minY = min(edge.a.y, edge.b.y);
+			const long long maxY = max(edge.a.y, edge.b.y);
+
+			activeEdges.erase(std::remove_if(activeEdges.begin(), activeEdges.end(),
+				[&edges, minX](int activeIdx) { return max(edges[activeIdx].a.x, edges[activeIdx].b.x) < minX; }), activeEdges.end());
+
+			for (const int activeIdx : activeEdges)
+			{
+				auto& other = edges[activeIdx];
+				if (min(other.a.y, other.b.y) <= maxY && max(other.a.y, other.b.y) >= minY)
+					IntersectEdges(other, edge);
+			}
+			activeEdges.push_back(edgeIdx);
+		}
+
+		//2. Split the edges, the rings are now connected through the split points
+		std::vector<std::vector<GridPoint>> splitRings(rings.size());
+		for (auto& edge : edges)
+		{
+			const double dx = static_cast<double>(edge.b.x - edge.a.x);
+			const double dy = static_cast<double>(edge.b.y - edge.a.y);
+			std::sort(edge.splits.begin(), edge.splits.end(), [&edge, dx, dy](const GridPoint& p1, const GridPoint& p2)
+				{ return (p1.x - edge.a.x) * dx + (p1.y - edge.a.y) * dy < (p2.x - edge.a.x) * dx + (p2.y - edge.a.y) * dy; });
+			edge.splits.erase(std::unique(edge.splits.begin(), edge.splits.end()), edge.splits.end());
+
+			auto& splitRing = splitRings[edge.ring];
+			splitRing.push_back(edge.a);
+			splitRing.insert(splitRing.end(), edge.splits.begin(), edge.splits.end());
+		}
+
+		//Grid over the bounds of the rings to find the rings around a point
+		std::vector<std::pair<GridPoint, GridPoint>> bounds(rings.size());
+		GridPoint boundsMin = rings[0][0], boundsMax = rings[0][0];
+		double averageSize = 0.0;
+		for (size_t ringIdx = 0; ringIdx < rings.size(); ++ringIdx)
+		{
+			auto& ringBounds = bounds[ringIdx];
+			ringBounds = { rings[ringIdx][0], rings[ringIdx][0] };
+			for (const auto& p : splitRings[ringIdx])
+			{
+				ringBounds.first = { min(ringBounds.first.x, p.x), min(ringBounds.first.y, p.y) };
+				ringBounds.second = { max(ringBounds.second.x, p.x), max(ringBounds.second.y, p.y) };
+			}
+			boundsMin = { min(boundsMin.x, ringBounds.first.x), min(boundsMin.y, ringBounds.first.y) };
+			boundsMax = { max(boundsMax.x, ringBounds.second.x), max(boundsMax.y, ringBounds.second.y) };
+			averageSize += static_cast<double>(max(ringBounds.second.x - ringBounds.first.x, ringBounds.second.y - ringBounds.first.y)) / rings.size();
+		}
+		const double cellSize = max(averageSize, 1.0);
+		const int cols = min(static_cast<int>((boundsMax.x - boundsMin.x) / cellSize) + 1, 1024);
+		const int rows = min(static_cast<int>((boundsMax.y - boundsMin.y) / cellSize) + 1, 1024);
+		const double invCellWidth = cols / (static_cast<double>(boundsMax.x - boundsMin.x) + 1.0);
+		const double invCellHeight = rows / (static_cast<double>(boundsMax.y - boundsMin.y) + 1.0);
+		std::vector<std::vector<int>> cells(cols * rows);
+		for (int ringIdx = 0; ringIdx < static_cast<int>(rings.size()); ++ringIdx)
+		{
+			const int colMin = static_cast<int>((bounds[ringIdx].first.x - boundsMin.x) * invCellWidth);
+			const int colMax = static_cast<int>((bounds[ringIdx].second.x - boundsMin.x) * invCellWidth);
+			const int rowMin = static_cast<int>((bounds[ringIdx].first.y - boundsMin.y) * invCellHeight);
+			const int rowMax = static_cast<int>((bounds[ringIdx].second.y - boundsMin.y) * invCellHeight);
+			for (int row = rowMin; row <= rowMax; ++row)
+				for (int col = colMin; col <= colMax; ++col)
+					cells[row * cols + col].push_back(ringIdx);
+		}
+
+		//3. Keep the parts of the edges with the outside of the union on their right side. The test point is so close to the part
+		//that no other edge can pass between them: they would cross the part, and it would have been split there.
+		const double testOffset = 1e-7;
+		std::vector<std::pair<GridPoint, GridPoint>> borderEdges;
+		std::unordered_set<long long> usedEdgeKeys;
+		for (int ringIdx = 0; ringIdx < static_cast<int>(splitRings.size()); ++ringIdx)
+		{
+			const auto& splitRing = splitRings[ringIdx];
+			for (size_t i = 0; i < splitRing.size(); ++i)
+			{
+				const auto& p = splitRing[i];
+				const auto& q = splitRing[(i + 1) % splitRing.size()];
+				if (p == q)
+					continue;
+
+				const double dx = static_cast<double>(q.x - p.x), dy = static_cast<double>(q.y - p.y);
+				const double length = sqrt(dx * dx + dy * dy);
+				const double x = (p.x + q.x) * 0.5 + dy / length * testOffset;
+				const double y = (p.y + q.y) * 0.5 - dx / length * testOffset;
+
+				const int col = min(max(static_cast<int>((x - boundsMin.x) * invCellWidth), 0), cols - 1);
+				const int row = min(max(static_cast<int>((y - boundsMin.y) * invCellHeight), 0), rows - 1);
+				const auto& candidates = cells[row * cols + col];
+				const bool isCovered = std::any_of(candidates.begin(), candidates.end(), [&](int otherIdx)
+					{
+						return otherIdx != ringIdx
+							&& x >= bounds[otherIdx].first.x && x <= bounds[otherIdx].second.x && y >= bounds[otherIdx].first.y && y <= bounds[otherIdx].second.y
+							&& IsPointInRing(splitRings[otherIdx], x, y);
+					});
+				if (isCovered)
+					continue;
+
+				//The same part on the border of multiple rings (collinear edges) is only kept once
+				if (usedEdgeKeys.insert(p.GetKey() * 31 + q.GetKey()).second)
+					borderEdges.push_back({ p, q });
+			}
+		}
+
+		//4. Link the border edges into loops. Where multiple edges leave a point (shapes touching in a corner), take the one turning
+		//the most to the left, so every loop stays simple.
+		std::sort(borderEdges.begin(), borderEdges.end(), [](const std::pair<GridPoint, GridPoint>& e1, const std::pair<GridPoint, GridPoint>& e2)
+			{ return e1.first.GetKey() < e2.first.GetKey(); });
+		std::vector<bool> isEdgeUsed(borderEdges.size(), false);
+
+		std::vector<std::vector<Elite::Vector2>> loops;
+		for (size_t firstEdge = 0; firstEdge < borderEdges.size(); ++firstEdge)
+		{
+			if (isEdgeUsed[firstEdge])
+				continue;
+
+			std::vector<GridPoint> loop;
+			size_t currentEdge = firstEdge;
+			bool isClosed = false;
+			while (true)
+			{
+				isEdgeUsed[currentEdge] = true;
+				const auto& edge = borderEdges[currentEdge];
+				loop.push_back(edge.first);
+				if (edge.second == borderEdges[firstEdge].first)
+				{
+					isClosed = true;
+					break;
+				}
+
+				const auto range = std::equal_range(borderEdges.begin(), borderEdges.end(), std::make_pair(edge.second, edge.second),
+					[](const std::pair<GridPoint, GridPoint>& e1, const std::pair<GridPoint, GridPoint>& e2) { return e1.first.GetKey() < e2.first.GetKey(); });
+
+				const double inX = static_cast<double>(edge.second.x - edge.first.x), inY = static_cast<double>(edge.second.y - edge.first.y);
+				size_t nextEdge = borderEdges.size();
+				double bestAngle = -DBL_MAX;
+				for (auto it = range.first; it != range.second; ++it)
+				{
+					const size_t candidate = it - borderEdges.begin();
+					if (isEdgeUsed[candidate] || it->first != edge.second)
+						continue;
+
+					const double outX = static_cast<double>(it->second.x - it->first.x), outY = static_cast<double>(it->second.y - it->first.y);
+					const double angle = atan2(inX * outY - inY * outX, inX * outX + inY * outY);
+					if (angle > bestAngle)
+					{
+						bestAngle = angle;
+						nextEdge = candidate;
+					}
+				}
+				if (nextEdge == borderEdges.size())
+					break;
+				currentEdge = nextEdge;
+			}
+			if (!isClosed)
+				continue;
+
+			//Remove the points in the middle of straight edges (split points)
+			std::vector<Elite::Vector2> points;
+			double area = 0.0;
+			for (size_t i = 0; i < loop.size(); ++i)
+			{
+				const auto& previous = loop[(i + loop.size() - 1) % loop.size()];
+				const auto& next = loop[(i + 1) % loop.size()];
+				area += static_cast<double>(loop[i].x) * next.y - static_cast<double>(next.x) * loop[i].y;
+				if (Orientation(previous, loop[i], next) != 0)
+					points.push_back({ static_cast<float>(loop[i].x / GridResolution), static_cast<float>(loop[i].y / GridResolution) });
+			}
+
+			//Counter clockwise loops are outer shapes, clockwise loops are gaps inside the union
+			if (area > 0.0 && points.size() >= 3)
+				loops.push_back(std::move(points));
+		}
+		return loops;
+	}
+}
+
+std::vector<Elite::Polygon> Elite::UnionPolygons(const std::vector<Polygon>& polygons)
+{
+	//Counter clockwise copies of the shapes and their bounds
+	std::vector<std::vector<Vector2>> shapes;
+	std::vector<std::pair<Vector2, Vector2>> bounds;
+	for (const auto& polygon : polygons)
+	{
+		if (polygon.GetAmountVertices() < 3)
+			continue;
+
+		shapes.push_back(polygon.GetPoints());
+		if (GetPolygonWinding(shapes.back()) == CW)
+			std::reverse(shapes.back().begin(), shapes.back().end());
+
+		auto shapeBounds = std::make_pair(shapes.back()[0], shapes.back()[0]);
+		for (const auto& p : shapes.back())
+		{
+			shapeBounds.first = Vector2(min(shapeBounds.first.x, p.x), min(shapeBounds.first.y, p.y));
+			shapeBounds.second = Vector2(max(shapeBounds.second.x, p.x), max(shapeBounds.second.y, p.y));
+		}
+		bounds.push_back(shapeBounds);
+	}
+
+	//Group the shapes with overlapping bounds (sweep over the smallest x), only groups with multiple shapes have to be merged
+	std::vector<int> groups(shapes.size());
+	std::iota(groups.begin(), groups.end(), 0);
+	const auto findGroup = [&groups](int shapeIdx)
+	{
+		while (groups[shapeIdx] != shapeIdx)
+			shapeIdx = groups[shapeIdx] = groups[groups[shapeIdx]];
+		return shapeIdx;
+	};
+
+	std::vector<int> sortedShapes(shapes.size());
+	std::iota(sortedShapes.begin(), sortedShapes.end(), 0);
+	std::sort(sortedShapes.begin(), sortedShapes.end(), [&bounds](int s1, int s2) { return bounds[s1].first.x < bounds[s2].first.x; });
+
+	std::vector<int> activeShapes;
+	for (const int shapeIdx : sortedShapes)
+	{
+		const auto& shapeBounds = bounds[shapeIdx];
+		activeShapes.erase(std::remove_if(activeShapes.begin(), activeShapes.end(),
+			[&bounds, &shapeBounds](int activeIdx) { return bounds[activeIdx].second.x < shapeBounds.first.x; }), activeShapes.end());
+
+		for (const int activeIdx : activeShapes)
+		{
+			if (bounds[activeIdx].first.y <= shapeBounds.second.y && bounds[activeIdx].second.y >= shapeBounds.first.y)
+				groups[findGroup(activeIdx)] = findGroup(shapeIdx);
+		}
+		activeShapes.push_back(shapeIdx);
+	}
+
+	std::unordered_map<int, std::vector<int>> shapesPerGroup;
+	for (int shapeIdx = 0; shapeIdx < static_cast<int>(shapes.size()); ++shapeIdx)
+		shapesPerGroup[findGroup(shapeIdx)].push_back(shapeIdx);
+
+	//Merge every group on its own, in the order of the input
+	std::vector<Polygon> result;
+	for (int shapeIdx = 0; shapeIdx < static_cast<int>(shapes.size()); ++shapeIdx)
+	{
+		const auto& group = shapesPerGroup[findGroup(shapeIdx)];
+		if (group.front() != shapeIdx)
+			continue;
+
+		if (group.size() == 1)
+		{
+			result.push_back(Polygon(shapes[shapeIdx]));
+			continue;
+		}
+
+		std::vector<std::vector<GridPoint>> rings;
+		for (const int groupShapeIdx : group)
+		{
+			std::vector<GridPoint> ring;
+			for (const auto& p : shapes[groupShapeIdx])
+			{
+				const auto snapped = Snap(p.x, p.y);
+				if (ring.empty() || ring.back() != snapped)
+					ring.push_back(snapped);
+			}
+			while (ring.size() > 1 && ring.front() == ring.back())
+				ring.pop_back();
+
+			//Snapping can collapse tiny shapes
+			long long doubleArea = 0;
+			for (size_t i = 0; i < ring.size(); ++i)
+				doubleArea += ring[i].x * ring[(i + 1) % ring.size()].y - ring[(i + 1) % ring.size()].x * ring[i].y;
+			if (ring.size() >= 3 && doubleArea > 0)
+				rings.push_back(std::move(ring));
+		}
+
+		if (rings.empty())
+			continue;
+		for (const auto& loop : UnionRings(rings))
+			result.push_back(Polygon(loop));
+	}
+	return result;
+}
@@ -0,0 +1,19 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// EGeometry2DOperations.h: Operations on multiple 2D polygons (boolean operations).
+/*=============================================================================*/
+#ifndef ELITE_GEOMETRY_2D_OPERATIONS
+#define ELITE_GEOMETRY_2D_OPERATIONS
+
+#include "EGeometry2DTypes.h"
+
+namespace Elite
+{
+	/*! Union of polygons, returns the outer shapes (counter clockwise). Children of the polygons are ignored and gaps enclosed by the union are filled.
+	Polygons that do not overlap another one are returned unchanged, the others are snapped to a grid of 1/1024 units so shared and collinear
+	edges are handled exactly. Coordinates should stay within a million units. */
+	std::vector<Polygon> UnionPolygons(const std::vector<Polygon>& polygons);
+}
+#endif
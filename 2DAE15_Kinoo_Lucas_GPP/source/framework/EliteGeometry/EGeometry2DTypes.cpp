@@ -8,6 +8,8 @@
 //#include "EGeometry.h"
 #include "EGeometry2DTypes.h"
 #include "EGeometry2DUtilities.h"
+#include "EGeometry2DOperations.h"
+#include <cstring>
 
 #pragma region Polygon
 #pragma region Constructors
@@ -17,19 +19,19 @@ using namespace std;
 Elite::Polygon::Polygon(std::list<Vector2>& vertices)
 {
 	//Store vertices
-	m_vPoints = vertices;
+	m_vPoints.assign(vertices.begin(), vertices.end()); //Copy
 }
 
 Elite::Polygon::Polygon(const std::vector<Vector2>& vertices)
 {
-	//Store vertex vector into list
-	m_vPoints.assign(vertices.begin(), vertices.end()); //Copy
+	//Store vertices
+	m_vPoints = vertices;
 }
 
 Elite::Polygon::Polygon(const std::vector<Vector2>& outerShape, const std::vector<std::vector<Vector2>>& innerShapes)
 {
-	//Store outer shape points into list
-	m_vPoints.assign(outerShape.begin(), outerShape.end()); //Copy
+	//Store outer shape points
+	m_vPoints = outerShape;
 
 	//For each child, add child
 	for (const auto i : innerShapes)
@@ -41,8 +43,7 @@ Elite::Polygon::Polygon(const std::vector<Vector2>& outerShape, const std::vecto
 
 Elite::Polygon::Polygon(const Vector2* vertices, int count)
 {
-	for (auto i = 0; i < count; ++i)
-		m_vPoints.push_back(vertices[i]);
+	m_vPoints.assign(vertices, vertices + count);
 }
 
 Elite::Polygon::~Polygon()
@@ -64,12 +65,14 @@ Elite::Polygon* Elite::Polygon::AddChild(std::list<Vector2>& vertices)
 {
 	const Polygon p(vertices);
 	m_vChildren.push_back(p);
+	m_isCacheDirty = true;
 	return &m_vChildren[m_vChildren.size() - 1];
 };
 
 void Elite::Polygon::AddChild(const Polygon& p)
 {
 	m_vChildren.push_back(p);
+	m_isCacheDirty = true;
 }
 
 void Elite::Polygon::RemoveChild(const Polygon& p)
@@ -84,10 +87,8 @@ void Elite::Polygon::RemoveChild(const Polygon& p)
 #pragma region GeneralFunctions
 Elite::Vector2 Elite::Polygon::GetCenterPoint() const
 {
-	Vector2 cp;
-	for (const auto p : m_vPoints)
-		cp += p;
-	return cp / static_cast<float>(m_vPoints.size());
+	UpdateCachedData();
+	return m_CenterPoint;
 }
 #pragma endregion //GeneralFunctions
 //----------------------------------------------------------
@@ -97,12 +98,17 @@ bool Elite::Polygon::IsTriangulated() const
 	return m_isTriangulated;
 }
 
+bool Elite::Polygon::IsTriangulatedCompletely() const
+{
+	return m_isTriangulatedCompletely;
+}
+
 int Elite::Polygon::GetAmountVertices() const
 {
 	return m_vPoints.size();
 }
 
-const std::list<Elite::Vector2>& Elite::Polygon::GetPoints() const
+const std::vector<Elite::Vector2>& Elite::Polygon::GetPoints() const
 {
 	return m_vPoints;
 }
@@ -126,141 +132,144 @@ const std::vector<Elite::Line*>& Elite::Polygon::GetLines() const
 #pragma region GettersInformation
 float Elite::Polygon::GetPosVertMaxXPos() const
 {
-	//Go over all the verts of this polygon (not children) and get the position of the most right vertex
-	auto maxXPos = std::numeric_limits<float>::lowest();
-	for (const auto p : m_vPoints)
-		p.x > maxXPos ? maxXPos = p.x : 0;
-	return maxXPos;
+	//Position of the most right vertex of this polygon (not children)
+	UpdateCachedData();
+	return m_BoundsMax.x;
 }
 
 float Elite::Polygon::GetPosVertMaxYPos() const
 {
-	//Go over all the verts of this polygon (not children) and get the position of the most top vertex
-	auto maxYPos = std::numeric_limits<float>::lowest();
-	for (const auto p : m_vPoints)
-		p.y > maxYPos ? maxYPos = p.y : 0;
-	return maxYPos;
+	//Position of the most top vertex of this polygon (not children)
+	UpdateCachedData();
+	return m_BoundsMax.y;
 }
 
 float Elite::Polygon::GetPosVertMinXPos() const
 {
-	//Go over all the verts of this polygon (not children) and get the position of the most right vertex
-	auto minXPos = (std::numeric_limits<float>::max)();
-	for (const auto p : m_vPoints)
-		p.x < minXPos ? minXPos = p.x : 0;
-	return minXPos;
+	//Position of the most left vertex of this polygon (not children)
+	UpdateCachedData();
+	return m_BoundsMin.x;
 }
 
 float Elite::Polygon::GetPosVertMinYPos() const
 {
-	//Go over all the verts of this polygon (not children) and get the position of the most top vertex
-	auto minYPos = (std::numeric_limits<float>::max)();
-	for (const auto p : m_vPoints)
-		p.y < minYPos ? minYPos = p.y : 0;
-	return minYPos;
+	//Position of the most bottom vertex of this polygon (not children)
+	UpdateCachedData();
+	return m_BoundsMin.y;
 }
 
 bool Elite::Polygon::OverlappingXAxis(const Polygon& poly) const
 {
-	auto leftOverlap = this->GetPosVertMinXPos() < poly.GetPosVertMinXPos() && this->GetPosVertMaxXPos() > poly.GetPosVertMinXPos();
-	auto collinearOverlap = this->GetPosVertMinXPos() >= poly.GetPosVertMinXPos() && this->GetPosVertMaxXPos() <= poly.GetPosVertMaxXPos();
-	auto rightOverlap = this->GetPosVertMaxXPos() > poly.GetPosVertMaxXPos() && this->GetPosVertMinXPos() < poly.GetPosVertMaxXPos();
+	const auto minX = GetPosVertMinXPos();
+	const auto maxX = GetPosVertMaxXPos();
+	const auto polyMinX = poly.GetPosVertMinXPos();
+	const auto polyMaxX = poly.GetPosVertMaxXPos();
+
+	const auto leftOverlap = minX < polyMinX && maxX > polyMinX;
+	const auto collinearOverlap = minX >= polyMinX && maxX <= polyMaxX;
+	const auto rightOverlap = maxX > polyMaxX && minX < polyMaxX;
 
 	return leftOverlap || collinearOverlap || rightOverlap;
 }
 
 bool Elite::Polygon::OverlappingYAxis(const Polygon& poly) const
 {
-	auto bottomOverlap = this->GetPosVertMaxYPos() < poly.GetPosVertMaxYPos() && this->GetPosVertMaxYPos() > poly.GetPosVertMinYPos();
-	auto collinearOverlap = this->GetPosVertMinYPos() >= poly.GetPosVertMinYPos() && this->GetPosVertMaxYPos() <= poly.GetPosVertMaxYPos();
-	auto topOverlap = this->GetPosVertMaxYPos() > poly.GetPosVertMaxYPos() && this->GetPosVertMinYPos() < poly.GetPosVertMaxYPos();
+	const auto minY = GetPosVertMinYPos();
+	const auto maxY = GetPosVertMaxYPos();
+	const auto polyMinY = poly.GetPosVertMinYPos();
+	const auto polyMaxY = poly.GetPosVertMaxYPos();
+
+	const auto bottomOverlap = maxY < polyMaxY && maxY > polyMinY;
+	const auto collinearOverlap = minY >= polyMinY && maxY <= polyMaxY;
+	const auto topOverlap = maxY > polyMaxY && minY < polyMaxY;
 
 	return bottomOverlap || collinearOverlap || topOverlap;
 }
 
-std::vector<Elite::Triangle*> Elite::Polygon::GetAdjacentTriangles(const Triangle* t) const
+Elite::Span<Elite::Triangle* const> Elite::Polygon::GetAdjacentTriangles(const Triangle* t) const
 {
-	//For this triangle, go over all triangles and look if any of it's edges matches the edges of a triangle,
-	//in other words, two points overlap. If two points match, it's an adjacent triangle
-	std::vector<Triangle*> adjTriangles;
-	for (auto ct : m_vpTriangles)
-	{
-		if (t == ct) //If same triangle, ignore
-			continue;
-
-		//Check if points match
-		auto matchingVerts = 0;
-		if (t->p1 == ct->p1 || t->p1 == ct->p2 || t->p1 == ct->p3)
-			++matchingVerts;
-		if (t->p2 == ct->p1 || t->p2 == ct->p2 || t->p2 == ct->p3)
-			++matchingVerts;
-		if (t->p3 == ct->p1 || t->p3 == ct->p2 || t->p3 == ct->p3)
-			++matchingVerts;
-
-		//Only adjacent of two points match!
-		if (matchingVerts == 2)
-			adjTriangles.push_back(ct);
-	}
-	return adjTriangles;
+	//Triangles sharing an edge with this triangle, looked up in the adjacency table built with the line matrix.
+	//WARNING: this only works when metadata has been enabled!
+#ifdef USE_TRIANGLE_METADATA
+	const int triangleIndex = t->metaData.IndexTriangle;
+	if (triangleIndex >= 0 && triangleIndex < static_cast<int>(m_vAdjacentCount.size()) && m_vpTriangles[triangleIndex] == t)
+		return Span<Triangle* const>(&m_vpAdjacentTriangles[triangleIndex * 3], m_vAdjacentCount[triangleIndex]);
+#endif
+	return {};
 }
 
-std::vector<Elite::Triangle*> Elite::Polygon::GetAdjacentTrianglesOnLine(const Triangle* t, const Line& l) const
+Elite::Span<Elite::Triangle* const> Elite::Polygon::GetAdjacentTrianglesOnLine(const Triangle* t, const Line& l) const
 {
-	//For this triangle, go over all triangles and look if it's edges matches the given line.
+	//For this triangle, return the triangle on the other side of the given line (if any).
 	//WARNING: this only works when metadata has been enabled!
-	std::vector<Triangle*> adjTriangles;
-
 #ifdef USE_TRIANGLE_METADATA
-	//Start by getting index of line in matrix
-	auto lRev = Line(l.p2, l.p1);
-	const auto it = std::find_if(m_vpLines.begin(), m_vpLines.end(), [&](const Line* rl)
-		{ return (*rl == l || *rl == lRev); });
-	if (it == m_vpLines.end())
+	//Lines from the matrix know their index, other lines are searched for
+	const auto lRev = Line(l.p2, l.p1);
+	auto lineIndex = l.index;
+	if (lineIndex < 0 || lineIndex >= static_cast<int>(m_vpLines.size())
+		|| (*m_vpLines[lineIndex] != l && *m_vpLines[lineIndex] != lRev))
 	{
-		std::cout << "WARNING: line not found!" << std::endl;
-		return adjTriangles;
+		const auto it = std::find_if(m_vpLines.begin(), m_vpLines.end(), [&](const Line* rl)
+			{ return (*rl == l || *rl == lRev); });
+		if (it == m_vpLines.end())
+		{
+			std::cout << "WARNING: line not found!" << std::endl;
+			return {};
+		}
+		lineIndex = static_cast<int>(it - m_vpLines.begin());
 	}
-	const int lineIndex = it - m_vpLines.begin();
-
-	//Go over all the triangles and compare lines
-	for (auto ct : m_vpTriangles)
-	{
-		if (t == ct) //If same triangle, ignore
-			continue;
 
-		if (ct->metaData.IndexLines[0] == lineIndex
-			|| ct->metaData.IndexLines[1] == lineIndex
-			|| ct->metaData.IndexLines[2] == lineIndex)
-			adjTriangles.push_back(ct);
-	}
+	//Skip the given triangle, the remaining slot is the adjacent triangle
+	Triangle* const* pLineTriangles = &m_vpLineTriangles[lineIndex * 2];
+	if (pLineTriangles[0] == t)
+		return Span<Triangle* const>(pLineTriangles + 1, pLineTriangles[1] ? 1 : 0);
+	if (pLineTriangles[1] == t)
+		return Span<Triangle* const>(pLineTriangles, 1);
+	return Span<Triangle* const>(pLineTriangles, pLineTriangles[1] ? 2 : 1);
+#else
+	return {};
 #endif
-	return adjTriangles;
 }
 
 const Elite::Triangle* Elite::Polygon::GetTriangleFromPosition(const Vector2& position, bool onLineAllowed /*= false*/) const
 {
-	for (size_t i = 0; i < m_vpTriangles.size(); i++)
+	//No grid available (not triangulated through Triangulate()), fall back on testing every triangle
+	if (m_vGridCellStart.empty())
 	{
-		if (PointInTriangle(position, m_vpTriangles[i]->p1, m_vpTriangles[i]->p2, m_vpTriangles[i]->p3, onLineAllowed))
-			return m_vpTriangles[i];
+		for (size_t i = 0; i < m_vpTriangles.size(); i++)
+		{
+			if (PointInTriangle(position, m_vpTriangles[i]->p1, m_vpTriangles[i]->p2, m_vpTriangles[i]->p3, onLineAllowed))
+				return m_vpTriangles[i];
+		}
+		return nullptr;
 	}
-	return nullptr;
+
+	//Only test the triangles overlapping the cell of this position. The indices in a cell are ascending,
+	//so the first hit is the same triangle the linear search would return.
+	const int cellIdx = GetGridCellIndex(position);
+	if (cellIdx == -1)
+		return nullptr;
+
+	const int cellStart = m_vGridCellStart[cellIdx];
+	const int gridIdx = FindTriangleContainingPoint(position, m_GridTriangleBatch, cellStart, m_vGridCellStart[cellIdx + 1] - cellStart, onLineAllowed);
+	return (gridIdx == -1) ? nullptr : m_vpTriangles[m_vGridTriangles[gridIdx]];
+}
+
+void Elite::Polygon::LocateTriangles(const Vector2* positions, int count, const Triangle** pTriangles, bool onLineAllowed /*= false*/) const
+{
+	//Batched version of GetTriangleFromPosition, output is written per position (nullptr if not on the mesh)
+	for (int i = 0; i < count; ++i)
+		pTriangles[i] = GetTriangleFromPosition(positions[i], onLineAllowed);
 }
 
 #ifdef USE_TRIANGLE_METADATA
-const std::vector<const Elite::Triangle*> Elite::Polygon::GetTrianglesFromLineIndex(unsigned int lineIndex) const
+Elite::Span<const Elite::Triangle* const> Elite::Polygon::GetTrianglesFromLineIndex(unsigned int lineIndex) const
 {
-	std::vector<const Triangle*> vpFoundTriangles = {};
-	for (auto pT : m_vpTriangles)
-	{
-		if (pT->metaData.IndexLines[0] == lineIndex ||
-			pT->metaData.IndexLines[1] == lineIndex ||
-			pT->metaData.IndexLines[2] == lineIndex)
-		{
-			vpFoundTriangles.push_back(pT);
-		}
-	}
-	return vpFoundTriangles;
+	//One triangle for border lines, two for shared lines
+	if (lineIndex >= m_vpLines.size())
+		return {};
+	const Triangle* const* pLineTriangles = &m_vpLineTriangles[lineIndex * 2];
+	return Span<const Triangle* const>(pLineTriangles, pLineTriangles[1] ? 2 : 1);
 }
 #endif
 
@@ -272,35 +281,21 @@ const std::vector<Elite::Triangle*>& Elite::Polygon::Triangulate()
 	//Check winding
 	OrientateWithChildren(Winding::CCW);
 
-	//TODO: CHECK FOR OVERLAPPING POLYGONS AND MERGE WHEN REQUIRED
-	for (auto child : m_vChildren)
-	{
-		//Check for overlap, if so merge, create new child and remove old ones!
-		//FILL IN FUNCTIONS!
-	}
+	//Merge overlapping children, the holes have to be disjoint to split them into the outline.
+	//Keep the original children, they are restored at the end.
+	const auto originalChildren = m_vChildren;
+	m_vChildren = UnionPolygons(m_vChildren);
+	for (auto& child : m_vChildren)
+		child.OrientateWithChildren(Winding::CW);
 
-	//Sort the children. Start by sorting from top to bottom (verices are what matters, not the "center" pos of the polygon!)
+	//Sort the children from right to left (verices are what matters, not the "center" pos of the polygon!).
+	//Merging the right most hole first guarantees the bridge of every next hole can not cross an already merged one.
 	std::sort(m_vChildren.begin(), m_vChildren.end(),
 		[](const Polygon& p1, const Polygon& p2)
-		{ return p1.GetPosVertMaxYPos() > p2.GetPosVertMaxYPos(); });
+		{ return p1.GetPosVertMaxXPos() > p2.GetPosVertMaxXPos(); });
 
-	//Copy children as backup after sort
-	const auto children = m_vChildren;
-
-	//THEN, we check two elements, if the don't overlap horizontally you don't do anything, else you swap them based on right most object
-	for (auto i = 0; i < static_cast<int>(m_vChildren.size()) - 1; ++i)
-	{
-		if (m_vChildren[i].OverlappingYAxis(m_vChildren[i + 1]))
-		{
-			//Swap if i.y < i+1.y
-			if (m_vChildren[i].GetPosVertMaxXPos() < m_vChildren[i + 1].GetPosVertMaxXPos())
-			{
-				const auto temp = m_vChildren[i];
-				m_vChildren[i] = m_vChildren[i + 1];
-				m_vChildren[i + 1] = temp;
-			}
-		}
-	}
+	//Copy outline as backup, splitting merges the children into the outline
+	const auto points = m_vPoints;
 
 	//First split polygon
 	while (m_vChildren.size() != 0)
@@ -311,37 +306,16 @@ const std::vector<Elite::Triangle*>& Elite::Polygon::Triangulate()
 		SAFE_DELETE(t);
 	m_vpTriangles.clear();
 
-	std::list<Vector2> copyPoints;
-	copyPoints.assign(m_vPoints.begin(), m_vPoints.end()); //Copy
+	//Work on indices into the points: ear clipping first, then flip the result to a
+	//constrained Delaunay triangulation (better shaped triangles = wider portals)
+	const auto& vertices = m_vPoints;
+	std::vector<std::array<int, 3>> triangleIndices;
+	m_isTriangulatedCompletely = EarClip(vertices, triangleIndices);
+	FlipToDelaunay(vertices, triangleIndices);
 
-	//For each ear, remove ear and push verts, recheck earness (including convexness obviously :-))!
-	while (copyPoints.size() > 3)
-	{
-		list<Vector2>::const_iterator earListIt = copyPoints.end();
-		for (auto it = copyPoints.begin(); it != copyPoints.end(); ++it)
-		{
-			if (earListIt != copyPoints.end())
-				break;
-			if (IsConvexInPolygon(copyPoints, it) && IsEar(copyPoints, it))
-				earListIt = it;
-		}
-
-		//Push triangle
-		Vector2 current, prev, next;
-		GetTriangle(copyPoints, earListIt, current, prev, next);
-		Triangle* t = new Triangle(prev, current, next);
-		m_vpTriangles.push_back(t);
-
-		//Remove current from pointslist
-		const auto currentIt = std::find(copyPoints.begin(), copyPoints.end(), current);
-		copyPoints.erase(currentIt); //remove
-	}
-	//Add the remaining 3 vertices to the triangulated polygon
-	std::vector<Vector2> tempCopy;
-	for (const auto p : copyPoints)
-		tempCopy.push_back(p);
-	Triangle* lastTriangle = new Triangle(tempCopy[0], tempCopy[1], tempCopy[2]);
-	m_vpTriangles.push_back(lastTriangle);
+	m_vpTriangles.reserve(triangleIndices.size());
+	for (const auto& t : triangleIndices)
+		m_vpTriangles.push_back(new Triangle(vertices[t[0]], vertices[t[1]], vertices[t[2]]));
 
 	//Flag as triangulated for later use
 	m_isTriangulated = true;
@@ -350,7 +324,10 @@ const std::vector<Elite::Triangle*>& Elite::Polygon::Triangulate()
 	GenerateLineMatrix();
 #endif
 
-	m_vChildren = children;
+	BuildTriangleGrid();
+
+	m_vChildren = originalChildren;
+	m_vPoints = points;
 	return m_vpTriangles;
 }
 
@@ -360,54 +337,212 @@ void Elite::Polygon::OrientateWithChildren(Winding winding)
 	//accordingly! Start with THIS shape.
 	const auto currentWinding = GetPolygonWinding(m_vPoints);
 	if (currentWinding != winding)
-		m_vPoints.reverse();
+		std::reverse(m_vPoints.begin(), m_vPoints.end());
 
 	//Rewind the children if necessary
 	auto windingChildren = abs(winding - 1); //CCW -> CW, CW -> CCW ----- abs(0-1)=1, abs(1-1)=0
-	for (auto child : m_vChildren)
+	for (auto& child : m_vChildren)
 		child.OrientateWithChildren(static_cast<Winding>(windingChildren));
 }
 
-void Elite::Polygon::ExpandShape(float amount)
+void Elite::Polygon::ExpandShape(float amount, float miterLimit /*= 2.0f*/)
 {
-	//Expand each vertex along it's normal (based on adjacent edges)
-	std::list<Vector2> adjustedPoints;
+	//Expand each vertex along it's normal (based on adjacent edges), outwards for both windings
+	const float outwards = (GetPolygonWinding(m_vPoints) == Winding::CW) ? 1.0f : -1.0f;
+	std::vector<Vector2> adjustedPoints;
+	adjustedPoints.reserve(m_vPoints.size());
 	for (auto it = m_vPoints.begin(); it != m_vPoints.end(); ++it)
 	{
 		Vector2 current, prev, next;
 		GetTriangle(m_vPoints, it, current, prev, next);
-		//Calculate directions
+		//Calculate directions, skip duplicate points
 		auto dirOne = current - prev;
 		auto dirTwo = next - current;
-		//Calculate normals + esize normals based on amount
-		Vector2 normOne = Vector2(-dirOne.y, dirOne.x);
+		if (dirOne.MagnitudeSquared() <= FLT_EPSILON || dirTwo.MagnitudeSquared() <= FLT_EPSILON)
+			continue;
+		//Calculate normals
+		Vector2 normOne = Vector2(-dirOne.y, dirOne.x) * outwards;
 		normOne.Normalize();
-		normOne *= amount;
-		Vector2 normTwo = Vector2(-dirTwo.y, dirTwo.x);
+		Vector2 normTwo = Vector2(-dirTwo.y, dirTwo.x) * outwards;
 		normTwo.Normalize();
-		normTwo *= amount;
-		//Find size hypotenuse
-		auto l1 = normOne.Magnitude();
-		auto l2 = normTwo.Magnitude();
-		auto size = sqrtf(l1 * l1 + l2 * l2);
-		//Resize vertex normal
-		Vector2 fnorm = Vector2(normOne + normTwo) / 2.0f;
-		fnorm.Normalize();
-		fnorm *= size;
+		//Miter: move along the bisector so both edges are moved by amount
+		Vector2 bisector = normOne + normTwo;
+		const float cosHalfAngle = bisector.Normalize() * 0.5f;
+		const bool isConvex = Cross(dirOne, dirTwo) * outwards < 0.0f;
+		if (isConvex && (cosHalfAngle <= FLT_EPSILON || 1.0f / cosHalfAngle > miterLimit))
+		{
+			//Sharp corner, the miter would stick out too far: bevel it with a point on each edge normal
+			adjustedPoints.push_back(current + normOne * amount);
+			adjustedPoints.push_back(current + normTwo * amount);
+			continue;
+		}
 
 		//Displace
-		adjustedPoints.push_back(*it + fnorm);
+		adjustedPoints.push_back(current + bisector * (amount / max(cosHalfAngle, FLT_EPSILON)));
 	}
 	//Overwrite data
-	m_vPoints = adjustedPoints;
+	m_vPoints = std::move(adjustedPoints);
+	m_isCacheDirty = true;
+}
+
+#ifdef USE_TRIANGLE_METADATA
+bool Elite::Polygon::InsertHole(const Polygon& hole, TriangulationPatch* pPatch /*= nullptr*/)
+{
+	if (!m_isTriangulated || m_vGridCellStart.empty() || hole.m_vPoints.size() < 3)
+		return false;
+
+	//Holes are stored clockwise
+	Polygon cwHole(hole.m_vPoints);
+	cwHole.OrientateWithChildren(Winding::CW);
+	const auto& holePoints = cwHole.m_vPoints;
+
+	//Start with the triangles in the grid cells overlapping the hole, that overlap its bounding box themselves
+	std::vector<int> region;
+	std::vector<bool> inRegion(m_vpTriangles.size(), false);
+	const Vector2 holeMin{ cwHole.GetPosVertMinXPos(), cwHole.GetPosVertMinYPos() };
+	const Vector2 holeMax{ cwHole.GetPosVertMaxXPos(), cwHole.GetPosVertMaxYPos() };
+	const int colMin = max(0, static_cast<int>((holeMin.x - m_GridOrigin.x) * m_GridInvCellSize));
+	const int rowMin = max(0, static_cast<int>((holeMin.y - m_GridOrigin.y) * m_GridInvCellSize));
+	const int colMax = min(m_GridCols - 1, static_cast<int>((holeMax.x - m_GridOrigin.x) * m_GridInvCellSize));
+	const int rowMax = min(m_GridRows - 1, static_cast<int>((holeMax.y - m_GridOrigin.y) * m_GridInvCellSize));
+	for (int row = rowMin; row <= rowMax; ++row)
+	{
+		for (int col = colMin; col <= colMax; ++col)
+		{
+			const int cellIdx = row * m_GridCols + col;
+			for (int i = m_vGridCellStart[cellIdx]; i < m_vGridCellStart[cellIdx + 1]; ++i)
+			{
+				const auto t = m_vpTriangles[m_vGridTriangles[i]];
+				if (inRegion[m_vGridTriangles[i]]
+					|| max(t->p1.x, max(t->p2.x, t->p3.x)) < holeMin.x || min(t->p1.x, min(t->p2.x, t->p3.x)) > holeMax.x
+					|| max(t->p1.y, max(t->p2.y, t->p3.y)) < holeMin.y || min(t->p1.y, min(t->p2.y, t->p3.y)) > holeMax.y)
+					continue;
+
+				inRegion[m_vGridTriangles[i]] = true;
+				region.push_back(m_vGridTriangles[i]);
+			}
+		}
+	}
+	if (region.empty())
+		return false;
+
+	//The region has to be a single loop with the hole strictly inside: every hole vertex on a region triangle
+	//and no hole edge touching the loop. Else grow the region a couple of times before giving up.
+	const auto isHoleInside = [&](const std::vector<Vector2>& boundary)
+	{
+		for (const auto& p : holePoints)
+		{
+			const auto it = std::find_if(region.begin(), region.end(), [&](int t)
+				{ return PointInTriangle(p, m_vpTriangles[t]->p1, m_vpTriangles[t]->p2, m_vpTriangles[t]->p3, true); });
+			if (it == region.end())
+				return false;
+		}
+		for (size_t i = 0; i < holePoints.size(); ++i)
+		{
+			const auto& h1 = holePoints[i];
+			const auto& h2 = holePoints[(i + 1) % holePoints.size()];
+			for (size_t j = 0; j < boundary.size(); ++j)
+			{
+				if (AreSegmentsIntersecting(h1, h2, boundary[j], boundary[(j + 1) % boundary.size()]))
+					return false;
+			}
+		}
+		return true;
+	};
+
+	const int amountGrowAttempts = 4;
+	std::vector<Vector2> boundary;
+	std::vector<int> boundaryLines;
+	for (int attempt = 0; attempt <= amountGrowAttempts; ++attempt)
+	{
+		if (attempt > 0)
+			GrowRegion(region, inRegion);
+		if (!GetRegionBoundary(region, inRegion, {}, boundary, boundaryLines) || !isHoleInside(boundary))
+			continue;
+
+		//Triangulate the region with the hole in it and swap the triangles
+		Polygon cavity(boundary);
+		cavity.AddChild(cwHole);
+		cavity.Triangulate();
+
+		ReplaceRegion(region, boundaryLines, cavity.m_vpTriangles, pPatch);
+		AddChild(cwHole);
+		return true;
+	}
+	return false;
+}
+
+bool Elite::Polygon::RemoveHole(const Polygon& hole, TriangulationPatch* pPatch /*= nullptr*/)
+{
+	if (!m_isTriangulated || m_vGridCellStart.empty())
+		return false;
+
+	const auto child = std::find_if(m_vChildren.begin(), m_vChildren.end(), [&](const Polygon& c) { return c.m_vPoints == hole.m_vPoints; });
+	if (child == m_vChildren.end())
+		return false;
+	const auto& holePoints = child->m_vPoints;
+
+	//Start with every triangle touching a vertex of the hole (these triangles are all in the cell of that vertex)
+	std::vector<int> region;
+	std::vector<bool> inRegion(m_vpTriangles.size(), false);
+	for (const auto& p : holePoints)
+	{
+		const int cellIdx = GetGridCellIndex(p);
+		if (cellIdx == -1)
+			return false;
+
+		bool isMeshVertex = false;
+		for (int i = m_vGridCellStart[cellIdx]; i < m_vGridCellStart[cellIdx + 1]; ++i)
+		{
+			const auto t = m_vpTriangles[m_vGridTriangles[i]];
+			if (t->p1 != p && t->p2 != p && t->p3 != p)
+				continue;
+
+			isMeshVertex = true;
+			if (!inRegion[m_vGridTriangles[i]])
+			{
+				inRegion[m_vGridTriangles[i]] = true;
+				region.push_back(m_vGridTriangles[i]);
+			}
+		}
+		//Hole (partially) outside of the mesh
+		if (!isMeshVertex)
+			return false;
+	}
+
+	//The edges of the hole disappear, the rest of the region boundary has to be a single loop
+	std::vector<Line> holeEdges;
+	holeEdges.reserve(holePoints.size());
+	for (size_t i = 0; i < holePoints.size(); ++i)
+		holeEdges.push_back(Line(holePoints[i], holePoints[(i + 1) % holePoints.size()]));
+
+	const int amountGrowAttempts = 4;
+	std::vector<Vector2> boundary;
+	std::vector<int> boundaryLines;
+	for (int attempt = 0; attempt <= amountGrowAttempts; ++attempt)
+	{
+		if (attempt > 0)
+			GrowRegion(region, inRegion);
+		if (!GetRegionBoundary(region, inRegion, holeEdges, boundary, boundaryLines))
+			continue;
+
+		Polygon cavity(boundary);
+		cavity.Triangulate();
+
+		ReplaceRegion(region, boundaryLines, cavity.m_vpTriangles, pPatch);
+		m_vChildren.erase(child);
+		return true;
+	}
+	return false;
 }
+#endif
 #pragma endregion //TriangulationFunctions
 //----------------------------------------------------------
 #pragma region PrivateGeneralFunctions
-void Elite::Polygon::GetTriangle(const list<Vector2>& l, const list<Vector2>::const_iterator p, Vector2& currentTip, Vector2& previous, Vector2& next) const
+void Elite::Polygon::GetTriangle(const std::vector<Vector2>& l, const std::vector<Vector2>::const_iterator p, Vector2& currentTip, Vector2& previous, Vector2& next) const
 {
 	//Look at the point list of this polygon as it where a circular list (end attach begin)
-	list<Vector2>::const_iterator prev;
+	std::vector<Vector2>::const_iterator prev;
 	if (p == l.begin())
 		prev = std::prev(l.end());
 	else
@@ -423,7 +558,7 @@ void Elite::Polygon::GetTriangle(const list<Vector2>& l, const list<Vector2>::co
 	next = *n;
 }
 
-bool Elite::Polygon::IsConvexInPolygon(const list<Vector2>& l, const list<Vector2>::const_iterator p) const
+bool Elite::Polygon::IsConvexInPolygon(const std::vector<Vector2>& l, const std::vector<Vector2>::const_iterator p) const
 {
 	//Look at the point list of this polygon as it where a circular list (end attach begin)
 	Vector2 current, prev, next;
@@ -431,193 +566,540 @@ bool Elite::Polygon::IsConvexInPolygon(const list<Vector2>& l, const list<Vector
 	return IsConvex(current, prev, next);
 }
 
-bool Elite::Polygon::IsEar(const list<Vector2>& l, const list<Vector2>::const_iterator p) const
+bool Elite::Polygon::EarClip(const std::vector<Vector2>& vertices, std::vector<std::array<int, 3>>& triangles) const
 {
-	//Look at the point list of this polygon as it where a circular list (end attach begin)
-	Vector2 current, prev, next;
-	GetTriangle(l, p, current, prev, next);
+	//Ear clipping over an index linked list. Only reflex vertices can lie inside an ear, so those are
+	//the only ones tested. A reflex vertex can become convex when a neighbour gets clipped, never the other way around.
+	const int amountVertices = static_cast<int>(vertices.size());
+	triangles.clear();
+	if (amountVertices < 3)
+		return true;
+	triangles.reserve(amountVertices - 2);
+
+	std::vector<int> prev(amountVertices), next(amountVertices);
+	for (int i = 0; i < amountVertices; ++i)
+	{
+		prev[i] = (i == 0) ? amountVertices - 1 : i - 1;
+		next[i] = (i == amountVertices - 1) ? 0 : i + 1;
+	}
+
+	std::vector<bool> isReflex(amountVertices);
+	std::vector<int> reflexVertices;
+	std::vector<float> reflexX, reflexY; //Positions of the reflex vertices, tested against an ear in batches
+	for (int i = 0; i < amountVertices; ++i)
+	{
+		isReflex[i] = !IsConvex(vertices[i], vertices[prev[i]], vertices[next[i]]);
+		if (isReflex[i])
+		{
+			reflexVertices.push_back(i);
+			reflexX.push_back(vertices[i].x);
+			reflexY.push_back(vertices[i].y);
+		}
+	}
+
+	const auto isEar = [&](int i)
+	{
+		if (isReflex[i])
+			return false;
 
-	//See if there are any vertices (excluding the ones of the triangle) are in the triangle
-	for (auto it = l.begin(); it != l.end(); ++it)
+		const Vector2& current = vertices[i];
+		const Vector2& previous = vertices[prev[i]];
+		const Vector2& following = vertices[next[i]];
+		const int amountReflex = static_cast<int>(reflexVertices.size());
+		for (int first = 0; first < amountReflex;)
+		{
+			const int hit = FindPointInTriangle(reflexX.data() + first, reflexY.data() + first, amountReflex - first, current, previous, following);
+			if (hit == -1)
+				return true;
+
+			//Skip clipped and no longer reflex vertices, and (duplicated) vertices of the triangle itself
+			const int r = reflexVertices[first + hit];
+			first += hit + 1;
+			if (!isReflex[r] || r == i || r == prev[i] || r == next[i])
+				continue;
+			if (vertices[r] == current || vertices[r] == previous || vertices[r] == following)
+				continue;
+			return false;
+		}
+		return true;
+	};
+
+	int remaining = amountVertices;
+	//Unlinks a vertex and marks it as not reflex, so it gets skipped in the ear tests. Returns the previous vertex
+	const auto removeVertex = [&](int i)
 	{
-		if (*it == current || *it == prev || *it == next)
+		const int p = prev[i];
+		const int n = next[i];
+		next[p] = n;
+		prev[n] = p;
+		isReflex[i] = false;
+		--remaining;
+
+		//Neighbours might have become convex
+		if (isReflex[p])
+			isReflex[p] = !IsConvex(vertices[p], vertices[prev[p]], vertices[next[p]]);
+		if (isReflex[n])
+			isReflex[n] = !IsConvex(vertices[n], vertices[prev[n]], vertices[next[n]]);
+		return p;
+	};
+
+	int current = 0;
+	int amountFailed = 0;
+	while (remaining > 3)
+	{
+		if (isEar(current))
+		{
+			triangles.push_back({ { prev[current], current, next[current] } });
+			current = removeVertex(current);
+			amountFailed = 0;
+			continue;
+		}
+
+		current = next[current];
+		if (++amountFailed <= remaining)
 			continue;
 
-		if (PointInTriangle(*it, current, prev, next))
+		//No ear in a full loop, only happens with degenerate input (collinear or duplicated vertices).
+		//A vertex on the line through its neighbours has no area to cover, drop it without a triangle.
+		//Clipping any other vertex that isn't an ear would give overlapping triangles, give up instead.
+		int degenerate = -1;
+		for (int i = 0, v = current; i < remaining && degenerate == -1; ++i, v = next[v])
+		{
+			const Vector2 toPrevious = vertices[prev[v]] - vertices[v];
+			const Vector2 toNext = vertices[next[v]] - vertices[v];
+			if (abs(Cross(toPrevious, toNext)) <= 4.f * FLT_EPSILON * toPrevious.Magnitude() * toNext.Magnitude())
+				degenerate = v;
+		}
+		if (degenerate == -1)
 			return false;
+
+		current = removeVertex(degenerate);
+		amountFailed = 0;
 	}
+	//Add the remaining 3 vertices, unless they are on one line (degenerate input, no area left)
+	if (IsConvex(vertices[current], vertices[prev[current]], vertices[next[current]]))
+		triangles.push_back({ { prev[current], current, next[current] } });
 	return true;
 }
 
-void Elite::Polygon::GenerateLineMatrix()
+void Elite::Polygon::FlipToDelaunay(const std::vector<Vector2>& vertices, std::vector<std::array<int, 3>>& triangles) const
 {
-#ifdef USE_TRIANGLE_METADATA
-	//Go over all the triangles
-	for (auto t : m_vpTriangles)
+	//Lawson flips: flip every interior edge whose opposite vertex lies in the circumcircle, until none are left.
+	//Polygon edges are never shared by two triangles (in index space), so they act as constraints.
+	const auto edgeKey = [](int a, int b)
 	{
-		//Go over all the lines of the triangle, search if they are already in the matrix
-		//If not add them and store it's index in the triangles meta data
-		const Line l1{ t->p1, t->p2 };
-		const Line l1rev{ t->p2, t->p1 };
-		const Line l2{ t->p2, t->p3 };
-		const Line l2rev{ t->p3, t->p2 };
-		const Line l3{ t->p3, t->p1 };
-		const Line l3rev{ t->p1, t->p3 };
-		for (auto i = 0; i < static_cast<int>(m_vpLines.size()); ++i)
+		return (a < b) ? (static_cast<unsigned long long>(a) << 32) | static_cast<unsigned int>(b)
+			: (static_cast<unsigned long long>(b) << 32) | static_cast<unsigned int>(a);
+	};
+
+	//Two triangles per edge, -1 if none
+	std::unordered_map<unsigned long long, std::array<int, 2>> edgeTriangles;
+	edgeTriangles.reserve(triangles.size() * 3);
+	for (int t = 0; t < static_cast<int>(triangles.size()); ++t)
+	{
+		for (int e = 0; e < 3; ++e)
 		{
-			const auto l = m_vpLines[i];
-			if (*l == l1 || *l == l1rev)
-				t->metaData.IndexLines[0] = i;
-			if (*l == l2 || *l == l2rev)
-				t->metaData.IndexLines[1] = i;
-			if (*l == l3 || *l == l3rev)
-				t->metaData.IndexLines[2] = i;
+			auto it = edgeTriangles.emplace(edgeKey(triangles[t][e], triangles[t][(e + 1) % 3]), std::array<int, 2>{ { -1, -1 } }).first;
+			it->second[it->second[0] == -1 ? 0 : 1] = t;
 		}
-		//Not found, add to matrix
-		if (t->metaData.IndexLines[0] == -1)
+	}
+
+	const auto replaceTriangle = [&](int a, int b, int oldT, int newT)
+	{
+		auto& shared = edgeTriangles[edgeKey(a, b)];
+		shared[shared[0] == oldT ? 0 : 1] = newT;
+	};
+
+	std::vector<std::pair<int, int>> edgesToCheck;
+	edgesToCheck.reserve(edgeTriangles.size());
+	for (const auto& e : edgeTriangles)
+	{
+		if (e.second[1] != -1)
+			edgesToCheck.push_back({ static_cast<int>(e.first >> 32), static_cast<int>(e.first & 0xFFFFFFFF) });
+	}
+
+	//Safety net against float precision cycles, a triangulation is valid after any amount of flips
+	int flipsLeft = 32 * static_cast<int>(triangles.size()) + 64;
+	while (!edgesToCheck.empty() && flipsLeft > 0)
+	{
+		const int a0 = edgesToCheck.back().first;
+		const int b0 = edgesToCheck.back().second;
+		edgesToCheck.pop_back();
+
+		const auto it = edgeTriangles.find(edgeKey(a0, b0));
+		if (it == edgeTriangles.end() || it->second[1] == -1)
+			continue;
+		const int t1 = it->second[0];
+		const int t2 = it->second[1];
+
+		//Rotate so t1 = (a, b, c) and t2 = (b, a, d), both CCW
+		int e1 = 0;
+		while (!(triangles[t1][e1] == a0 && triangles[t1][(e1 + 1) % 3] == b0) && !(triangles[t1][e1] == b0 && triangles[t1][(e1 + 1) % 3] == a0))
+			++e1;
+		const int a = triangles[t1][e1];
+		const int b = triangles[t1][(e1 + 1) % 3];
+		const int c = triangles[t1][(e1 + 2) % 3];
+		int d = -1;
+		for (const int v : triangles[t2])
 		{
-			const int index = m_vpLines.size();
-			m_vpLines.push_back(new Line(t->p1, t->p2, index));
-			t->metaData.IndexLines[0] = index;
+			if (v != a && v != b)
+				d = v;
 		}
-		if (t->metaData.IndexLines[1] == -1)
+
+		//Duplicated (bridge) vertices, never flip onto those
+		if (d == -1 || vertices[c] == vertices[d] || vertices[a] == vertices[b])
+			continue;
+		if (!IsPointInCircumcircle(vertices[d], vertices[a], vertices[b], vertices[c]))
+			continue;
+
+		//Only flip convex quads, else the new diagonal would leave the quad
+		if (Cross(vertices[d] - vertices[c], vertices[a] - vertices[c]) >= 0.f
+			|| Cross(vertices[d] - vertices[c], vertices[b] - vertices[c]) <= 0.f)
+			continue;
+
+		//Flip: (a, b, c) + (b, a, d) -> (a, d, c) + (d, b, c)
+		triangles[t1] = { { a, d, c } };
+		triangles[t2] = { { d, b, c } };
+		edgeTriangles.erase(it);
+		edgeTriangles[edgeKey(c, d)] = { { t1, t2 } };
+		replaceTriangle(a, d, t2, t1);
+		replaceTriangle(b, c, t1, t2);
+		--flipsLeft;
+
+		edgesToCheck.push_back({ a, d });
+		edgesToCheck.push_back({ d, b });
+		edgesToCheck.push_back({ b, c });
+		edgesToCheck.push_back({ c, a });
+	}
+}
+
+void Elite::Polygon::GenerateLineMatrix()
+{
+#ifdef USE_TRIANGLE_METADATA
+	//Start from an empty matrix, lines of a previous triangulation are no longer valid
+	for (auto l : m_vpLines)
+		SAFE_DELETE(l);
+	m_vpLines.clear();
+
+	//Lines are matched on position (not on vertex index), so the vertices duplicated by Split() share their lines.
+	//Hash the positions instead of comparing every edge against every line.
+	std::unordered_map<unsigned long long, int> pointIds;
+	std::unordered_map<unsigned long long, int> lineIndices;
+	pointIds.reserve(m_vpTriangles.size() * 3);
+	lineIndices.reserve(m_vpTriangles.size() * 3);
+
+	const auto getPointId = [&pointIds](const Vector2& p)
+	{
+		const float x = p.x + 0.f; //-0.f -> 0.f
+		const float y = p.y + 0.f;
+		unsigned int xBits, yBits;
+		std::memcpy(&xBits, &x, sizeof(xBits));
+		std::memcpy(&yBits, &y, sizeof(yBits));
+		const auto key = (static_cast<unsigned long long>(xBits) << 32) | yBits;
+		return pointIds.emplace(key, static_cast<int>(pointIds.size())).first->second;
+	};
+
+	//Go over all the lines of all the triangles, add them to the matrix if not present yet
+	//and store their index in the triangles meta data
+	for (auto t : m_vpTriangles)
+	{
+		const Vector2* points[3] = { &t->p1, &t->p2, &t->p3 };
+		const int ids[3] = { getPointId(t->p1), getPointId(t->p2), getPointId(t->p3) };
+		for (int i = 0; i < 3; ++i)
 		{
+			const int j = (i + 1) % 3;
+			const auto key = (ids[i] < ids[j]) ? (static_cast<unsigned long long>(ids[i]) << 32) | static_cast<unsigned int>(ids[j])
+				: (static_cast<unsigned long long>(ids[j]) << 32) | static_cast<unsigned int>(ids[i]);
+
+			const auto it = lineIndices.find(key);
+			if (it != lineIndices.end())
+			{
+				t->metaData.IndexLines[i] = it->second;
+				continue;
+			}
+
+			//Not found, add to matrix
 			const int index = m_vpLines.size();
-			m_vpLines.push_back(new Line(t->p2, t->p3, index));
-			t->metaData.IndexLines[1] = index;
+			m_vpLines.push_back(new Line(*points[i], *points[j], index));
+			lineIndices.emplace(key, index);
+			t->metaData.IndexLines[i] = index;
 		}
-		if (t->metaData.IndexLines[2] == -1)
+	}
+
+	BuildAdjacency();
+#endif
+}
+
+void Elite::Polygon::BuildAdjacency()
+{
+#ifdef USE_TRIANGLE_METADATA
+	//Per line, store the (max two) triangles sharing it. Per triangle, store the triangles on the other side of its lines.
+	m_vpLineTriangles.assign(m_vpLines.size() * 2, nullptr);
+	for (auto t : m_vpTriangles)
+	{
+		for (const int lineIdx : t->metaData.IndexLines)
 		{
-			const int index = m_vpLines.size();
-			m_vpLines.push_back(new Line(t->p3, t->p1, index));
-			t->metaData.IndexLines[2] = index;
+			Triangle** pLineTriangles = &m_vpLineTriangles[lineIdx * 2];
+			pLineTriangles[pLineTriangles[0] ? 1 : 0] = t;
 		}
 	}
+
+	m_vpAdjacentTriangles.assign(m_vpTriangles.size() * 3, nullptr);
+	m_vAdjacentCount.assign(m_vpTriangles.size(), 0);
+	for (int triangleIdx = 0; triangleIdx < static_cast<int>(m_vpTriangles.size()); ++triangleIdx)
+	{
+		m_vpTriangles[triangleIdx]->metaData.IndexTriangle = triangleIdx;
+		UpdateAdjacentTriangles(triangleIdx);
+	}
 #endif
 }
+
+void Elite::Polygon::UpdateAdjacentTriangles(int triangleIdx)
+{
+#ifdef USE_TRIANGLE_METADATA
+	const auto t = m_vpTriangles[triangleIdx];
+	m_vAdjacentCount[triangleIdx] = 0;
+	for (const int lineIdx : t->metaData.IndexLines)
+	{
+		const auto other = m_vpLineTriangles[lineIdx * 2] == t ? m_vpLineTriangles[lineIdx * 2 + 1] : m_vpLineTriangles[lineIdx * 2];
+		if (other)
+			m_vpAdjacentTriangles[triangleIdx * 3 + m_vAdjacentCount[triangleIdx]++] = other;
+	}
+	for (int i = m_vAdjacentCount[triangleIdx]; i < 3; ++i)
+		m_vpAdjacentTriangles[triangleIdx * 3 + i] = nullptr;
+#endif
+}
+
+void Elite::Polygon::BuildTriangleGrid()
+{
+	m_vGridCellStart.clear();
+	m_vGridTriangles.clear();
+	m_GridTriangleBatch.Clear();
+	m_GridCols = 0;
+	m_GridRows = 0;
+	m_GridAmountTriangles = 0;
+
+	const int amountTriangles = static_cast<int>(m_vpTriangles.size());
+	if (amountTriangles == 0)
+		return;
+
+	//Bounds of all the triangles
+	Vector2 minPos{ (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)() };
+	Vector2 maxPos{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (const auto t : m_vpTriangles)
+	{
+		minPos.x = min(minPos.x, min(t->p1.x, min(t->p2.x, t->p3.x)));
+		minPos.y = min(minPos.y, min(t->p1.y, min(t->p2.y, t->p3.y)));
+		maxPos.x = max(maxPos.x, max(t->p1.x, max(t->p2.x, t->p3.x)));
+		maxPos.y = max(maxPos.y, max(t->p1.y, max(t->p2.y, t->p3.y)));
+	}
+	minPos -= Vector2{ GridPadding, GridPadding };
+	maxPos += Vector2{ GridPadding, GridPadding };
+
+	//Aim for roughly one triangle per cell, but never more than 512 cells on one axis
+	const float width = maxPos.x - minPos.x;
+	const float height = maxPos.y - minPos.y;
+	const float cellSize = max(sqrtf((width * height) / static_cast<float>(amountTriangles)), max(width, height) / 512.f);
+
+	m_GridOrigin = minPos;
+	m_GridInvCellSize = 1.f / cellSize;
+	m_GridAmountTriangles = amountTriangles;
+	m_GridCols = static_cast<int>(width * m_GridInvCellSize) + 1;
+	m_GridRows = static_cast<int>(height * m_GridInvCellSize) + 1;
+
+	//1. Count the triangles per cell
+	const int amountCells = m_GridCols * m_GridRows;
+	m_vGridCellStart.assign(amountCells + 1, 0);
+	int colMin, rowMin, colMax, rowMax;
+	for (const auto t : m_vpTriangles)
+	{
+		GetGridCellRange(t, colMin, rowMin, colMax, rowMax);
+		for (int row = rowMin; row <= rowMax; ++row)
+			for (int col = colMin; col <= colMax; ++col)
+				++m_vGridCellStart[row * m_GridCols + col + 1];
+	}
+
+	//2. Prefix sum, so every cell knows where its range starts
+	for (int i = 0; i < amountCells; ++i)
+		m_vGridCellStart[i + 1] += m_vGridCellStart[i];
+
+	//3. Scatter the triangle indices (in ascending order) into their cells
+	m_vGridTriangles.resize(m_vGridCellStart[amountCells]);
+	std::vector<int> fillOffsets(m_vGridCellStart.begin(), m_vGridCellStart.end() - 1);
+	for (int i = 0; i < amountTriangles; ++i)
+	{
+		GetGridCellRange(m_vpTriangles[i], colMin, rowMin, colMax, rowMax);
+		for (int row = rowMin; row <= rowMax; ++row)
+			for (int col = colMin; col <= colMax; ++col)
+				m_vGridTriangles[fillOffsets[row * m_GridCols + col]++] = i;
+	}
+
+	//4. Copy the corners in the same order
+	m_GridTriangleBatch.Reserve(m_vGridTriangles.size());
+	for (const int triangleIdx : m_vGridTriangles)
+	{
+		const Triangle* pT = m_vpTriangles[triangleIdx];
+		m_GridTriangleBatch.Add(pT->p1, pT->p2, pT->p3);
+	}
+}
+
+void Elite::Polygon::GetGridCellRange(const Triangle* pTriangle, int& colMin, int& rowMin, int& colMax, int& rowMax) const
+{
+	const auto t = pTriangle;
+	colMin = Clamp(static_cast<int>((min(t->p1.x, min(t->p2.x, t->p3.x)) - GridPadding - m_GridOrigin.x) * m_GridInvCellSize), 0, m_GridCols - 1);
+	rowMin = Clamp(static_cast<int>((min(t->p1.y, min(t->p2.y, t->p3.y)) - GridPadding - m_GridOrigin.y) * m_GridInvCellSize), 0, m_GridRows - 1);
+	colMax = Clamp(static_cast<int>((max(t->p1.x, max(t->p2.x, t->p3.x)) + GridPadding - m_GridOrigin.x) * m_GridInvCellSize), 0, m_GridCols - 1);
+	rowMax = Clamp(static_cast<int>((max(t->p1.y, max(t->p2.y, t->p3.y)) + GridPadding - m_GridOrigin.y) * m_GridInvCellSize), 0, m_GridRows - 1);
+}
+
+int Elite::Polygon::GetGridCellIndex(const Vector2& position) const
+{
+	//Returns -1 when the position is outside of the grid
+	const float x = (position.x - m_GridOrigin.x) * m_GridInvCellSize;
+	const float y = (position.y - m_GridOrigin.y) * m_GridInvCellSize;
+	if (x < 0.f || y < 0.f)
+		return -1;
+
+	const int col = static_cast<int>(x);
+	const int row = static_cast<int>(y);
+	if (col >= m_GridCols || row >= m_GridRows)
+		return -1;
+
+	return row * m_GridCols + col;
+}
+
+void Elite::Polygon::UpdateCachedData() const
+{
+	if (!m_isCacheDirty)
+		return;
+
+	//Bounds and center (average of the vertices) of this polygon (not children)
+	m_BoundsMin = Vector2((std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)());
+	m_BoundsMax = Vector2(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+	Vector2 sum = ZeroVector2;
+	for (const auto& p : m_vPoints)
+	{
+		m_BoundsMin.x = min(m_BoundsMin.x, p.x);
+		m_BoundsMin.y = min(m_BoundsMin.y, p.y);
+		m_BoundsMax.x = max(m_BoundsMax.x, p.x);
+		m_BoundsMax.y = max(m_BoundsMax.y, p.y);
+		sum += p;
+	}
+	m_CenterPoint = sum / static_cast<float>(m_vPoints.size());
+	m_isCacheDirty = false;
+}
 #pragma endregion //PrivateGeneralFunctions
 //----------------------------------------------------------
 #pragma region PrivateTriangulationFunctions
 void Elite::Polygon::FindMutualVisibleVertices(const Polygon& outer, const Polygon& inner, Vector2& pOuter, Vector2& pInner)
 {
-	//1. Find vertex with the biggest x value of the inner polygon AND biggest x value of outer polygon (used for size ray)
+	//Reference: https://www.geometrictools.com/Documentation/TriangulationByEarClipping.pdf
+	//1. Find vertex with the biggest x value of the inner polygon
 	const auto maxInnerPoint = std::max_element(inner.m_vPoints.begin(), inner.m_vPoints.end(),
 		[](const Vector2& p1, const Vector2& p2) { return p1.x < p2.x; });
 
-	const auto maxOuterPoint = std::max_element(outer.m_vPoints.begin(), outer.m_vPoints.end(),
-		[](const Vector2& p1, const Vector2& p2) { return p1.x < p2.x; });
-	const float rayMaxX = maxOuterPoint->x;
-
 	//Store inner point to output
 	pInner = *maxInnerPoint;
+	const Vector2 M = pInner;
 
 	// --- 2. Based on found inner point, find mutually visisble outer point
-	//2.1 Intersect ray M + t(1,0) with all directed edges of OUTER (M is left of edges) - Result point I
-	//http://stackoverflow.com/questions/563198/how-do-you-detect-where-two-line-segments-intersect
-	const Vector2 furthestPointRay = Vector2(rayMaxX, maxInnerPoint->y);
-	Vector2 p = pInner;
-	Vector2 r = furthestPointRay - pInner; //Ray
+	//2.1 Intersect ray M + t(1,0) with all edges of OUTER (including the closing edge), keep the closest hit - Result point I
+	float closestDistance = (std::numeric_limits<float>::max)();
 	Vector2 I = ZeroVector2; //Found intersection
 	Vector2 intersectedLine[2] = { ZeroVector2, ZeroVector2 }; //Store to find point P if I is found
 	for (auto it = outer.m_vPoints.begin(); it != outer.m_vPoints.end(); ++it)
 	{
-		const auto next = std::next(it);
-		//If on right of innerPoint AND has a next point (to make line)
-		if (it->x > maxInnerPoint->x && next != outer.m_vPoints.end())
-		{
-			//Poly line segment
-			const Vector2 q = *it;
-			Vector2 s = *next - q;
-
-			//Capture parallel and collinear cases
-			if (Cross(r, s) == 0)
-			{
-				if (Cross(q - p, r) == 0) //== Collinear
-				{
-					//Get closest vertex (OR the correct way see link :)) - We don't check
-					//overlap because the max x of our ray is within the boundaries
-					if (it->x < next->x)
-						I = *it;
-					else
-						I = *next;
-				}
-				continue;
-			}
+		auto next = std::next(it);
+		if (next == outer.m_vPoints.end())
+			next = outer.m_vPoints.begin();
 
-			//If not parallel or collinear, search point, calculate T and U
-			float crossRS = Cross(r, s);
-			float t = Cross(q - p, s) / crossRS;
-			float u = Cross(q - p, r) / crossRS;
+		//Edge has to cross the horizontal line through M
+		if ((it->y > M.y && next->y > M.y) || (it->y < M.y && next->y < M.y))
+			continue;
 
-			//If U == 0 || u == 1, endpoints touch, else if within range also a hit
-			if (t >= 0 && t <= 1 && u >= 0 && u <= 1)
+		//Collinear with the ray, closest endpoint on the right is the hit
+		if (it->y == next->y)
+		{
+			for (const auto& endPoint : { *it, *next })
 			{
-				Vector2 tempI = p + (t * r);
-				auto distanceTemp = abs(Distance(p, tempI));
-				auto distanceI = abs(Distance(p, I));
-				//Check if closer than other intersected lines, if it is, replace stored line!
-				if (intersectedLine[0] == ZeroVector2 && intersectedLine[1] == ZeroVector2
-					|| distanceTemp < distanceI)
+				if (endPoint.x >= M.x && endPoint.x - M.x < closestDistance)
 				{
-					//Determine point with T and U
-					I = p + (t * r);
-					intersectedLine[0] = *it;
-					intersectedLine[1] = *next;
+					closestDistance = endPoint.x - M.x;
+					I = endPoint;
+					intersectedLine[0] = endPoint;
+					intersectedLine[1] = endPoint;
 				}
 			}
+			continue;
+		}
+
+		const float x = it->x + (M.y - it->y) * (next->x - it->x) / (next->y - it->y);
+		if (x >= M.x && x - M.x < closestDistance)
+		{
+			closestDistance = x - M.x;
+			I = Vector2(x, M.y);
+			intersectedLine[0] = *it;
+			intersectedLine[1] = *next;
 		}
 	}
 
 	//2.2 IF I is vertex of OUTER == mutually visisble so terminate algorithm
-	const auto IOuter = std::find(outer.m_vPoints.begin(), outer.m_vPoints.end(), I);
-	if (IOuter != outer.m_vPoints.end()) //Point is vertex of outer, so I is correct vertex!
+	if (I == intersectedLine[0] || I == intersectedLine[1])
 	{
-		pOuter = I;
+		pOuter = (I == intersectedLine[0]) ? intersectedLine[0] : intersectedLine[1];
 		return;
 	}
 
 	//2.3 ELSE I is interior point on edge, select vertex with maximum x value of the hitted edge - Result point P
-	Vector2 P = intersectedLine[(intersectedLine[0].x > intersectedLine[1].x ? 0 : 1)];
+	const Vector2 P = intersectedLine[(intersectedLine[0].x > intersectedLine[1].x ? 0 : 1)];
+	pOuter = P;
 
-	//2.4 Search for reflex vertices (excluding P if it's a reflex)
-	std::list<Vector2> reflexVertices;
+	//2.4 Search for reflex vertices (excluding P) inside triangle (M,I,P)
+	//2.5 IF there are none, P is mutually visible == terminate algorithm
+	//2.6 ELSE search for the reflex R that minimizes the angle between (1,0) and the line (M,R), closest one on equal angles
+	auto smallestAngle = 2 * M_PI;
+	auto smallestDistance = (std::numeric_limits<float>::max)();
 	for (auto it = outer.m_vPoints.begin(); it != outer.m_vPoints.end(); ++it)
 	{
-		if (*it == P)
+		if (*it == P || outer.IsConvexInPolygon(outer.m_vPoints, it))
+			continue;
+		if (!PointInTriangle(*it, M, I, P))
 			continue;
 
-		if (!outer.IsConvexInPolygon(outer.m_vPoints, it))
-			reflexVertices.push_back(*it);
-	}
-
-	//2.5 IF all reflex vertices are OUTSIDE of triangle (M,I,P), then P is mutually visible == terminate algorithm
-	std::vector<Vector2> pointsInTriangle;
-	for (auto it = reflexVertices.begin(); it != reflexVertices.end(); ++it)
-	{
-		if (PointInTriangle(*it, pInner, I, P))
-			pointsInTriangle.push_back(*it);
+		const Vector2 seg = *it - M;
+		const auto angle = acos(seg.x / seg.Magnitude());
+		const auto distance = seg.MagnitudeSquared();
+		if (angle < smallestAngle || (angle == smallestAngle && distance < smallestDistance))
+		{
+			smallestAngle = angle;
+			smallestDistance = distance;
+			pOuter = *it;
+		}
 	}
+}
 
-	if (pointsInTriangle.size() == 0)
+std::vector<Elite::Vector2>::iterator Elite::Polygon::FindBridgeVertex(const Vector2& pOuter, const Vector2& pInner)
+{
+	//After merging holes a position can occur more than once (both ends of a previous bridge). Pick the occurrence
+	//whose interior wedge contains the direction towards the inner vertex, else the new bridge crosses the old one.
+	const Vector2 direction = pInner - pOuter;
+	auto firstMatch = m_vPoints.end();
+	for (auto it = m_vPoints.begin(); it != m_vPoints.end(); ++it)
 	{
-		pOuter = P;
-		return;
-	}
+		if (*it != pOuter)
+			continue;
+		if (firstMatch == m_vPoints.end())
+			firstMatch = it;
 
-	//2.6 ELSE at least one reflex vertex lies in triangle (M,I,P). Search for reflex R that minimizes the angle
-	//between (1,0) and the line (M,R). If found more choose one, else use the one found and terminate algorithm
-	auto smallestAngle = 2 * M_PI;
-	for (const auto point : pointsInTriangle)
-	{
-		//Angle between r and (M,p)
-		Vector2 seg = point - p;
-		auto angle = acos((Dot(seg, r)) / (seg.Magnitude() * r.Magnitude()));
-		if (angle < smallestAngle)
-		{
-			smallestAngle = angle;
-			pOuter = point;
-		}
+		Vector2 current, prev, next;
+		GetTriangle(m_vPoints, it, current, prev, next);
+		const bool leftOfNext = Cross(next - current, direction) > 0.f; //Outer is CCW, interior on the left
+		const bool leftOfPrev = Cross(direction, prev - current) > 0.f;
+		const bool inWedge = IsConvex(current, prev, next) ? (leftOfNext && leftOfPrev) : (leftOfNext || leftOfPrev);
+		if (inWedge)
+			return it;
 	}
+	return firstMatch;
 }
 
 void Elite::Polygon::Split()
@@ -631,10 +1113,11 @@ void Elite::Polygon::Split()
 		Vector2 pInner, pOuter;
 		FindMutualVisibleVertices(*this, child, pOuter, pInner);
 		//Based on mutually visible vertices, merge meshes at the split
-		const auto itOuter = std::find(m_vPoints.begin(), m_vPoints.end(), pOuter); //Find where to start inserting
+		const auto itOuter = FindBridgeVertex(pOuter, pInner); //Find where to start inserting
 		const auto itInner = std::find(child.m_vPoints.begin(), child.m_vPoints.end(), pInner);
 		//insert child polygon vertices to outer starting from the found inner vertex
-		std::list<Vector2> mergeableChild;
+		std::vector<Vector2> mergeableChild;
+		mergeableChild.reserve(child.m_vPoints.size() + 2);
 		for (auto it = itInner; it != child.m_vPoints.end(); ++it)
 			mergeableChild.push_back(*it);
 		for (auto it = child.m_vPoints.begin(); it != itInner; ++it)
@@ -656,7 +1139,362 @@ void Elite::Polygon::Split()
 	//Remove all "old" children and replace with new vector
 	m_vChildren.clear();
 	m_vChildren = newChildren;
+	m_isCacheDirty = true;
 }
+
+#ifdef USE_TRIANGLE_METADATA
+void Elite::Polygon::GrowRegion(std::vector<int>& region, std::vector<bool>& inRegion) const
+{
+	//Add one ring of neighbouring triangles
+	const auto amountTriangles = region.size();
+	for (size_t i = 0; i < amountTriangles; ++i)
+	{
+		for (const auto neighbour : GetAdjacentTriangles(m_vpTriangles[region[i]]))
+		{
+			if (!inRegion[neighbour->metaData.IndexTriangle])
+			{
+				inRegion[neighbour->metaData.IndexTriangle] = true;
+				region.push_back(neighbour->metaData.IndexTriangle);
+			}
+		}
+	}
+}
+
+bool Elite::Polygon::GetRegionBoundary(const std::vector<int>& region, const std::vector<bool>& inRegion, const std::vector<Line>& ignoredEdges,
+	std::vector<Vector2>& boundary, std::vector<int>& boundaryLines) const
+{
+	//Edges of the region triangles without a region triangle on the other side (ignored edges left out).
+	//Triangles are CCW, so the edges are directed CCW around the region.
+	boundary.clear();
+	boundaryLines.clear();
+	std::vector<Line> edges;
+	int amountIgnored = 0;
+	for (const int triangleIdx : region)
+	{
+		const auto t = m_vpTriangles[triangleIdx];
+		const Vector2 points[3] = { t->p1, t->p2, t->p3 };
+		for (int i = 0; i < 3; ++i)
+		{
+			const int lineIdx = t->metaData.IndexLines[i];
+			const auto other = (m_vpLineTriangles[lineIdx * 2] == t) ? m_vpLineTriangles[lineIdx * 2 + 1] : m_vpLineTriangles[lineIdx * 2];
+			if (other && inRegion[other->metaData.IndexTriangle])
+				continue;
+
+			const Line edge(points[i], points[(i + 1) % 3], lineIdx);
+			if (std::find_if(ignoredEdges.begin(), ignoredEdges.end(), [&](const Line& l)
+				{ return l == edge || (l.p1 == edge.p2 && l.p2 == edge.p1); }) != ignoredEdges.end())
+			{
+				++amountIgnored;
+				continue;
+			}
+			edges.push_back(edge);
+		}
+	}
+	//Every ignored edge has to be on the region boundary
+	if (edges.size() < 3 || amountIgnored != static_cast<int>(ignoredEdges.size()))
+		return false;
+
+	//Chain the edges, a vertex used twice (touching loops) or more than one loop is not a simple polygon
+	for (size_t i = 0; i < edges.size(); ++i)
+	{
+		for (size_t j = i + 1; j < edges.size(); ++j)
+		{
+			if (edges[i].p1 == edges[j].p1)
+				return false;
+		}
+	}
+
+	size_t current = 0;
+	do
+	{
+		boundary.push_back(edges[current].p1);
+		boundaryLines.push_back(edges[current].index);
+		const auto next = std::find_if(edges.begin(), edges.end(), [&](const Line& l) { return l.p1 == edges[current].p2; });
+		if (next == edges.end())
+			return false;
+		current = next - edges.begin();
+	} while (current != 0 && boundary.size() <= edges.size());
+
+	return boundary.size() == edges.size();
+}
+
+void Elite::Polygon::ReplaceRegion(const std::vector<int>& region, const std::vector<int>& boundaryLines, const std::vector<Triangle*>& newTriangles, TriangulationPatch* pPatch)
+{
+	//Only the region, the lines and triangles packed into its free slots and the triangles across its boundary change.
+	//The rest of the mesh keeps its indices, adjacency and grid cells.
+	TriangulationPatch patch;
+	std::vector<int> freeTriangles = region;
+	std::sort(freeTriangles.begin(), freeTriangles.end());
+	const auto isInRegion = [&freeTriangles](const Triangle* t)
+	{ return std::binary_search(freeTriangles.begin(), freeTriangles.end(), t->metaData.IndexTriangle); };
+
+	//Grid cells of the region, the new triangles cover the same area
+	int colMin = m_GridCols, rowMin = m_GridRows, colMax = -1, rowMax = -1;
+	const auto addToCellRange = [&](const Triangle* t)
+	{
+		int triangleColMin, triangleRowMin, triangleColMax, triangleRowMax;
+		GetGridCellRange(t, triangleColMin, triangleRowMin, triangleColMax, triangleRowMax);
+		colMin = min(colMin, triangleColMin);
+		rowMin = min(rowMin, triangleRowMin);
+		colMax = max(colMax, triangleColMax);
+		rowMax = max(rowMax, triangleRowMax);
+	};
+
+	//The boundary lines stay (with the same index), only the triangle outside of the region is left on them.
+	//That triangle gets new neighbours.
+	std::vector<int> keptLines = boundaryLines;
+	std::sort(keptLines.begin(), keptLines.end());
+	std::vector<Triangle*> boundaryNeighbours;
+	for (const int lineIdx : keptLines)
+	{
+		Triangle** pLineTriangles = &m_vpLineTriangles[lineIdx * 2];
+		if (pLineTriangles[0] && isInRegion(pLineTriangles[0]))
+			std::swap(pLineTriangles[0], pLineTriangles[1]);
+		pLineTriangles[1] = nullptr;
+		if (pLineTriangles[0])
+			boundaryNeighbours.push_back(pLineTriangles[0]);
+	}
+
+	//Lines only used by the region triangles are freed
+	std::vector<int> freeLines;
+	for (const int triangleIdx : region)
+	{
+		const auto& lines = m_vpTriangles[triangleIdx]->metaData.IndexLines;
+		patch.RemovedTriangleLines.push_back(lines);
+		for (const int lineIdx : lines)
+		{
+			if (!std::binary_search(keptLines.begin(), keptLines.end(), lineIdx))
+				freeLines.push_back(lineIdx);
+		}
+		addToCellRange(m_vpTriangles[triangleIdx]);
+		SAFE_DELETE(m_vpTriangles[triangleIdx]);
+	}
+	std::sort(freeLines.begin(), freeLines.end());
+	freeLines.erase(std::unique(freeLines.begin(), freeLines.end()), freeLines.end());
+	for (const int lineIdx : freeLines)
+	{
+		SAFE_DELETE(m_vpLines[lineIdx]);
+		m_vpLineTriangles[lineIdx * 2] = nullptr;
+		m_vpLineTriangles[lineIdx * 2 + 1] = nullptr;
+	}
+	patch.RemovedLines = freeLines;
+
+	//Add the new triangles in the free slots. Their lines are either a boundary line or a new line (free index first).
+	std::vector<int> candidateLines = keptLines;
+	size_t amountFreeTrianglesUsed = 0;
+	size_t amountFreeLinesUsed = 0;
+	std::vector<Triangle*> addedTriangles;
+	std::vector<int> addedTriangleIndices;
+	addedTriangles.reserve(newTriangles.size());
+	addedTriangleIndices.reserve(newTriangles.size());
+	for (const auto pNewTriangle : newTriangles)
+	{
+		const auto t = new Triangle(pNewTriangle->p1, pNewTriangle->p2, pNewTriangle->p3);
+		addedTriangles.push_back(t);
+		if (amountFreeTrianglesUsed < freeTriangles.size())
+			t->metaData.IndexTriangle = freeTriangles[amountFreeTrianglesUsed++];
+		else
+		{
+			t->metaData.IndexTriangle = static_cast<int>(m_vpTriangles.size());
+			m_vpTriangles.push_back(nullptr);
+		}
+		m_vpTriangles[t->metaData.IndexTriangle] = t;
+		addedTriangleIndices.push_back(t->metaData.IndexTriangle);
+		addToCellRange(t);
+
+		const Vector2 points[3] = { t->p1, t->p2, t->p3 };
+		for (int i = 0; i < 3; ++i)
+		{
+			const Line edge(points[i], points[(i + 1) % 3]);
+			const Line edgeRev(edge.p2, edge.p1);
+			const auto it = std::find_if(candidateLines.begin(), candidateLines.end(), [&](int l)
+				{ return *m_vpLines[l] == edge || *m_vpLines[l] == edgeRev; });
+
+			int index;
+			if (it != candidateLines.end())
+				index = *it;
+			else if (amountFreeLinesUsed < freeLines.size())
+				index = freeLines[amountFreeLinesUsed++];
+			else
+			{
+				index = static_cast<int>(m_vpLines.size());
+				m_vpLines.push_back(nullptr);
+				m_vpLineTriangles.resize(m_vpLines.size() * 2, nullptr);
+			}
+			if (it == candidateLines.end())
+			{
+				m_vpLines[index] = new Line(edge.p1, edge.p2, index);
+				candidateLines.push_back(index);
+			}
+			t->metaData.IndexLines[i] = index;
+
+			Triangle** pLineTriangles = &m_vpLineTriangles[index * 2];
+			pLineTriangles[pLineTriangles[0] ? 1 : 0] = t;
+		}
+	}
+	const int amountTriangles = static_cast<int>(m_vpTriangles.size() + freeTriangles.size() - amountFreeTrianglesUsed);
+	const bool isGridOutdated = amountTriangles > 2 * m_GridAmountTriangles || 2 * amountTriangles < m_GridAmountTriangles;
+	if (!isGridOutdated)
+		UpdateTriangleGridCells(colMin, rowMin, colMax, rowMax, freeTriangles, addedTriangleIndices);
+
+	//Pack the triangles and lines again, unused slots are filled with the last ones
+	for (size_t i = amountFreeTrianglesUsed; i < freeTriangles.size(); ++i)
+	{
+		while (!m_vpTriangles.empty() && m_vpTriangles.back() == nullptr)
+			m_vpTriangles.pop_back();
+		const int to = freeTriangles[i];
+		if (to >= static_cast<int>(m_vpTriangles.size()))
+			break;
+
+		//Same neighbours (they point to the triangle, not to its index), only its grid entries are renumbered
+		const int from = static_cast<int>(m_vpTriangles.size()) - 1;
+		const auto t = m_vpTriangles[from];
+		m_vpTriangles[to] = t;
+		m_vpTriangles.pop_back();
+		t->metaData.IndexTriangle = to;
+		std::copy_n(&m_vpAdjacentTriangles[from * 3], 3, &m_vpAdjacentTriangles[to * 3]);
+		m_vAdjacentCount[to] = m_vAdjacentCount[from];
+		if (isGridOutdated)
+			continue;
+
+		int cellColMin, cellRowMin, cellColMax, cellRowMax;
+		GetGridCellRange(t, cellColMin, cellRowMin, cellColMax, cellRowMax);
+		for (int row = cellRowMin; row <= cellRowMax; ++row)
+		{
+			for (int col = cellColMin; col <= cellColMax; ++col)
+			{
+				//The triangle gets a lower index, it moves forward (with its batch entry) so the cell stays ascending
+				const int cellIdx = row * m_GridCols + col;
+				const auto cellBegin = m_vGridTriangles.begin() + m_vGridCellStart[cellIdx];
+				const auto cellEnd = m_vGridTriangles.begin() + m_vGridCellStart[cellIdx + 1];
+				const auto it = std::find(cellBegin, cellEnd, from);
+				if (it == cellEnd)
+					continue;
+				const auto insertIt = std::upper_bound(cellBegin, it, to);
+				*it = to;
+				std::rotate(insertIt, it, it + 1);
+				const int gridIdx = static_cast<int>(it - m_vGridTriangles.begin());
+				m_GridTriangleBatch.Rotate(static_cast<int>(insertIt - m_vGridTriangles.begin()), gridIdx, gridIdx + 1);
+			}
+		}
+	}
+	while (!m_vpTriangles.empty() && m_vpTriangles.back() == nullptr)
+		m_vpTriangles.pop_back();
+	m_vpAdjacentTriangles.resize(m_vpTriangles.size() * 3, nullptr);
+	m_vAdjacentCount.resize(m_vpTriangles.size(), 0);
+
+	for (size_t i = amountFreeLinesUsed; i < freeLines.size(); ++i)
+	{
+		while (!m_vpLines.empty() && m_vpLines.back() == nullptr)
+			m_vpLines.pop_back();
+		const int to = freeLines[i];
+		if (to >= static_cast<int>(m_vpLines.size()))
+			break;
+
+		//Only the (max two) triangles of the line refer to it
+		const int from = static_cast<int>(m_vpLines.size()) - 1;
+		m_vpLines[to] = m_vpLines[from];
+		m_vpLines[to]->index = to;
+		m_vpLines.pop_back();
+		for (int side = 0; side < 2; ++side)
+		{
+			const auto t = m_vpLineTriangles[from * 2 + side];
+			m_vpLineTriangles[to * 2 + side] = t;
+			if (t)
+				std::replace(t->metaData.IndexLines.begin(), t->metaData.IndexLines.end(), from, to);
+		}
+		patch.MovedLines.push_back({ from, to });
+	}
+	while (!m_vpLines.empty() && m_vpLines.back() == nullptr)
+		m_vpLines.pop_back();
+	m_vpLineTriangles.resize(m_vpLines.size() * 2);
+
+	//Neighbours of the new triangles, and the new neighbours of the triangles around the region
+	for (const auto t : addedTriangles)
+		UpdateAdjacentTriangles(t->metaData.IndexTriangle);
+	for (const auto t : boundaryNeighbours)
+		UpdateAdjacentTriangles(t->metaData.IndexTriangle);
+
+	if (isGridOutdated)
+		BuildTriangleGrid();
+
+	for (const auto t : addedTriangles)
+		patch.AddedTriangles.push_back(t->metaData.IndexTriangle);
+	if (pPatch)
+		*pPatch = std::move(patch);
+}
+
+void Elite::Polygon::UpdateTriangleGridCells(int colMin, int rowMin, int colMax, int rowMax, const std::vector<int>& removedTriangles, const std::vector<int>& addedTriangles)
+{
+	//The cells from (colMin, rowMin) up to (colMax, rowMax) are one range of the grid arrays (with the cells next to the rows in between).
+	//That range is built again without the removed triangles (sorted) and with the added ones, then swapped in.
+	if (colMin > colMax || rowMin > rowMax)
+		return;
+	const int firstCell = rowMin * m_GridCols + colMin;
+	const int lastCell = rowMax * m_GridCols + colMax;
+	const int rangeBegin = m_vGridCellStart[firstCell];
+	const int rangeEnd = m_vGridCellStart[lastCell + 1];
+
+	//Added triangles per cell, in the order of the cells
+	std::vector<std::pair<int, int>> addedCellTriangles;
+	int cellColMin, cellRowMin, cellColMax, cellRowMax;
+	for (const int triangleIdx : addedTriangles)
+	{
+		GetGridCellRange(m_vpTriangles[triangleIdx], cellColMin, cellRowMin, cellColMax, cellRowMax);
+		for (int row = cellRowMin; row <= cellRowMax; ++row)
+			for (int col = cellColMin; col <= cellColMax; ++col)
+				addedCellTriangles.push_back({ row * m_GridCols + col, triangleIdx });
+	}
+	std::sort(addedCellTriangles.begin(), addedCellTriangles.end());
+
+	std::vector<int> cellStart(lastCell - firstCell + 2, rangeBegin);
+	std::vector<int> gridTriangles;
+	TriangleBatch gridTriangleBatch;
+	gridTriangles.reserve(rangeEnd - rangeBegin + addedCellTriangles.size());
+	gridTriangleBatch.Reserve(gridTriangles.capacity());
+	auto added = addedCellTriangles.begin();
+	for (int cellIdx = firstCell; cellIdx <= lastCell; ++cellIdx)
+	{
+		cellStart[cellIdx - firstCell] = rangeBegin + static_cast<int>(gridTriangles.size());
+
+		//The kept and the added triangles are both ascending, merged the cell is too
+		int i = m_vGridCellStart[cellIdx];
+		const int cellEnd = m_vGridCellStart[cellIdx + 1];
+		while (true)
+		{
+			while (i < cellEnd && std::binary_search(removedTriangles.begin(), removedTriangles.end(), m_vGridTriangles[i]))
+				++i;
+			const bool hasKept = i < cellEnd;
+			const bool hasAdded = added != addedCellTriangles.end() && added->first == cellIdx;
+			if (hasKept && (!hasAdded || m_vGridTriangles[i] < added->second))
+			{
+				gridTriangles.push_back(m_vGridTriangles[i]);
+				gridTriangleBatch.Add({ m_GridTriangleBatch.tipX[i], m_GridTriangleBatch.tipY[i] }, { m_GridTriangleBatch.prevX[i], m_GridTriangleBatch.prevY[i] },
+					{ m_GridTriangleBatch.nextX[i], m_GridTriangleBatch.nextY[i] });
+				++i;
+			}
+			else if (hasAdded)
+			{
+				const Triangle* pT = m_vpTriangles[added->second];
+				gridTriangles.push_back(added->second);
+				gridTriangleBatch.Add(pT->p1, pT->p2, pT->p3);
+				++added;
+			}
+			else
+				break;
+		}
+	}
+
+	m_vGridTriangles.erase(m_vGridTriangles.begin() + rangeBegin, m_vGridTriangles.begin() + rangeEnd);
+	m_vGridTriangles.insert(m_vGridTriangles.begin() + rangeBegin, gridTriangles.begin(), gridTriangles.end());
+	m_GridTriangleBatch.Replace(rangeBegin, rangeEnd - rangeBegin, gridTriangleBatch);
+	for (int cellIdx = firstCell + 1; cellIdx <= lastCell; ++cellIdx)
+		m_vGridCellStart[cellIdx] = cellStart[cellIdx - firstCell];
+	const int amountAdded = static_cast<int>(gridTriangles.size()) - (rangeEnd - rangeBegin);
+	for (size_t cellIdx = lastCell + 1; cellIdx < m_vGridCellStart.size(); ++cellIdx)
+		m_vGridCellStart[cellIdx] += amountAdded;
+}
+#endif
 #pragma endregion //PrivateTriangulationFunctions
 //----------------------------------------------------------
 #pragma endregion //Polygon
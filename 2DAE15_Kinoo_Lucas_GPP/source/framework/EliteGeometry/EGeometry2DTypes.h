@@ -8,7 +8,9 @@
 #define	ELITE_GEOMETRY_TYPES
 
 #include "EGeometry2DUtilities.h"
+#include "EGeometry2DBatchUtilities.h"
 #include <array>
+#include "../EliteHelpers/ESpan.h"
 
 namespace Elite
 {
@@ -51,6 +53,7 @@ namespace Elite
 	struct TriangleMetaData final
 	{
 		std::array<int, 3> IndexLines{ {-1, -1, -1} };
+		int IndexTriangle = -1; //Index in the triangles of the owning polygon
 	};
 
 	struct Triangle final
@@ -87,6 +90,16 @@ namespace Elite
 #pragma endregion //Triangle
 
 #pragma region Polygon
+	//Changes made by a local re-triangulation (InsertHole/RemoveHole). Line indices are the ones from before the patch,
+	//except for the AddedTriangles, those are triangle indices after the patch.
+	struct TriangulationPatch final
+	{
+		std::vector<std::array<int, 3>> RemovedTriangleLines; //Lines of every removed triangle
+		std::vector<int> RemovedLines; //Lines no longer in the mesh, their index can be reused by new lines
+		std::vector<std::pair<int, int>> MovedLines; //Lines moved to another index to keep the lines packed (from, to)
+		std::vector<int> AddedTriangles;
+	};
+
 	class Polygon final
 	{
 	public:
@@ -109,8 +122,9 @@ namespace Elite
 
 		//Member access
 		bool IsTriangulated() const;
+		bool IsTriangulatedCompletely() const; //False when the last Triangulate() got stuck, its triangles cover part of the polygon
 		int GetAmountVertices() const;
-		const std::list<Vector2>& GetPoints() const;
+		const std::vector<Vector2>& GetPoints() const;
 		const std::vector<Polygon>& GetChildren() const;
 		const std::vector<Triangle*>& GetTriangles() const;
 		const std::vector<Line*>& GetLines() const;
@@ -122,18 +136,25 @@ namespace Elite
 		float GetPosVertMinYPos() const;
 		bool OverlappingXAxis(const Polygon& poly) const;
 		bool OverlappingYAxis(const Polygon& poly) const;
-		std::vector<Triangle*> GetAdjacentTriangles(const Triangle* t) const;
-		std::vector<Triangle*> GetAdjacentTrianglesOnLine(const Triangle* t, const Line& l) const;
+		Span<Triangle* const> GetAdjacentTriangles(const Triangle* t) const;
+		Span<Triangle* const> GetAdjacentTrianglesOnLine(const Triangle* t, const Line& l) const;
 
 		const Triangle* GetTriangleFromPosition(const Vector2& position, bool onLineAllowed = false) const;
+		void LocateTriangles(const Vector2* positions, int count, const Triangle** pTriangles, bool onLineAllowed = false) const;
 #ifdef USE_TRIANGLE_METADATA
-		const std::vector<const Triangle*> GetTrianglesFromLineIndex(unsigned int lineIndex) const;
+		Span<const Triangle* const> GetTrianglesFromLineIndex(unsigned int lineIndex) const;
 #endif
 
 		//Triangulation functions
 		const std::vector<Triangle*>& Triangulate();
 		void OrientateWithChildren(Winding winding);
-		void ExpandShape(float amount);
+		void ExpandShape(float amount, float miterLimit = 2.0f); //Corners sharper than miterLimit * amount get bevelled
+#ifdef USE_TRIANGLE_METADATA
+		//Add or remove a hole in an already triangulated polygon, only the triangles around the hole are triangulated again.
+		//Returns false (nothing changed) when the hole overlaps the border or other holes, Triangulate() again in that case.
+		bool InsertHole(const Polygon& hole, TriangulationPatch* pPatch = nullptr);
+		bool RemoveHole(const Polygon& hole, TriangulationPatch* pPatch = nullptr);
+#endif
 
 		//=== Operators ===
 		bool operator ==(const Polygon& b) const
@@ -144,21 +165,61 @@ namespace Elite
 	private:
 		//=== Datamembers ===
 		std::vector<Polygon> m_vChildren; //Inner shapes of this polygon
-		std::list<Vector2> m_vPoints; //Points that define this polygon
+		std::vector<Vector2> m_vPoints; //Points that define this polygon
 		std::vector<Triangle*> m_vpTriangles; //Triangles create for this polygon, used for rendering
 		std::vector<Line*> m_vpLines; //Lines constructing this polygon!
 		bool m_isTriangulated = false;
+		bool m_isTriangulatedCompletely = false;
+
+		//Cached information of the points, recalculated on first use after the points changed
+		mutable Vector2 m_BoundsMin = {};
+		mutable Vector2 m_BoundsMax = {};
+		mutable Vector2 m_CenterPoint = {};
+		mutable bool m_isCacheDirty = true;
+
+		//Adjacency tables, filled when generating the line matrix
+		std::vector<Triangle*> m_vpLineTriangles; //Two triangles per line, second one is nullptr on border lines
+		std::vector<Triangle*> m_vpAdjacentTriangles; //Three slots per triangle, neighbours packed at the front
+		std::vector<int> m_vAdjacentCount; //Amount of neighbours per triangle
+
+		//Uniform grid over the triangles, used for point location. Cells store triangle indices (CSR layout)
+		Vector2 m_GridOrigin = {};
+		float m_GridInvCellSize = 0.f;
+		int m_GridCols = 0;
+		int m_GridRows = 0;
+		static constexpr float GridPadding = 1e-3f; //Around the triangles, so positions on the outer edges (onLineAllowed) still map onto a cell
+		int m_GridAmountTriangles = 0; //The cell size is made for this amount, the grid is built again when the triangles doubled or halved
+		std::vector<int> m_vGridCellStart; //Offset of each cell in m_vGridTriangles (amount cells + 1)
+		std::vector<int> m_vGridTriangles; //Triangle indices, sorted per cell
+		TriangleBatch m_GridTriangleBatch; //Corners of the triangles in m_vGridTriangles, so a whole cell is tested at once
 
 		//=== Functions ===
 		//Private General Functions
-		void GetTriangle(const std::list<Vector2>& l, const std::list<Vector2>::const_iterator p, Vector2& currentTip, Vector2& previous, Vector2& next) const;
-		bool IsConvexInPolygon(const std::list<Vector2>& l, const std::list<Vector2>::const_iterator p) const;
-		bool IsEar(const std::list<Vector2>& l, const std::list<Vector2>::const_iterator p) const;
+		void GetTriangle(const std::vector<Vector2>& l, const std::vector<Vector2>::const_iterator p, Vector2& currentTip, Vector2& previous, Vector2& next) const;
+		bool IsConvexInPolygon(const std::vector<Vector2>& l, const std::vector<Vector2>::const_iterator p) const;
+		bool EarClip(const std::vector<Vector2>& vertices, std::vector<std::array<int, 3>>& triangles) const; //False when it got stuck, the triangles cover part of the polygon
+		void FlipToDelaunay(const std::vector<Vector2>& vertices, std::vector<std::array<int, 3>>& triangles) const;
 		void GenerateLineMatrix();
+		void BuildAdjacency();
+		void UpdateAdjacentTriangles(int triangleIdx); //From the triangles of its lines
+		void BuildTriangleGrid();
+		void GetGridCellRange(const Triangle* pTriangle, int& colMin, int& rowMin, int& colMax, int& rowMax) const; //Cells (inclusive) covered by its bounding box
+		void UpdateCachedData() const;
+		int GetGridCellIndex(const Vector2& position) const;
 
 		//Private Triangulation Functions
 		void FindMutualVisibleVertices(const Polygon& outer, const Polygon& inner, Vector2& pOuter, Vector2& pInner);
+		std::vector<Vector2>::iterator FindBridgeVertex(const Vector2& pOuter, const Vector2& pInner);
 		void Split();
+
+#ifdef USE_TRIANGLE_METADATA
+		//Private Local Triangulation Functions
+		void GrowRegion(std::vector<int>& region, std::vector<bool>& inRegion) const;
+		bool GetRegionBoundary(const std::vector<int>& region, const std::vector<bool>& inRegion, const std::vector<Line>& ignoredEdges,
+			std::vector<Vector2>& boundary, std::vector<int>& boundaryLines) const;
+		void ReplaceRegion(const std::vector<int>& region, const std::vector<int>& boundaryLines, const std::vector<Triangle*>& newTriangles, TriangulationPatch* pPatch);
+		void UpdateTriangleGridCells(int colMin, int rowMin, int colMax, int rowMax, const std::vector<int>& removedTriangles, const std::vector<int>& addedTriangles);
+#endif
 	};
 #pragma endregion //Polygon
 
@@ -35,12 +35,14 @@ namespace Elite
 		//	2-------1		 1-------2			 3-------2
 		//	   ??				CCW				    CW
 
-		auto signArea = 0;
+		//Include the closing edge (last -> first), else the result depends on where the shape starts
+		auto signArea = 0.f;
 		for (auto it = shape.begin(); it != shape.end(); ++it)
 		{
 			auto next = std::next(it);
-			if (next != shape.end())
-				signArea += static_cast<int>((next->x - it->x) * (next->y + it->y));
+			if (next == shape.end())
+				next = shape.begin();
+			signArea += (next->x - it->x) * (next->y + it->y);
 		}
 		if (signArea >= 0)
 			return CW;
@@ -123,6 +125,103 @@ namespace Elite
 		}
 		return true;
 	}
+	/*! Check if point lies strictly inside the circumcircle of a CCW triangle. Used to decide Delaunay edge flips. */
+	inline bool IsPointInCircumcircle(const Vector2& point, const Vector2& a, const Vector2& b, const Vector2& c)
+	{
+		//https://en.wikipedia.org/wiki/Delaunay_triangulation#Algorithms
+		//Work in doubles, relative to the point, to keep the determinant stable for large coordinates
+		const double adx = a.x - point.x, ady = a.y - point.y;
+		const double bdx = b.x - point.x, bdy = b.y - point.y;
+		const double cdx = c.x - point.x, cdy = c.y - point.y;
+		const double ad = adx * adx + ady * ady;
+		const double bd = bdx * bdx + bdy * bdy;
+		const double cd = cdx * cdx + cdy * cdy;
+		const double det = ad * (bdx * cdy - cdx * bdy) - bd * (adx * cdy - cdx * ady) + cd * (adx * bdy - bdx * ady);
+
+		//Relative tolerance, so (almost) cocircular points (rectangles!) never cause flip cycles
+		const double scale = (ad + bd + cd) * (ad + bd + cd);
+		return det > 1e-9 * scale;
+	}
+	/*! Check if two segments intersect. Touching (shared points, collinear overlap) counts as intersecting. */
+	inline bool AreSegmentsIntersecting(const Vector2& a1, const Vector2& a2, const Vector2& b1, const Vector2& b2)
+	{
+		//https://www.geeksforgeeks.org/check-if-two-given-line-segments-intersect/
+		const auto orientation = [](const Vector2& p, const Vector2& q, const Vector2& r)
+		{
+			const auto cross = Cross(q - p, r - p);
+			return (cross > 0.f) ? 1 : ((cross < 0.f) ? -1 : 0);
+		};
+		const auto onSegment = [](const Vector2& p, const Vector2& q, const Vector2& r) //r on segment pq, if collinear
+		{
+			return min(p.x, q.x) <= r.x && r.x <= max(p.x, q.x) && min(p.y, q.y) <= r.y && r.y <= max(p.y, q.y);
+		};
+
+		const auto o1 = orientation(a1, a2, b1);
+		const auto o2 = orientation(a1, a2, b2);
+		const auto o3 = orientation(b1, b2, a1);
+		const auto o4 = orientation(b1, b2, a2);
+
+		if (o1 != o2 && o3 != o4)
+			return true;
+		return (o1 == 0 && onSegment(a1, a2, b1)) || (o2 == 0 && onSegment(a1, a2, b2))
+			|| (o3 == 0 && onSegment(b1, b2, a1)) || (o4 == 0 && onSegment(b1, b2, a2));
+	}
+	/*! Check if a point is inside a polygon (even-odd rule), the winding of the container does not matter. */
+	template<typename container>
+	bool IsPointInPolygon(const container& shape, const Vector2& point)
+	{
+		//https://wrf.ecse.rpi.edu/Research/Short_Notes/pnpoly.html
+		auto isInside = false;
+		for (auto it = shape.begin(); it != shape.end(); ++it)
+		{
+			auto next = std::next(it);
+			if (next == shape.end())
+				next = shape.begin();
+			if ((it->y > point.y) != (next->y > point.y)
+				&& point.x < (next->x - it->x) * (point.y - it->y) / (next->y - it->y) + it->x)
+				isInside = !isInside;
+		}
+		return isInside;
+	}
+	/*! Clip a polygon against an axis aligned rectangle (Sutherland-Hodgman). Exact for convex polygons, concave ones can get zero width parts along the border.
+	The intersection with a border only depends on the clipped edge, not on its direction, so neighbouring rectangles get the same border points. */
+	inline std::vector<Vector2> ClipPolygonToRect(const std::vector<Vector2>& shape, const Vector2& rectMin, const Vector2& rectMax)
+	{
+		//https://en.wikipedia.org/wiki/Sutherland%E2%80%93Hodgman_algorithm
+		std::vector<Vector2> output = shape;
+		std::vector<Vector2> input;
+		for (int border = 0; border < 4 && !output.empty(); ++border)
+		{
+			const auto axis = border % 2; //0 = x, 1 = y
+			const auto value = (border < 2) ? (axis == 0 ? rectMin.x : rectMin.y) : (axis == 0 ? rectMax.x : rectMax.y);
+			const auto isInside = [&](const Vector2& p) { const auto c = axis == 0 ? p.x : p.y; return border < 2 ? c >= value : c <= value; };
+			const auto intersect = [&](Vector2 p, Vector2 q)
+			{
+				if (q.x < p.x || (q.x == p.x && q.y < p.y))
+					std::swap(p, q);
+				if (axis == 0)
+					return Vector2{ value, p.y + (q.y - p.y) * (value - p.x) / (q.x - p.x) };
+				return Vector2{ p.x + (q.x - p.x) * (value - p.y) / (q.y - p.y), value };
+			};
+
+			input.swap(output);
+			output.clear();
+			for (size_t i = 0; i < input.size(); ++i)
+			{
+				const auto& current = input[i];
+				const auto& previous = input[(i + input.size() - 1) % input.size()];
+				if (isInside(current))
+				{
+					if (!isInside(previous))
+						output.push_back(intersect(previous, current));
+					output.push_back(current);
+				}
+				else if (isInside(previous))
+					output.push_back(intersect(previous, current));
+			}
+		}
+		return output;
+	}
 	/*! Check if point is on a line */
 	inline auto IsPointOnLine(const Vector2& lineStart, const Vector2& lineEnd, const Vector2& point)
 	{
@@ -0,0 +1,94 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// ESimd.h: The SIMD lanes of the ELITE_SIMD_ instruction set (see EGeometry2DBatchUtilities.h),
+// shared by the batched functions. Only include it in source files, it pulls in the intrinsics.
+/*=============================================================================*/
+#ifndef ELITE_SIMD
+#define ELITE_SIMD
+
+#include "EGeometry2DBatchUtilities.h" //ELITE_SIMD_ defines
+
+#if defined(ELITE_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(ELITE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace Elite
+{
+	//A float or unsigned int per lane. The operations are the plain IEEE ones, so a lane gives exactly the result of the scalar
+	//code doing the same operations in the same order.
+#if defined(ELITE_SIMD_AVX2)
+	struct Simd final
+	{
+		using Float = __m256;
+		using Int = __m256i;
+		static const int Width = 8;
+
+		//=== Float ===
+		static Float Set(float f) { return _mm256_set1_ps(f); }
+		static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+		static void Store(float* p, Float f) { _mm256_storeu_ps(p, f); }
+		static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+		static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+		static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+		static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+		static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+		static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+		static Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static Float LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static Float Or(Float a, Float b) { return _mm256_or_ps(a, b); }
+		static Float Select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+		static int Bits(Float mask) { return _mm256_movemask_ps(mask); }
+
+		//=== Int ===
+		static Int SetInt(unsigned int i) { return _mm256_set1_epi32(static_cast<int>(i)); }
+		static Int Counters(unsigned int first) { return _mm256_add_epi32(SetInt(first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+		static Int Add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+		static Int Xor(Int a, Int b) { return _mm256_xor_si256(a, b); }
+		static Int Mul(Int a, Int b) { return _mm256_mullo_epi32(a, b); }
+		template<int Bits> static Int ShiftRight(Int a) { return _mm256_srli_epi32(a, Bits); }
+		static Float ToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+	};
+#elif defined(ELITE_SIMD_SSE2)
+	struct Simd final
+	{
+		using Float = __m128;
+		using Int = __m128i;
+		static const int Width = 4;
+
+		//=== Float ===
+		static Float Set(float f) { return _mm_set1_ps(f); }
+		static Float Load(const float* p) { return _mm_loadu_ps(p); }
+		static void Store(float* p, Float f) { _mm_storeu_ps(p, f); }
+		static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+		static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+		static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+		static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+		static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+		static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+		static Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+		static Float LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+		static Float Or(Float a, Float b) { return _mm_or_ps(a, b); }
+		static Float Select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+		static int Bits(Float mask) { return _mm_movemask_ps(mask); }
+
+		//=== Int ===
+		static Int SetInt(unsigned int i) { return _mm_set1_epi32(static_cast<int>(i)); }
+		static Int Counters(unsigned int first) { return _mm_add_epi32(SetInt(first), _mm_setr_epi32(0, 1, 2, 3)); }
+		static Int Add(Int a, Int b) { return _mm_add_epi32(a, b); }
+		static Int Xor(Int a, Int b) { return _mm_xor_si128(a, b); }
+		static Int Mul(Int a, Int b) //No 32 bit multiply in SSE2, multiply the even and odd lanes to 64 bit and keep the low halves
+		{
+			const Int even = _mm_mul_epu32(a, b);
+			const Int odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		}
+		template<int Bits> static Int ShiftRight(Int a) { return _mm_srli_epi32(a, Bits); }
+		static Float ToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+	};
+#endif
+}
+#endif
@@ -0,0 +1,90 @@
+//=== General Includes ===
+#include "stdafx.h"
+#include "EJobSystem.h"
+
+//=== Constructors & Destructors ===
+Elite::JobSystem::JobSystem()
+{
+	//One thread per core, the calling thread is one of them
+	const int nrWorkers = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+	for (int i = 0; i < nrWorkers; ++i)
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+}
+
+Elite::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsShuttingDown = true;
+	}
+	m_WakeCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+}
+
+//=== Job Functions ===
+void Elite::JobSystem::ParallelFor(int count, int blockSize, const std::function<void(int begin, int end, int threadIdx)>& job)
+{
+	blockSize = max(blockSize, 1);
+	if (count <= 0)
+		return;
+
+	//Not worth waking the workers for one block
+	if (m_Workers.empty() || count <= blockSize)
+	{
+		for (int begin = 0; begin < count; begin += blockSize)
+			job(begin, min(begin + blockSize, count), 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_pJob = &job;
+		m_Count = count;
+		m_BlockSize = blockSize;
+		m_NextBlock = 0;
+		m_NrBusyWorkers = static_cast<int>(m_Workers.size());
+		++m_Generation;
+	}
+	m_WakeCondition.notify_all();
+
+	RunBlocks(0);
+
+	//Every worker has to be done, also the ones that didn't get a block, before the job can go out of scope
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_DoneCondition.wait(lock, [this]() { return m_NrBusyWorkers == 0; });
+	m_pJob = nullptr;
+}
+
+//=== Internal Functions ===
+void Elite::JobSystem::WorkerLoop(int threadIdx)
+{
+	unsigned int generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WakeCondition.wait(lock, [this, generation]() { return m_IsShuttingDown || m_Generation != generation; });
+			if (m_IsShuttingDown)
+				return;
+			generation = m_Generation;
+		}
+
+		RunBlocks(threadIdx);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (--m_NrBusyWorkers == 0)
+			m_DoneCondition.notify_one();
+	}
+}
+
+void Elite::JobSystem::RunBlocks(int threadIdx)
+{
+	const int nrBlocks = (m_Count + m_BlockSize - 1) / m_BlockSize;
+	for (int block = m_NextBlock++; block < nrBlocks; block = m_NextBlock++)
+	{
+		const int begin = block * m_BlockSize;
+		(*m_pJob)(begin, min(begin + m_BlockSize, m_Count), threadIdx);
+	}
+}
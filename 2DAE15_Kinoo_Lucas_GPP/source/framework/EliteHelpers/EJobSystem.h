@@ -0,0 +1,60 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// EJobSystem.h: persistent worker threads to run data parallel loops.
+/*=============================================================================*/
+#ifndef ELITE_JOB_SYSTEM
+#define	ELITE_JOB_SYSTEM
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Elite
+{
+	class JobSystem final : public ESingleton<JobSystem>
+	{
+	public:
+		//=== Constructors & Destructors ===
+		~JobSystem();
+
+		//=== Job Functions ===
+		//Amount of threads that run jobs (the workers and the calling thread), the range of the thread index passed to a job
+		int GetNrOfThreads() const { return static_cast<int>(m_Workers.size()) + 1; }
+
+		//Splits [0, count) in blocks of blockSize and calls job(begin, end, threadIdx) for every block, spread over the threads.
+		//The calling thread works along and the function returns once all blocks are done. Blocks are taken in order but finish in any order,
+		//so jobs should only write data of their own block (or of their thread index). Not reentrant, jobs can't call ParallelFor.
+		void ParallelFor(int count, int blockSize, const std::function<void(int begin, int end, int threadIdx)>& job);
+
+	private:
+		//=== Constructors & Destructors ===
+		friend class ESingleton<JobSystem>;
+		JobSystem();
+
+		//=== Datamembers ===
+		std::vector<std::thread> m_Workers = {};
+		std::mutex m_Mutex = {};
+		std::condition_variable m_WakeCondition = {};
+		std::condition_variable m_DoneCondition = {};
+		unsigned int m_Generation = 0; //Increased for every ParallelFor, wakes the workers
+		int m_NrBusyWorkers = 0;
+		bool m_IsShuttingDown = false;
+
+		const std::function<void(int, int, int)>* m_pJob = nullptr;
+		int m_Count = 0;
+		int m_BlockSize = 1;
+		std::atomic<int> m_NextBlock{ 0 };
+
+		//=== Internal Functions ===
+		void WorkerLoop(int threadIdx);
+		void RunBlocks(int threadIdx);
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+	};
+}
+#endif
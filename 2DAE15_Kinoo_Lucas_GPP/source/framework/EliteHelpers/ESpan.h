@@ -0,0 +1,35 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// ESpan.h: non owning view over a contiguous range of elements (std::span is C++20).
+/*=============================================================================*/
+#ifndef ELITE_SPAN
+#define	ELITE_SPAN
+
+namespace Elite
+{
+	template<typename T>
+	class Span final
+	{
+	public:
+		//=== Constructors ===
+		Span() = default;
+		Span(T* pData, int size) : m_pData(pData), m_Size(size) {}
+
+		//=== Member Access ===
+		T* begin() const { return m_pData; }
+		T* end() const { return m_pData + m_Size; }
+		T* data() const { return m_pData; }
+		int size() const { return m_Size; }
+		bool empty() const { return m_Size == 0; }
+
+		T& operator[](int index) const { return m_pData[index]; }
+
+	private:
+		//=== Datamembers ===
+		T* m_pData = nullptr;
+		int m_Size = 0;
+	};
+}
+#endif
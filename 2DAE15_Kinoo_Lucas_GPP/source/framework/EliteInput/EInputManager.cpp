@@ -46,3 +46,113 @@ bool EInputManager::IsMousePresent(InputType type, InputState state, InputMouseB
 		});
 	return (result != m_InputContainer.end());
 }
+
+//=== Update Steps ===
+void EInputManager::BeginUpdateStep()
+{
+	if (m_IsWindowInputTaken)
+		m_InputContainer.clear();
+	m_IsWindowInputTaken = true;
+
+	if (IsReplaying())
+	{
+		m_InputContainer.clear();
+		if (!HasReplayEnded())
+		{
+			const int begin{ m_ReplayStep > 0 ? m_RecordedStepEnds[m_ReplayStep - 1] : 0 };
+			m_InputContainer.insert(m_InputContainer.end(), m_RecordedActions.begin() + begin, m_RecordedActions.begin() + m_RecordedStepEnds[m_ReplayStep]);
+			++m_ReplayStep;
+		}
+	}
+	else if (m_IsRecording)
+	{
+		m_RecordedActions.insert(m_RecordedActions.end(), m_InputContainer.begin(), m_InputContainer.end());
+		m_RecordedStepEnds.push_back(static_cast<int>(m_RecordedActions.size()));
+	}
+}
+
+//=== Recording & Replay ===
+namespace
+{
+	//Binary file: header, the step ends, the actions. The actions are stored as they are in memory,
+	//the size of an action in the header rejects recordings of a build with another layout.
+	struct RecordingHeader
+	{
+		char id[4] = { 'E', 'I', 'R', 'C' };
+		unsigned int version = 1;
+		unsigned int actionSize = sizeof(InputAction);
+		EInputManager::SessionSettings settings;
+		int nrOfSteps = 0;
+		int nrOfActions = 0;
+	};
+}
+
+void EInputManager::StartRecording(const SessionSettings& settings)
+{
+	m_RecordedActions.clear();
+	m_RecordedStepEnds.clear();
+	m_RecordedSettings = settings;
+	m_ReplayStep = -1;
+	m_IsRecording = true;
+}
+
+bool EInputManager::SaveRecording(const std::string& filePath) const
+{
+	std::ofstream file{ filePath, std::ios::out | std::ios::binary };
+	if (!file)
+		return false;
+
+	RecordingHeader header{};
+	header.settings = m_RecordedSettings;
+	header.nrOfSteps = GetNrOfRecordedSteps();
+	header.nrOfActions = static_cast<int>(m_RecordedActions.size());
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_RecordedStepEnds.data()), m_RecordedStepEnds.size() * sizeof(int));
+	file.write(reinterpret_cast<const char*>(m_RecordedActions.data()), m_RecordedActions.size() * sizeof(InputAction));
+	return file.good();
+}
+
+bool EInputManager::StartReplay(const std::string& filePath, SessionSettings& settings)
+{
+	std::ifstream file{ filePath, std::ios::in | std::ios::binary };
+	if (!file)
+		return false;
+
+	const RecordingHeader expected{};
+	RecordingHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || !std::equal(std::begin(header.id), std::end(header.id), std::begin(expected.id))
+		|| header.version != expected.version || header.actionSize != expected.actionSize || header.nrOfSteps < 0 || header.nrOfActions < 0)
+		return false;
+
+	std::vector<int> stepEnds(header.nrOfSteps);
+	file.read(reinterpret_cast<char*>(stepEnds.data()), stepEnds.size() * sizeof(int));
+
+	std::vector<InputAction> actions;
+	actions.reserve(header.nrOfActions);
+	InputAction action{ eDefault, eDown, KeyboardData{} };
+	for (int actionIdx{ 0 }; actionIdx < header.nrOfActions && file; ++actionIdx)
+	{
+		file.read(reinterpret_cast<char*>(&action), sizeof(InputAction));
+		actions.push_back(action);
+	}
+	if (!file)
+		return false;
+
+	//Step ends have to go up and stay within the actions
+	int previousEnd{ 0 };
+	for (int end : stepEnds)
+	{
+		if (end < previousEnd || end > header.nrOfActions)
+			return false;
+		previousEnd = end;
+	}
+
+	m_RecordedActions = std::move(actions);
+	m_RecordedStepEnds = std::move(stepEnds);
+	m_RecordedSettings = header.settings;
+	m_IsRecording = false;
+	m_ReplayStep = 0;
+	settings = header.settings;
+	return true;
+}
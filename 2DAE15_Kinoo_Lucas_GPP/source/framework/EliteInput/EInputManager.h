@@ -27,6 +27,30 @@ namespace Elite
 		bool IsMouseMoving() { return IsMousePresent(eMouseMotion); }
 		MouseData GetMouseData(InputType type, InputMouseButton button = InputMouseButton(0));
 
+		//=== Update Steps ===
+		//Called by the main loop before every update of the app. The first step after the window procedure gets the input of the window,
+		//other steps of the same frame get none, so no event is handled twice. Then the input of the step is recorded or replaced by the replay.
+		void BeginUpdateStep();
+
+		//=== Recording & Replay ===
+		//The settings a session ran with, stored with its recording. A replay with the same settings gives the same input to the same steps.
+		struct SessionSettings
+		{
+			unsigned int randomSeed = 0;
+			float fixedDeltaT = 0.f;
+		};
+
+		void StartRecording(const SessionSettings& settings);
+		void StopRecording() { m_IsRecording = false; }
+		bool IsRecording() const { return m_IsRecording; }
+		bool SaveRecording(const std::string& filePath) const;
+
+		//Loads the recording and replays it from the next step on, false if the file isn't a recording
+		bool StartReplay(const std::string& filePath, SessionSettings& settings);
+		bool IsReplaying() const { return m_ReplayStep >= 0; }
+		bool HasReplayEnded() const { return m_ReplayStep >= GetNrOfRecordedSteps(); }
+		int GetNrOfRecordedSteps() const { return static_cast<int>(m_RecordedStepEnds.size()); }
+
 	private:
 		//=== Friends ===
 		//Our window has access to add input events to our queue, our application can later use these events
@@ -35,7 +59,12 @@ namespace Elite
 #endif
 
 		//=== Internal Functions
-		void Flush() { m_InputContainer.clear(); };
+		void Flush() //Input no step has seen yet is kept
+		{
+			if (m_IsWindowInputTaken)
+				m_InputContainer.clear();
+			m_IsWindowInputTaken = false;
+		};
 		void AddInputAction(const InputAction& inputAction)
 		{
 			m_InputContainer.push_back(inputAction);
@@ -46,6 +75,13 @@ namespace Elite
 
 		//=== Datamembers ===
 		std::vector<InputAction> m_InputContainer;
+		bool m_IsWindowInputTaken = true;
+
+		std::vector<InputAction> m_RecordedActions;
+		std::vector<int> m_RecordedStepEnds; //The actions of step i end at m_RecordedStepEnds[i] in m_RecordedActions
+		SessionSettings m_RecordedSettings;
+		bool m_IsRecording = false;
+		int m_ReplayStep = -1; //Next step to replay, -1 when not replaying
 	};
 }
 #endif
@@ -10,6 +10,8 @@
 #include <cstdlib>
 #include <cfloat>
 #include <type_traits>
+//Elite includes
+#include "ERandom.h"
 
 namespace Elite {
 	/* --- CONSTANTS --- */
@@ -91,23 +93,22 @@ namespace Elite {
 		return a;
 	}
 
-	/*! Random Integer */
+	/*! Random Integer in [0, max), from the random stream of the calling thread (see SetRandomSeed) */
 	inline int randomInt(int max = 1)
 	{
-		return rand() % max;
+		return GetRandomStream().NextInt(max);
 	}
 
-	/*! Random Float */
+	/*! Random Float in [0, max) */
 	inline float randomFloat(float max = 1.f)
 	{
-		return max * (float(rand()) / RAND_MAX);
+		return max * GetRandomStream().NextFloat();
 	}
 
-	/*! Random Float */
+	/*! Random Float in [min, max) */
 	inline float randomFloat(float min, float max)
 	{
-		auto range = max - min;
-		return (range * (float(rand()) / RAND_MAX)) + min;
+		return GetRandomStream().NextFloat(min, max);
 	}
 
 	/*! Random Binomial Float */
@@ -0,0 +1,94 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// ERandom.cpp: Implementation of the random streams and the global seed.
+/*=============================================================================*/
+#include "stdafx.h"
+#include "ERandom.h"
+#include "framework/EliteGeometry/ESimd.h"
+#include <atomic>
+
+namespace
+{
+	std::atomic<unsigned int> g_Seed{ 0 };
+	std::atomic<unsigned int> g_SeedGeneration{ 1 }; //Increased by every SetRandomSeed, thread streams restart when it changed
+	std::atomic<unsigned int> g_NrOfThreadStreams{ 0 };
+
+	//Spreads the bits of a seed, so neighboring seeds and streams get unrelated keys
+	unsigned int MixKey(unsigned int x)
+	{
+		x ^= x >> 16;
+		x *= 0x7feb352du;
+		x ^= x >> 15;
+		x *= 0x846ca68bu;
+		x ^= x >> 16;
+		return x;
+	}
+}
+
+//=== RandomStream ===
+void Elite::RandomStream::Seed(unsigned int seed, unsigned int stream /*= 0*/)
+{
+	m_Key0 = MixKey(seed ^ 0x9e3779b9u);
+	m_Key1 = MixKey(m_Key0 ^ MixKey(stream + 0x632be5abu));
+	m_Counter = 0;
+}
+
+void Elite::RandomStream::FillFloats(float* pValues, int count, float min /*= 0.f*/, float max /*= 1.f*/)
+{
+	int idx{ 0 };
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	const float range{ max - min };
+	const Simd::Int key0{ Simd::SetInt(m_Key0) };
+	const Simd::Int key1{ Simd::SetInt(m_Key1) };
+	const Simd::Int multiplier0{ Simd::SetInt(0x21f0aaadu) };
+	const Simd::Int multiplier1{ Simd::SetInt(0xd35a2d97u) };
+	const Simd::Float toUnit{ Simd::Set(1.f / 16777216.f) };
+	const Simd::Float minimum{ Simd::Set(min) };
+	const Simd::Float scale{ Simd::Set(range) };
+	for (; idx + Simd::Width <= count; idx += Simd::Width)
+	{
+		Simd::Int x{ Simd::Add(Simd::Counters(m_Counter), key0) };
+		x = Simd::Xor(x, Simd::ShiftRight<16>(x));
+		x = Simd::Mul(x, multiplier0);
+		x = Simd::Xor(x, key1);
+		x = Simd::Xor(x, Simd::ShiftRight<15>(x));
+		x = Simd::Mul(x, multiplier1);
+		x = Simd::Xor(x, Simd::ShiftRight<15>(x));
+
+		const Simd::Float unit{ Simd::Mul(Simd::ToFloat(Simd::ShiftRight<8>(x)), toUnit) };
+		Simd::Store(pValues + idx, Simd::Add(minimum, Simd::Mul(scale, unit)));
+		m_Counter += Simd::Width;
+	}
+#endif
+	for (; idx < count; ++idx)
+		pValues[idx] = NextFloat(min, max);
+}
+
+//=== Global Seed ===
+void Elite::SetRandomSeed(unsigned int seed)
+{
+	g_Seed = seed;
+	++g_SeedGeneration;
+}
+
+unsigned int Elite::GetRandomSeed()
+{
+	return g_Seed;
+}
+
+Elite::RandomStream& Elite::GetRandomStream()
+{
+	thread_local const unsigned int streamIdx{ g_NrOfThreadStreams++ };
+	thread_local unsigned int seedGeneration{ 0 };
+	thread_local RandomStream stream{};
+
+	const unsigned int generation{ g_SeedGeneration.load(std::memory_order_relaxed) };
+	if (seedGeneration != generation)
+	{
+		stream.Seed(g_Seed.load(std::memory_order_relaxed), streamIdx);
+		seedGeneration = generation;
+	}
+	return stream;
+}
@@ -0,0 +1,70 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// ERandom.h: Counter based random number streams, used by the random functions of the math utilities.
+/*=============================================================================*/
+#ifndef ELITE_MATH_RANDOM
+#define ELITE_MATH_RANDOM
+
+namespace Elite
+{
+	/* --- TYPES --- */
+	/*! Counter based random stream: number n of a stream is a keyed hash of n, the key comes from (seed, stream).
+		Streams share no state, so every agent or thread can have its own and the results don't depend on who draws first.
+		A stream repeats after 2^32 numbers. */
+	class RandomStream final
+	{
+	public:
+		explicit RandomStream(unsigned int seed = 0, unsigned int stream = 0) { Seed(seed, stream); }
+
+		/*! Restarts the stream, equal seed and stream give equal numbers. */
+		void Seed(unsigned int seed, unsigned int stream = 0);
+
+		unsigned int GetCounter() const { return m_Counter; }
+		void SetCounter(unsigned int counter) { m_Counter = counter; } //Skip ahead or back, free for a counter based stream
+
+		/*! Random unsigned int, any value. */
+		unsigned int NextUInt() { return Hash(m_Counter++, m_Key0, m_Key1); }
+		/*! Random int in [0, max), 0 if max <= 0. */
+		int NextInt(int max) { return max > 0 ? static_cast<int>((static_cast<unsigned long long>(NextUInt()) * static_cast<unsigned int>(max)) >> 32) : 0; }
+		/*! Random float in [0, 1). */
+		float NextFloat() { return ToFloat(NextUInt()); }
+		/*! Random float in [min, max). */
+		float NextFloat(float min, float max) { return min + (max - min) * NextFloat(); }
+
+		/*! The next count floats in [min, max), SIMD when available. Same numbers as calling NextFloat(min, max) count times. */
+		void FillFloats(float* pValues, int count, float min = 0.f, float max = 1.f);
+
+		/*! The hash of the stream, public for the batched fill. A bijection of counter for every key. */
+		static unsigned int Hash(unsigned int counter, unsigned int key0, unsigned int key1)
+		{
+			unsigned int x{ counter + key0 };
+			x ^= x >> 16;
+			x *= 0x21f0aaadu;
+			x ^= key1;
+			x ^= x >> 15;
+			x *= 0xd35a2d97u;
+			x ^= x >> 15;
+			return x;
+		}
+		/*! The 24 high bits as a float in [0, 1). */
+		static float ToFloat(unsigned int bits) { return static_cast<float>(static_cast<int>(bits >> 8)) * (1.f / 16777216.f); }
+
+	private:
+		unsigned int m_Key0 = 0;
+		unsigned int m_Key1 = 0;
+		unsigned int m_Counter = 0;
+	};
+
+	/* --- FUNCTIONS --- */
+	/*! Global seed of the random functions (randomFloat, randomInt, ...) and the default seed of new streams. 0 until set. */
+	void SetRandomSeed(unsigned int seed);
+	unsigned int GetRandomSeed();
+
+	/*! Stream of the calling thread, used by the random functions. Thread i to use it gets stream i of the global seed,
+		and every stream restarts when the global seed changes. Only the numbers of the main thread are reproducible,
+		jobs that need reproducible numbers should use a stream of their own (per agent, per block, ...). */
+	RandomStream& GetRandomStream();
+}
+#endif
@@ -0,0 +1,52 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// ERandomBenchmark.cpp: Implementation of the random number benchmark.
+/*=============================================================================*/
+#include "stdafx.h"
+#include "ERandomBenchmark.h"
+#include <chrono>
+
+namespace
+{
+	//Every result ends up here, a volatile store can't be left out
+	volatile float g_RandomSink{ 0.f };
+
+	void SinkNumbers(const std::vector<float>& numbers)
+	{
+		float sum{ 0.f };
+		for (const float number : numbers)
+			sum += number;
+		g_RandomSink = g_RandomSink + sum;
+	}
+}
+
+std::array<float, 3> Elite::BenchmarkRandom(int count /*= 1000000*/)
+{
+	std::array<float, 3> resultsMs{};
+	std::vector<float> numbers(count);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int idx{ 0 }; idx < count; ++idx)
+		numbers[idx] = static_cast<float>(rand()) / RAND_MAX;
+	auto end = std::chrono::high_resolution_clock::now();
+	resultsMs[0] = std::chrono::duration<float, std::milli>(end - start).count();
+	SinkNumbers(numbers);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int idx{ 0 }; idx < count; ++idx)
+		numbers[idx] = randomFloat();
+	end = std::chrono::high_resolution_clock::now();
+	resultsMs[1] = std::chrono::duration<float, std::milli>(end - start).count();
+	SinkNumbers(numbers);
+
+	RandomStream stream{ GetRandomSeed(), 12345 };
+	start = std::chrono::high_resolution_clock::now();
+	stream.FillFloats(numbers.data(), count);
+	end = std::chrono::high_resolution_clock::now();
+	resultsMs[2] = std::chrono::duration<float, std::milli>(end - start).count();
+	SinkNumbers(numbers);
+
+	return resultsMs;
+}
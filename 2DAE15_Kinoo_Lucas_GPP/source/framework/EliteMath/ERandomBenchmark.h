@@ -0,0 +1,19 @@
+/*=============================================================================*/
+// Copyright 2021-2022 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// ERandomBenchmark.h: Timing of the random number generators next to each other.
+/*=============================================================================*/
+#ifndef ELITE_MATH_RANDOM_BENCHMARK
+#define ELITE_MATH_RANDOM_BENCHMARK
+
+#include <array>
+
+namespace Elite
+{
+	/* --- FUNCTIONS --- */
+	/*! Time in ms to generate count floats in [0, 1) with rand(), randomFloat and RandomStream::FillFloats.
+		Every number is summed after its timing, so no generator can be skipped by the optimizer. */
+	std::array<float, 3> BenchmarkRandom(int count = 1000000);
+}
+#endif
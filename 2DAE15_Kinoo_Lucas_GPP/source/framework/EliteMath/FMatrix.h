@@ -64,11 +64,7 @@ namespace Elite
 		}
 		void Randomize(float min, float max)
 		{
-			for (int i = 0; i < m_Size; ++i)
-			{
-				float r = min + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (max - min)));
-				m_Data[i] = r;
-			}
+			GetRandomStream().FillFloats(m_Data, m_Size, min, max);
 		}
 
 		void Add(int row, int column, float toAdd)
@@ -141,35 +141,18 @@ void SDLDebugRenderer2D::Shutdown()
 
 void SDLDebugRenderer2D::DrawPolygon(Elite::Polygon* polygon, const Color& color, float depth)
 {
-	//Copy data to vector
-	std::vector<Elite::Vector2> points;
-	points.assign(polygon->GetPoints().begin(), polygon->GetPoints().end());
-
-	//Draw copied list as lines
+	//Points are stored contiguously, draw them directly as lines
 	depth -= DEPTH_SLICE_FINE_OFFSET;
-	auto p1 = points[points.size() - 1];
-	for (auto i = 0; i < static_cast<int>(points.size()); ++i)
-	{
-		const auto p2 = points[i];
-		m_vLines.push_back(Vertex(p1, depth, color));
-		m_vLines.push_back(Vertex(p2, depth, color));
-		p1 = p2;
-	}
+	const auto& points = polygon->GetPoints();
+	if (!points.empty())
+		DrawPolygon(points.data(), static_cast<int>(points.size()), color, depth);
 
 	//Also draw children
-	for (auto child : polygon->GetChildren())
+	for (const auto& child : polygon->GetChildren())
 	{
-		points.clear();
-		points.assign(child.GetPoints().begin(), child.GetPoints().end());
-
-		p1 = points[points.size() - 1];
-		for (auto i = 0; i < static_cast<int>(points.size()); ++i)
-		{
-			const auto p2 = points[i];
-			m_vLines.push_back(Vertex(p1, depth, color));
-			m_vLines.push_back(Vertex(p2, depth, color));
-			p1 = p2;
-		}
+		const auto& childPoints = child.GetPoints();
+		if (!childPoints.empty())
+			DrawPolygon(childPoints.data(), static_cast<int>(childPoints.size()), color, depth);
 	}
 }
 
@@ -195,16 +178,12 @@ void SDLDebugRenderer2D::DrawSolidPolygon(Elite::Polygon* polygon, const Color&
 	//Color
 	const Color fillColor(0.5f * color.r, 0.5f * color.g, 0.5f * color.b, 0.5f);
 
-	//Copy data to vector
-	std::vector<Elite::Vector2> points;
-	points.assign(polygon->GetPoints().begin(), polygon->GetPoints().end());
+	const auto& points = polygon->GetPoints();
 
 	//Triangulation
-	std::vector<Elite::Triangle*> triangles;
-	if (triangulate || (!triangulate && !polygon->IsTriangulated())) //Triangulate if requested OR when necessary!
-		triangles = polygon->Triangulate();
-	else
-		triangles = polygon->GetTriangles();
+	const auto& triangles = (triangulate || !polygon->IsTriangulated()) //Triangulate if requested OR when necessary!
+		? polygon->Triangulate()
+		: polygon->GetTriangles();
 
 	//Duplicate code because of possible triangulation with children -> cannot call DrawSolidPolygon directly (like Box2D)
 	//Else we would have "double triangulation"!!
@@ -219,7 +198,7 @@ void SDLDebugRenderer2D::DrawSolidPolygon(Elite::Polygon* polygon, const Color&
 		DrawPoint(pos, 2, Color(0, 1, 0, 1));
 	}
 
-	//Draw copied list as lines
+	//Draw points as lines
 	const auto drawLines = false;
 	depth -= DEPTH_SLICE_FINE_OFFSET;
 	if (drawLines)
@@ -278,16 +257,12 @@ void SDLDebugRenderer2D::DrawSolidPolygon(const Elite::Vector2* points, int coun
 	}
 	else
 	{
-		auto verts = std::vector<Elite::Vector2>();
-		for (auto i = 0; i < count; ++i)
-			verts.push_back(points[i]);
-
-		//Draw Triangles
-		for (auto i = 1; i < static_cast<int>(verts.size() - 1); ++i)
+		//Draw Triangles (fan)
+		for (auto i = 1; i < count - 1; ++i)
 		{
-			m_vTriangles.push_back(Vertex(verts[0], depth, fillColor));
-			m_vTriangles.push_back(Vertex(verts[i], depth, fillColor));
-			m_vTriangles.push_back(Vertex(verts[i + 1], depth, fillColor));
+			m_vTriangles.push_back(Vertex(points[0], depth, fillColor));
+			m_vTriangles.push_back(Vertex(points[i], depth, fillColor));
+			m_vTriangles.push_back(Vertex(points[i + 1], depth, fillColor));
 		}
 	}
 
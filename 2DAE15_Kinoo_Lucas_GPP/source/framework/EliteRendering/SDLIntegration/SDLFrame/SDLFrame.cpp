@@ -25,10 +25,7 @@ void SDLFrame::CreateFrame(EliteWindow* pWindow)
 	gl3wInit();
 
 	//Enable VSync
-	if (SDL_GL_SetSwapInterval(1) < 0)
-	{
-		printf("Warning: Unable to set VSync! SDL Error: %s\n", SDL_GetError());
-	}
+	SetVSync(true);
 
 	//Check for errors
 	GLenum errCode = glGetError();
@@ -57,3 +54,11 @@ void SDLFrame::SubmitAndFlipFrame(EImmediateUI* pImmediateUI)
 	//Swap buffers (aka Flip)
 	SDL_GL_SwapWindow(m_pWindow->GetRawWindowHandle());
 }
+
+void SDLFrame::SetVSync(bool isEnabled)
+{
+	if (SDL_GL_SetSwapInterval(isEnabled ? 1 : 0) < 0)
+	{
+		printf("Warning: Unable to set VSync! SDL Error: %s\n", SDL_GetError());
+	}
+}
@@ -25,6 +25,7 @@ namespace Elite
 		//=== Functions ===
 		void CreateFrame(EliteWindow* pWindow);
 		void SubmitAndFlipFrame(EImmediateUI* pImmediateUI = nullptr);
+		void SetVSync(bool isEnabled);
 
 	private:
 	};
@@ -33,6 +33,20 @@ namespace Elite
 			m_ForceElapsedUpperBound = force; m_ElapsedUpperBound = upperBound;
 		}
 
+		//=== Fixed Step ===
+		//When the app updates with fixed steps, the time the rendered state is behind the real time (less than a step).
+		//Set by the main loop, 0 with variable steps.
+		float GetRenderLag() const { return m_RenderLag; }
+		void SetRenderLag(float renderLag) { m_RenderLag = renderLag; }
+		//Length of a fixed step, 0 with variable steps
+		float GetFixedDeltaT() const { return m_FixedDeltaT; }
+		void SetFixedDeltaT(float fixedDeltaT) { m_FixedDeltaT = fixedDeltaT; }
+		//How far the render time is between the last two steps (0 at the previous step, 1 at the last one), 1 with variable steps
+		float GetRenderAlpha() const { return m_FixedDeltaT > 0.f ? min(m_RenderLag / m_FixedDeltaT, 1.f) : 1.f; }
+		//Update steps since the start, counted by the main loop
+		unsigned int GetNrOfUpdateSteps() const { return m_NrOfUpdateSteps; }
+		void AddUpdateStep() { ++m_NrOfUpdateSteps; }
+
 	private:
 		//=== Datamembers ===
 		float m_TotalTime = 0.0f;
@@ -41,6 +55,9 @@ namespace Elite
 
 		float m_ElapsedUpperBound = 0.03f;
 		bool m_ForceElapsedUpperBound = false;
+		float m_RenderLag = 0.0f;
+		float m_FixedDeltaT = 0.0f;
+		unsigned int m_NrOfUpdateSteps = 0;
 
 		long long m_BaseTime = 0;
 		long long m_PausedTime = 0;
@@ -120,7 +120,25 @@ void Elite::EImmediateUI::Initialize(EliteRawWindow pWindow)
 
 void Elite::EImmediateUI::Render()
 {
+	if (m_IsFrameStarted)
+	{
+		ImGui::Render();
+		m_IsFrameStarted = false;
+	}
+	else if (ImDrawData* pDrawData = ImGui::GetDrawData())
+	{
+		StaticRender(pDrawData);
+	}
+}
+
+void Elite::EImmediateUI::DiscardFrame()
+{
+	ImGuiIO& io = ImGui::GetIO();
+	const auto renderDrawLists = io.RenderDrawListsFn;
+	io.RenderDrawListsFn = nullptr;
 	ImGui::Render();
+	io.RenderDrawListsFn = renderDrawLists;
+	m_IsFrameStarted = false;
 }
 
 void Elite::EImmediateUI::EventProcessing()
@@ -301,6 +319,7 @@ void Elite::EImmediateUI::NewFrame(EliteRawWindow pWindow, float deltaTime)
 
 	//Start the frame
 	ImGui::NewFrame();
+	m_IsFrameStarted = true;
 }
 
 bool Elite::EImmediateUI::FocussedOnUI()
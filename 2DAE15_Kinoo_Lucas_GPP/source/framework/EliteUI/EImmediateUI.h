@@ -21,7 +21,8 @@ namespace Elite
 
 		//--- UI Functions ---
 		void Initialize(EliteRawWindow pWindow);
-		void Render();
+		void Render(); //Without a new frame since the last render, the last frame is drawn again
+		void DiscardFrame(); //Ends the frame without drawing it
 		void EventProcessing();
 		static void StaticRender(ImDrawData* drawData);
 		void NewFrame(EliteRawWindow pWindow, float deltaTime);
@@ -32,6 +33,7 @@ namespace Elite
 		static float m_sMouseWheel;
 		static bool m_sMousePressed[3];
 		unsigned int m_atlasTextureID = 0;
+		bool m_IsFrameStarted = false;
 
 		static GLuint m_programID;
 		static GLuint m_vboID, m_vaoID, m_elementsID;
@@ -54,6 +56,7 @@ namespace Elite
 		//--- UI Functions ---
 		void Initialize(EliteRawWindow pWindow) {};
 		void Render() {};
+		void DiscardFrame() {};
 		void EventProcessing() {};
 		static void StaticRender(ImDrawData* drawData) {};
 		void NewFrame(EliteRawWindow pWindow, float deltaTime) {};
@@ -7,23 +7,111 @@
 //Application
 #include "EliteInterfaces/EIApp.h"
 #include "projects/App_Selector.h"
+//Standard
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 
 //Hotfix for genetic algorithms project
 bool gRequestShutdown = false;
 
-//Main
-#undef main //Undefine SDL_main as main
-int main(int argc, char* argv[])
+namespace
 {
-	int x{}, y{};
-	bool runExeWithCoordinates{ argc == 3 };
+	//Fixed step of the app, the step of the physics, and the most steps a frame catches up with
+	const float FixedDeltaT{ 1.f / 60.f };
+	const int MaxNrOfStepsPerFrame{ 8 };
+
+	//Command line: [x y] [--fixed] [--seed n] [--record file] [--replay file]
+	//--fixed: the app updates with fixed steps and the random seed is set (0 without --seed), so a session only depends on its input
+	//--record: a fixed step session, its input is saved to the file when the app closes
+	//--replay: runs a recording with its settings as fast as possible (no vsync, a step every frame), prints the timings and closes
+	struct LaunchSettings
+	{
+		bool runExeWithCoordinates = false;
+		int x = 0;
+		int y = 0;
+		bool isFixedStep = false;
+		unsigned int randomSeed = 0;
+		std::string recordPath;
+		std::string replayPath;
+	};
+
+	//Whole argument as a number, false for anything else
+	bool ParseNumber(const char* arg, long long& number)
+	{
+		char* pEnd{ nullptr };
+		errno = 0;
+		number = std::strtoll(arg, &pEnd, 10);
+		return pEnd != arg && *pEnd == '\0' && errno == 0;
+	}
 
-	if (runExeWithCoordinates)
+	//Arguments that aren't understood are reported and ignored
+	LaunchSettings ParseArguments(int argc, char* argv[])
 	{
-		x = std::stoi(std::string(argv[1]));
-		y = std::stoi(std::string(argv[2]));
+		LaunchSettings settings{};
+		std::vector<int> coordinates;
+		for (int argIdx{ 1 }; argIdx < argc; ++argIdx)
+		{
+			const std::string arg{ argv[argIdx] };
+			const char* pValue{ argIdx + 1 < argc ? argv[argIdx + 1] : nullptr };
+			long long number{};
+			if (arg == "--fixed")
+			{
+				settings.isFixedStep = true;
+			}
+			else if (arg == "--seed" || arg == "--record" || arg == "--replay")
+			{
+				if (!pValue)
+				{
+					std::cout << "Ignoring " << arg << ", it needs a value." << std::endl;
+					continue;
+				}
+				++argIdx;
+				if (arg == "--record")
+					settings.recordPath = pValue;
+				else if (arg == "--replay")
+					settings.replayPath = pValue;
+				else if (ParseNumber(pValue, number) && number >= 0 && number <= UINT_MAX)
+					settings.randomSeed = static_cast<unsigned int>(number);
+				else
+					std::cout << "Ignoring --seed " << pValue << ", the seed is a number from 0 to " << UINT_MAX << "." << std::endl;
+			}
+			else if (ParseNumber(arg.c_str(), number) && number >= INT_MIN && number <= INT_MAX)
+			{
+				coordinates.push_back(static_cast<int>(number));
+			}
+			else
+			{
+				std::cout << "Ignoring unknown argument " << arg << ". Usage: [x y] [--fixed] [--seed n] [--record file] [--replay file]" << std::endl;
+			}
+		}
+
+		settings.runExeWithCoordinates = coordinates.size() == 2;
+		if (settings.runExeWithCoordinates)
+		{
+			settings.x = coordinates[0];
+			settings.y = coordinates[1];
+		}
+		else if (!coordinates.empty())
+		{
+			std::cout << "Ignoring the window position, it needs an x and a y." << std::endl;
+		}
+		settings.isFixedStep = settings.isFixedStep || !settings.recordPath.empty() || !settings.replayPath.empty();
+		return settings;
 	}
 
+	using Clock = std::chrono::high_resolution_clock;
+	float GetMilliseconds(Clock::time_point start) { return std::chrono::duration<float, std::milli>(Clock::now() - start).count(); }
+}
+
+//Main
+#undef main //Undefine SDL_main as main
+int main(int argc, char* argv[])
+{
+	const LaunchSettings settings{ ParseArguments(argc, argv) };
+	const bool isReplaying{ !settings.replayPath.empty() };
+	const bool isRecording{ !settings.recordPath.empty() };
+
 	try
 	{
 		//Window Creation
@@ -39,8 +127,8 @@ int main(int argc, char* argv[])
 
 		pWindow->CreateEWindow(params);
 
-		if (runExeWithCoordinates)
-			pWindow->SetWindowPosition(x, y);
+		if (settings.runExeWithCoordinates)
+			pWindow->SetWindowPosition(settings.x, settings.y);
 
 		//Create Frame (can later be extended by creating FrameManager for MultiThreaded Rendering)
 		EliteFrame* pFrame = new EliteFrame();
@@ -60,6 +148,17 @@ int main(int argc, char* argv[])
 		//Create Physics
 		PHYSICSWORLD; //Boot
 
+		//Session: the replay brings its own seed
+		Elite::EInputManager::SessionSettings session{ settings.randomSeed, FixedDeltaT };
+		if (isReplaying)
+		{
+			if (!INPUTMANAGER->StartReplay(settings.replayPath, session))
+				throw Elite_Exception("Can't replay " + settings.replayPath + ", it isn't a recording of this build.");
+			pFrame->SetVSync(false);
+		}
+		if (settings.isFixedStep)
+			Elite::SetRandomSeed(session.randomSeed);
+
 		//Start Timer
 		TIMER->Start();
 
@@ -70,9 +169,15 @@ int main(int argc, char* argv[])
 		ELITE_ASSERT(myApp, "Application has not been created.");
 		//Boot application
 		myApp->Start();
+		if (isRecording)
+			INPUTMANAGER->StartRecording(session);
 
 		//Application Loop
-		while (!pWindow->ShutdownRequested())
+		float stepAccumulator{ 0.f };
+		int nrOfSteps{ 0 };
+		float updateMs{ 0.f };
+		const Clock::time_point loopStart{ Clock::now() };
+		while (!pWindow->ShutdownRequested() && !(isReplaying && INPUTMANAGER->HasReplayEnded()))
 		{
 			//Timer
 			TIMER->Update();
@@ -84,13 +189,41 @@ int main(int argc, char* argv[])
 			else
 				pImmediateUI->EventProcessing();
 
-			//New frame Immediate UI (Flush)
-			pImmediateUI->NewFrame(pWindow->GetRawWindowHandle(), elapsed);
+			//Update steps: the elapsed time, or as many fixed steps as fit in it (a single one when replaying).
+			//Every step gets a UI frame, only the one of the last step is drawn. No step this frame draws the last one again.
+			int nrOfFrameSteps{ 1 };
+			float deltaT{ elapsed };
+			if (settings.isFixedStep)
+			{
+				deltaT = session.fixedDeltaT;
+				if (!isReplaying)
+				{
+					stepAccumulator = min(stepAccumulator + elapsed, MaxNrOfStepsPerFrame * session.fixedDeltaT);
+					nrOfFrameSteps = static_cast<int>(stepAccumulator / session.fixedDeltaT);
+					stepAccumulator -= nrOfFrameSteps * session.fixedDeltaT;
+				}
+				TIMER->SetFixedDeltaT(session.fixedDeltaT);
+				TIMER->SetRenderLag(stepAccumulator);
+			}
+
+			for (int stepIdx{ 0 }; stepIdx < nrOfFrameSteps; ++stepIdx)
+			{
+				//New frame Immediate UI (Flush)
+				pImmediateUI->NewFrame(pWindow->GetRawWindowHandle(), deltaT);
+				INPUTMANAGER->BeginUpdateStep();
+
+				//Update (Physics, App)
+				const Clock::time_point updateStart{ Clock::now() };
+				PHYSICSWORLD->Simulate(deltaT);
+				pCamera->Update();
+				myApp->Update(deltaT);
+				TIMER->AddUpdateStep();
+				updateMs += GetMilliseconds(updateStart);
+				++nrOfSteps;
 
-			//Update (Physics, App)
-			PHYSICSWORLD->Simulate(elapsed);
-			pCamera->Update();
-			myApp->Update(elapsed);
+				if (stepIdx + 1 < nrOfFrameSteps)
+					pImmediateUI->DiscardFrame();
+			}
 
 			//Render and Present Frame
 			PHYSICSWORLD->RenderDebug();
@@ -98,6 +231,16 @@ int main(int argc, char* argv[])
 			pFrame->SubmitAndFlipFrame(pImmediateUI);
 		}
 
+		if (isReplaying)
+		{
+			const float totalMs{ GetMilliseconds(loopStart) };
+			std::cout << "Replay of " << nrOfSteps << " steps (seed " << session.randomSeed << "): "
+				<< totalMs << " ms, " << totalMs / max(nrOfSteps, 1) << " ms per frame, "
+				<< updateMs / max(nrOfSteps, 1) << " ms per update" << std::endl;
+		}
+		if (isRecording && !INPUTMANAGER->SaveRecording(settings.recordPath))
+			std::cout << "Can't save the recording to " << settings.recordPath << std::endl;
+
 		//Reversed Deletion
 		SAFE_DELETE(myApp);
 		SAFE_DELETE(pImmediateUI);
@@ -110,6 +253,7 @@ int main(int argc, char* argv[])
 		DEBUGRENDERER2D->Destroy();
 		INPUTMANAGER->Destroy();
 		TIMER->Destroy();
+		Elite::JobSystem::Destroy(); //Static call, doesn't start the workers if nothing used them
 	}
 	catch (const Elite_Exception& e)
 	{
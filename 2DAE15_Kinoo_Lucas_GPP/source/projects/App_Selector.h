@@ -11,6 +11,7 @@
 //#define ActiveApp_NavMeshGraph
 //#define ActiveApp_AgarioGame
 //#define ActiveApp_AgarioGame_BT
+//#define ActiveApp_Benchmarks
 #define ActiveApp_InfluenceMap
 
 //---------- Registered Applications -----------
@@ -59,6 +60,11 @@ typedef App_AgarioGame CurrentApp;
 typedef App_AgarioGame_BT CurrentApp;
 #endif
 
+#ifdef ActiveApp_Benchmarks
+#include "projects/Benchmarks/App_Benchmarks.h"
+typedef App_Benchmarks CurrentApp;
+#endif
+
 #ifdef ActiveApp_InfluenceMap
 #include "projects/DecisionMaking/InfluenceMaps/App_InfluenceMap.h"
 typedef App_InfluenceMap CurrentApp;
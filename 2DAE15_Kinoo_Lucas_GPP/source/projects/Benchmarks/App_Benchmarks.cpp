@@ -0,0 +1,67 @@
+//Precompiled Header [ALWAYS ON TOP IN CPP]
+#include "stdafx.h"
+
+//Includes
+#include "App_Benchmarks.h"
+#include "framework/EliteMath/ERandomBenchmark.h"
+
+//Functions
+void App_Benchmarks::Start()
+{
+}
+
+void App_Benchmarks::Update(float deltaTime)
+{
+#ifdef PLATFORM_WINDOWS
+	//UI
+	{
+		//Setup
+		int const menuWidth = 260;
+		int const width = DEBUGRENDERER2D->GetActiveCamera()->GetWidth();
+		int const height = DEBUGRENDERER2D->GetActiveCamera()->GetHeight();
+		bool windowActive = true;
+		ImGui::SetNextWindowPos(ImVec2((float)width - menuWidth - 10, 10));
+		ImGui::SetNextWindowSize(ImVec2((float)menuWidth, (float)height - 20));
+		ImGui::Begin("Gameplay Programming", &windowActive, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+		ImGui::PushAllowKeyboardFocus(false);
+
+		//Elements
+		ImGui::Text("STATS");
+		ImGui::Indent();
+		ImGui::Text("%.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
+		ImGui::Text("%.1f FPS", ImGui::GetIO().Framerate);
+		ImGui::Unindent();
+
+		ImGui::Spacing();
+		ImGui::Separator();
+		ImGui::Spacing();
+		ImGui::Spacing();
+
+		if (ImGui::CollapsingHeader("Navigation Mesh"))
+			m_NavMeshBenchmarks.UpdateImGui();
+
+		if (ImGui::CollapsingHeader("Steering"))
+			m_SteeringBenchmarks.UpdateImGui();
+
+		if (ImGui::CollapsingHeader("Flocking"))
+			m_FlockBenchmarks.UpdateImGui();
+
+		if (ImGui::CollapsingHeader("Random"))
+		{
+			ImGui::Text("1M rand(): %.2f ms", m_RandomBenchmarkMs[0]);
+			ImGui::Text("1M randomFloat: %.2f ms", m_RandomBenchmarkMs[1]);
+			ImGui::Text("1M FillFloats: %.2f ms", m_RandomBenchmarkMs[2]);
+			if (ImGui::Button("Benchmark Random"))
+				m_RandomBenchmarkMs = Elite::BenchmarkRandom();
+		}
+
+		//End
+		ImGui::PopAllowKeyboardFocus();
+		ImGui::End();
+	}
+#endif
+}
+
+void App_Benchmarks::Render(float deltaTime) const
+{
+}
@@ -0,0 +1,39 @@
+#ifndef BENCHMARKS_APPLICATION_H
+#define BENCHMARKS_APPLICATION_H
+//-----------------------------------------------------------------
+// Includes & Forward Declarations
+//-----------------------------------------------------------------
+#include "framework/EliteInterfaces/EIApp.h"
+#include "NavMeshBenchmarks.h"
+#include "FlockBenchmarks.h"
+#include "SteeringBenchmarks.h"
+
+//-----------------------------------------------------------------
+// Application
+//-----------------------------------------------------------------
+//The benchmarks of the framework and the projects in one place, so the demo apps only show their demo.
+//Every group sets up its own data, nothing here depends on another app running.
+class App_Benchmarks final : public IApp
+{
+public:
+	//Constructor & Destructor
+	App_Benchmarks() = default;
+	virtual ~App_Benchmarks() final = default;
+
+	//App Functions
+	void Start() override;
+	void Update(float deltaTime) override;
+	void Render(float deltaTime) const override;
+
+private:
+	//Datamembers
+	NavMeshBenchmarks m_NavMeshBenchmarks{};
+	FlockBenchmarks m_FlockBenchmarks{};
+	SteeringBenchmarks m_SteeringBenchmarks{};
+	std::array<float, 3> m_RandomBenchmarkMs = {}; //1M floats from rand(), randomFloat and RandomStream::FillFloats
+
+	//C++ make the class non-copyable
+	App_Benchmarks(const App_Benchmarks&) = delete;
+	App_Benchmarks& operator=(const App_Benchmarks&) = delete;
+};
+#endif
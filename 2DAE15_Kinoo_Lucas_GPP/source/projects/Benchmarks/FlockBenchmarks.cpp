@@ -0,0 +1,534 @@
+//Precompiled Header [ALWAYS ON TOP IN CPP]
+#include "stdafx.h"
+
+//Includes
+#include "FlockBenchmarks.h"
+#include "projects/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "projects/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
+#include "projects/Movement/SteeringBehaviors/CombinedSteering/CombinedSteeringBehaviors.h"
+#include "projects/Movement/SteeringBehaviors/SpacePartitioning/SpacePartitioning.h"
+#include "projects/Movement/SteeringBehaviors/CollisionAvoidance/OrcaAvoidance.h"
+#include "projects/Movement/SteeringBehaviors/Flocking/Flock.h"
+#include "projects/Shared/KinematicAgentPool.h"
+
+using namespace Elite;
+
+namespace
+{
+	// Agents of the pool spread over the world, moving at flock speeds in any direction
+	std::vector<SteeringAgent*> CreateAgents(KinematicAgentPool& pool, int nrOfAgents, float worldSize, RandomStream& random)
+	{
+		pool.Reserve(nrOfAgents);
+		std::vector<SteeringAgent*> agents(nrOfAgents);
+		for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+		{
+			agents[idx] = new SteeringAgent(&pool);
+			agents[idx]->SetMaxLinearSpeed(50.0f);
+			agents[idx]->SetPosition({ random.NextFloat(0.f, worldSize), random.NextFloat(0.f, worldSize) });
+			agents[idx]->SetLinearVelocity({ random.NextFloat(-25.f, 25.f), random.NextFloat(-25.f, 25.f) });
+		}
+		return agents;
+	}
+
+	// Rebuild and a neighborhood query per agent, for every frame of positions (count per frame, frames back to back). Average ms per frame
+	template<typename TSpatialIndex>
+	float TimeNeighborQueries(TSpatialIndex& spatialIndex, const std::vector<float>& positionsX, const std::vector<float>& positionsY, int count, float queryRadius)
+	{
+		const int nrOfFrames{ static_cast<int>(positionsX.size()) / count };
+		std::vector<int> neighbors{};
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (int frame{ 0 }; frame < nrOfFrames; ++frame)
+		{
+			const float* pPositionsX{ positionsX.data() + frame * count };
+			const float* pPositionsY{ positionsY.data() + frame * count };
+			spatialIndex.Rebuild(pPositionsX, pPositionsY, count);
+			for (int idx{ 0 }; idx < count; ++idx)
+				spatialIndex.QueryNeighbors({ pPositionsX[idx], pPositionsY[idx] }, queryRadius, idx, neighbors);
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<float, std::milli>(end - start).count() / nrOfFrames;
+	}
+}
+
+//Functions
+void FlockBenchmarks::UpdateImGui()
+{
+	ImGui::Text("Steering per agent: %.2f ms", m_SteeringBenchmarkMs[0]);
+	ImGui::Text("Steering batched: %.2f ms", m_SteeringBenchmarkMs[1]);
+	if (ImGui::Button("Benchmark Steering"))
+		BenchmarkSteering();
+	ImGui::Spacing();
+
+	const int thousandsOfAgents[]{ 1, 10, 100 };
+	for (int sizeIdx{ 0 }; sizeIdx < 3; ++sizeIdx)
+	{
+		ImGui::Text("%dk: hash %.2f ms", thousandsOfAgents[sizeIdx], m_SpatialPartitioningBenchmarkMs[sizeIdx]);
+	}
+	if (ImGui::Button("Benchmark Partitioning"))
+		BenchmarkSpatialPartitioning();
+	ImGui::Spacing();
+
+	ImGui::Text("Uniform: hash %.2f, tree %.2f ms", m_SpatialIndexBenchmarkMs[0], m_SpatialIndexBenchmarkMs[1]);
+	ImGui::Text("Clustered: hash %.2f, tree %.2f ms", m_SpatialIndexBenchmarkMs[2], m_SpatialIndexBenchmarkMs[3]);
+	ImGui::Text("Hotspot: hash %.2f, tree %.2f ms", m_SpatialIndexBenchmarkMs[4], m_SpatialIndexBenchmarkMs[5]);
+	if (ImGui::Button("Benchmark Spatial Index"))
+		BenchmarkSpatialIndex();
+	ImGui::Spacing();
+
+	ImGui::Text("Neighborhood: passes %.2f ms, summary %.2f ms", m_NeighborhoodBenchmarkMs[0], m_NeighborhoodBenchmarkMs[1]);
+	if (ImGui::Button("Benchmark Neighborhood"))
+		BenchmarkNeighborhood();
+	ImGui::Spacing();
+
+	ImGui::Text("Clustering all: %.2f +- %.2f ms, max %.2f", m_ClusteringBenchmarkMs[0], m_ClusteringBenchmarkMs[1], m_ClusteringBenchmarkMs[2]);
+	ImGui::Text("Clustering k nearest: %.2f +- %.2f ms, max %.2f", m_ClusteringBenchmarkMs[3], m_ClusteringBenchmarkMs[4], m_ClusteringBenchmarkMs[5]);
+	if (ImGui::Button("Benchmark Clustering"))
+		BenchmarkClustering();
+	ImGui::Spacing();
+
+	const int thousandsOfCorridorAgents[]{ 5, 10, 20 };
+	for (int sizeIdx{ 0 }; sizeIdx < 3; ++sizeIdx)
+	{
+		ImGui::Text("Corridor %dk: %.2f ms, overlap %.1f%% (%.1f%%)", thousandsOfCorridorAgents[sizeIdx],
+			m_CorridorBenchmark[sizeIdx * 3], m_CorridorBenchmark[sizeIdx * 3 + 1], m_CorridorBenchmark[sizeIdx * 3 + 2]);
+	}
+	if (ImGui::Button("Benchmark Corridor"))
+		BenchmarkCorridor();
+	ImGui::Spacing();
+
+	ImGui::Text("Parallel mismatches: %d", m_NrOfParallelMismatches);
+	if (ImGui::Button("Verify Parallel Update"))
+		VerifyParallelUpdate();
+	ImGui::Spacing();
+
+	ImGui::Text("50k agents: %.2f ms, max %.2f", m_LargeFlockBenchmarkMs[0], m_LargeFlockBenchmarkMs[1]);
+	ImGui::Checkbox("50k k nearest", &m_LargeFlockKNearest);
+	if (ImGui::Button("Benchmark 50k Agents"))
+		BenchmarkLargeFlock();
+}
+
+void FlockBenchmarks::BenchmarkSteering()
+{
+	//Priority{ Evade, Blended{ Seek, Wander, Arrive, Flee } } on every agent of a flock sized pool, per agent and batched
+	Evade evade{};
+	Seek seek{};
+	Wander wander{};
+	Arrive arrive{};
+	Flee flee{};
+	evade.SetTarget(Vector2{ m_WorldSize * 0.5f, m_WorldSize * 0.25f });
+	seek.SetTarget(Vector2{ m_WorldSize * 0.5f, m_WorldSize * 0.5f });
+	arrive.SetTarget(Vector2{ m_WorldSize * 0.25f, m_WorldSize * 0.75f });
+	flee.SetTarget(Vector2{ m_WorldSize * 0.75f, m_WorldSize * 0.25f });
+	BlendedSteering blended{ { { &seek, 0.25f }, { &wander, 0.25f }, { &arrive, 0.25f }, { &flee, 0.25f } } };
+	PrioritySteering priority{ { &evade, &blended } };
+
+	RandomStream random{ GetRandomSeed() };
+	KinematicAgentPool pool{};
+	std::vector<SteeringAgent*> agents{ CreateAgents(pool, m_FlockSize, m_WorldSize, random) };
+
+	const int nrRuns{ 10 };
+	const float deltaT{ 1.f / 60.f };
+	std::vector<SteeringOutput> outputs(agents.size());
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int run{ 0 }; run < nrRuns; ++run)
+	{
+		for (size_t idx{ 0 }; idx < agents.size(); ++idx)
+			outputs[idx] = priority.CalculateSteering(deltaT, agents[idx]);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	m_SteeringBenchmarkMs[0] = std::chrono::duration<float, std::milli>(end - start).count() / nrRuns;
+
+	//The agents were added to the pool in order, so pool index == agent index
+	const AgentSpan agentSpan{ pool, 0, pool.GetSize(), agents.data() };
+	start = std::chrono::high_resolution_clock::now();
+	for (int run{ 0 }; run < nrRuns; ++run)
+	{
+		priority.CalculateSteeringBatch(deltaT, agentSpan, outputs.data());
+	}
+	end = std::chrono::high_resolution_clock::now();
+	m_SteeringBenchmarkMs[1] = std::chrono::duration<float, std::milli>(end - start).count() / nrRuns;
+
+	for (SteeringAgent* pAgent : agents)
+	{
+		SAFE_DELETE(pAgent)
+	}
+}
+
+void FlockBenchmarks::BenchmarkSpatialPartitioning()
+{
+	//Random agents at the density of the flock. The spatial hash is rebuilt, followed by a neighborhood query for every agent.
+	const std::array<int, 3> nrsOfAgents{ 1000, 10000, 100000 };
+	const float density{ m_FlockSize / (m_WorldSize * m_WorldSize) };
+
+	for (size_t sizeIdx{ 0 }; sizeIdx < nrsOfAgents.size(); ++sizeIdx)
+	{
+		const int nrOfAgents{ nrsOfAgents[sizeIdx] };
+		const float worldSize{ sqrtf(nrOfAgents / density) };
+
+		RandomStream random{ GetRandomSeed() };
+		KinematicAgentPool pool{};
+		std::vector<SteeringAgent*> agents{ CreateAgents(pool, nrOfAgents, worldSize, random) };
+
+		SpatialHash spatialHash{ m_NeighborhoodRadius, nrOfAgents };
+		std::vector<int> neighborIndices{};
+		const auto start = std::chrono::high_resolution_clock::now();
+		spatialHash.Rebuild(agents);
+		for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+			spatialHash.QueryNeighbors(agents[idx]->GetPosition(), m_NeighborhoodRadius, idx, neighborIndices);
+		const auto end = std::chrono::high_resolution_clock::now();
+		m_SpatialPartitioningBenchmarkMs[sizeIdx] = std::chrono::duration<float, std::milli>(end - start).count();
+
+		for (SteeringAgent* pAgent : agents)
+		{
+			SAFE_DELETE(pAgent)
+		}
+	}
+}
+
+void FlockBenchmarks::BenchmarkNeighborhood()
+{
+	//The neighbors of every agent are gathered up front. Then the center, velocity and separation of every neighborhood
+	//are summed in a pass each, like the separate average functions did, and in the one pass of a NeighborhoodSummary.
+	RandomStream random{ GetRandomSeed() };
+	KinematicAgentPool pool{};
+	std::vector<SteeringAgent*> agents{ CreateAgents(pool, m_FlockSize, m_WorldSize, random) };
+
+	SpatialHash spatialHash{ m_NeighborhoodRadius, max(m_FlockSize, 1024) };
+	spatialHash.Rebuild(agents);
+	std::vector<int> neighborStarts{ 0 };
+	std::vector<int> neighborIndices{};
+	std::vector<int> neighbors{};
+	for (int idx{ 0 }; idx < static_cast<int>(agents.size()); ++idx)
+	{
+		spatialHash.QueryNeighbors(agents[idx]->GetPosition(), m_NeighborhoodRadius, idx, neighbors);
+		neighborIndices.insert(neighborIndices.end(), neighbors.begin(), neighbors.end());
+		neighborStarts.push_back(static_cast<int>(neighborIndices.size()));
+	}
+
+	const int nrRuns{ 10 };
+	std::vector<NeighborhoodSummary> neighborhoods(agents.size());
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int run{ 0 }; run < nrRuns; ++run)
+	{
+		for (size_t idx{ 0 }; idx < agents.size(); ++idx)
+		{
+			const Vector2 agentPos{ agents[idx]->GetPosition() };
+			const int begin{ neighborStarts[idx] };
+			const int end{ neighborStarts[idx + 1] };
+			NeighborhoodSummary& neighborhood{ neighborhoods[idx] };
+			neighborhood = NeighborhoodSummary{};
+			neighborhood.NrOfNeighbors = end - begin;
+
+			for (int neighborIdx{ begin }; neighborIdx < end; ++neighborIdx)
+				neighborhood.CenterOfMass += agents[neighborIndices[neighborIdx]]->GetPosition();
+			for (int neighborIdx{ begin }; neighborIdx < end; ++neighborIdx)
+				neighborhood.AverageVelocity += agents[neighborIndices[neighborIdx]]->GetLinearVelocity();
+			for (int neighborIdx{ begin }; neighborIdx < end; ++neighborIdx)
+			{
+				const Vector2 toAgent{ agentPos - agents[neighborIndices[neighborIdx]]->GetPosition() };
+				const float distanceSquared{ toAgent.MagnitudeSquared() };
+				if (distanceSquared > 0.f)
+					neighborhood.Separation += toAgent / distanceSquared;
+			}
+
+			if (neighborhood.NrOfNeighbors > 0)
+			{
+				neighborhood.CenterOfMass /= static_cast<float>(neighborhood.NrOfNeighbors);
+				neighborhood.AverageVelocity /= static_cast<float>(neighborhood.NrOfNeighbors);
+			}
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	m_NeighborhoodBenchmarkMs[0] = std::chrono::duration<float, std::milli>(end - start).count() / nrRuns;
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int run{ 0 }; run < nrRuns; ++run)
+	{
+		for (size_t idx{ 0 }; idx < agents.size(); ++idx)
+		{
+			const Vector2 agentPos{ agents[idx]->GetPosition() };
+			NeighborhoodSummary& neighborhood{ neighborhoods[idx] };
+			neighborhood = NeighborhoodSummary{};
+			for (int neighborIdx{ neighborStarts[idx] }; neighborIdx < neighborStarts[idx + 1]; ++neighborIdx)
+				neighborhood.AddNeighbor(agentPos, agents[neighborIndices[neighborIdx]]);
+			neighborhood.Finish(agentPos);
+		}
+	}
+	end = std::chrono::high_resolution_clock::now();
+	m_NeighborhoodBenchmarkMs[1] = std::chrono::duration<float, std::milli>(end - start).count() / nrRuns;
+
+	for (SteeringAgent* pAgent : agents)
+	{
+		SAFE_DELETE(pAgent)
+	}
+}
+
+void FlockBenchmarks::BenchmarkClustering()
+{
+	//Agents move from random positions in the world to a few small clusters, squeezing together more every frame.
+	//Every frame the neighborhoods are summarized like the parallel update does (on one thread), with all neighbors and with the k nearest.
+	const int nrOfFrames{ 60 };
+	const float clusterSize{ 0.5f * sqrtf(m_FlockSize / 4.f) }; //Half the width of a cluster, about one agent per square unit at the end
+	const std::array<Vector2, 4> clusterCenters{ Vector2{ 0.25f, 0.25f } * m_WorldSize, Vector2{ 0.75f, 0.25f } * m_WorldSize,
+		Vector2{ 0.25f, 0.75f } * m_WorldSize, Vector2{ 0.75f, 0.75f } * m_WorldSize };
+
+	RandomStream random{ GetRandomSeed() };
+	KinematicAgentPool pool{};
+	std::vector<SteeringAgent*> agents{ CreateAgents(pool, m_FlockSize, m_WorldSize, random) };
+	std::vector<Vector2> startPositions(m_FlockSize);
+	std::vector<Vector2> endPositions(m_FlockSize);
+	for (int idx{ 0 }; idx < m_FlockSize; ++idx)
+	{
+		startPositions[idx] = agents[idx]->GetPosition();
+		endPositions[idx] = clusterCenters[idx % clusterCenters.size()] + Vector2{ random.NextFloat(-1.f, 1.f), random.NextFloat(-1.f, 1.f) } * clusterSize;
+	}
+
+	SpatialHash spatialHash{ m_NeighborhoodRadius, max(m_FlockSize, 1024) };
+	std::vector<int> neighbors{};
+	std::vector<NeighborhoodSummary> neighborhoods(m_FlockSize);
+	std::array<float, nrOfFrames> framesMs{};
+	for (int mode{ 0 }; mode < 2; ++mode)
+	{
+		const bool isKNearest{ mode == 1 };
+		for (int frame{ 0 }; frame < nrOfFrames; ++frame)
+		{
+			const float t{ static_cast<float>(frame) / (nrOfFrames - 1) };
+			for (int idx{ 0 }; idx < m_FlockSize; ++idx)
+				agents[idx]->SetPosition(Lerp(startPositions[idx], endPositions[idx], t));
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			spatialHash.Rebuild(agents);
+			for (int idx{ 0 }; idx < m_FlockSize; ++idx)
+			{
+				const Vector2 agentPos{ agents[idx]->GetPosition() };
+				if (isKNearest)
+				{
+					neighbors.resize(SpatialHash::MaxNrOfNearest);
+					neighbors.resize(spatialHash.QueryNearest(agentPos, m_NeighborhoodRadius, idx, m_NrOfNearest, neighbors.data()));
+				}
+				else
+				{
+					spatialHash.QueryNeighbors(agentPos, m_NeighborhoodRadius, idx, neighbors);
+				}
+
+				NeighborhoodSummary& neighborhood{ neighborhoods[idx] };
+				neighborhood = NeighborhoodSummary{};
+				for (int neighborIdx : neighbors)
+					neighborhood.AddNeighbor(agentPos, agents[neighborIdx]);
+				neighborhood.Finish(agentPos);
+			}
+			framesMs[frame] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		float mean{ 0.f };
+		float maxMs{ 0.f };
+		for (float frameMs : framesMs)
+		{
+			mean += frameMs / nrOfFrames;
+			maxMs = max(maxMs, frameMs);
+		}
+		float variance{ 0.f };
+		for (float frameMs : framesMs)
+			variance += Square(frameMs - mean) / nrOfFrames;
+
+		m_ClusteringBenchmarkMs[mode * 3] = mean;
+		m_ClusteringBenchmarkMs[mode * 3 + 1] = sqrtf(variance);
+		m_ClusteringBenchmarkMs[mode * 3 + 2] = maxMs;
+	}
+
+	for (SteeringAgent* pAgent : agents)
+	{
+		SAFE_DELETE(pAgent)
+	}
+}
+
+void FlockBenchmarks::BenchmarkSpatialIndex()
+{
+	//Frames of agents at the size and density of the flock: spread uniformly, in a few drifting clusters, and with most of them
+	//in a hotspot that crosses the world. Per frame the index is rebuilt (the quadtree moves the agents) and every agent queries its neighbors.
+	const int nrOfFrames{ 30 };
+	const int nrOfAgents{ m_FlockSize };
+	const float clusterSize{ 0.05f * m_WorldSize };
+	const float hotspotSize{ 0.1f * m_WorldSize };
+	RandomStream random{ GetRandomSeed() };
+
+	std::vector<Vector2> startPositions(nrOfAgents);
+	std::vector<Vector2> velocities(nrOfAgents);
+	std::array<Vector2, 8> clusterCenters;
+	std::array<Vector2, 8> clusterVelocities;
+	for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+	{
+		startPositions[idx] = Vector2{ random.NextFloat(0.f, m_WorldSize), random.NextFloat(0.f, m_WorldSize) };
+		velocities[idx] = Vector2{ random.NextFloat(-0.5f, 0.5f), random.NextFloat(-0.5f, 0.5f) };
+	}
+	for (size_t clusterIdx{ 0 }; clusterIdx < clusterCenters.size(); ++clusterIdx)
+	{
+		clusterCenters[clusterIdx] = Vector2{ random.NextFloat(0.2f, 0.8f) * m_WorldSize, random.NextFloat(0.2f, 0.8f) * m_WorldSize };
+		clusterVelocities[clusterIdx] = Vector2{ random.NextFloat(-0.2f, 0.2f), random.NextFloat(-0.2f, 0.2f) };
+	}
+
+	std::vector<float> positionsX(nrOfFrames * nrOfAgents);
+	std::vector<float> positionsY(nrOfFrames * nrOfAgents);
+	SpatialHash spatialHash{ m_NeighborhoodRadius, max(nrOfAgents, 1024) };
+	LooseQuadtree quadtree{ ZeroVector2, m_WorldSize, m_NeighborhoodRadius };
+	for (int distribution{ 0 }; distribution < 3; ++distribution)
+	{
+		for (int frame{ 0 }; frame < nrOfFrames; ++frame)
+		{
+			const float hotspotAngle{ static_cast<float>(E_PI) * frame / nrOfFrames };
+			const Vector2 hotspotCenter{ Vector2{ 0.5f, 0.5f } * m_WorldSize + Vector2{ cosf(hotspotAngle), sinf(hotspotAngle) } * 0.35f * m_WorldSize };
+			for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+			{
+				Vector2 pos{ startPositions[idx] + velocities[idx] * static_cast<float>(frame) };
+				if (distribution == 1)
+				{
+					// Offset of the start position from the middle of the world, shrunk to the cluster
+					const size_t clusterIdx{ idx % clusterCenters.size() };
+					pos = clusterCenters[clusterIdx] + clusterVelocities[clusterIdx] * static_cast<float>(frame)
+						+ (startPositions[idx] / m_WorldSize - Vector2{ 0.5f, 0.5f }) * 2.f * clusterSize;
+				}
+				else if (distribution == 2 && idx % 4 != 0)
+				{
+					pos = hotspotCenter + (startPositions[idx] / m_WorldSize - Vector2{ 0.5f, 0.5f }) * 2.f * hotspotSize;
+				}
+				positionsX[frame * nrOfAgents + idx] = Clamp(pos.x, 0.f, m_WorldSize);
+				positionsY[frame * nrOfAgents + idx] = Clamp(pos.y, 0.f, m_WorldSize);
+			}
+		}
+
+		m_SpatialIndexBenchmarkMs[distribution * 2] = TimeNeighborQueries(spatialHash, positionsX, positionsY, nrOfAgents, m_NeighborhoodRadius);
+		quadtree.Clear();
+		m_SpatialIndexBenchmarkMs[distribution * 2 + 1] = TimeNeighborQueries(quadtree, positionsX, positionsY, nrOfAgents, m_NeighborhoodRadius);
+	}
+}
+
+void FlockBenchmarks::BenchmarkCorridor()
+{
+	//Agents walk both ways through a long corridor, half of them to the right and half to the left, mixed up at the start.
+	//Every frame their preferred velocity goes straight ahead and the avoidance is timed. Afterwards the agents that overlap another one
+	//are counted, and again for a run without avoidance.
+	const std::array<int, 3> nrsOfAgents{ 5000, 10000, 20000 };
+	const int nrOfFrames{ 60 };
+	const float deltaT{ 1.f / 30.f };
+	const float agentRadius{ 0.5f };
+	const float speed{ 5.f };
+	const float corridorWidth{ 40.f };
+	const float areaPerAgent{ 8.f }; //About 10% of the corridor covered
+
+	for (size_t sizeIdx{ 0 }; sizeIdx < nrsOfAgents.size(); ++sizeIdx)
+	{
+		const int nrOfAgents{ nrsOfAgents[sizeIdx] };
+		const float corridorLength{ nrOfAgents * areaPerAgent / corridorWidth };
+		std::vector<Vector2> preferredVelocities(nrOfAgents);
+		std::vector<Vector2> safeVelocities(nrOfAgents);
+
+		for (int mode{ 0 }; mode < 2; ++mode)
+		{
+			const bool isAvoiding{ mode == 0 };
+			RandomStream random{ GetRandomSeed() };
+			KinematicAgentPool pool{};
+			pool.Reserve(nrOfAgents);
+			for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+			{
+				const int agentIdx{ pool.AddAgent({ random.NextFloat(0.f, corridorLength), random.NextFloat(0.f, corridorWidth) }) };
+				preferredVelocities[agentIdx] = Vector2{ idx % 2 == 0 ? speed : -speed, 0.f };
+				pool.SetMaxLinearSpeed(agentIdx, speed);
+				pool.SetLinearVelocity(agentIdx, preferredVelocities[agentIdx]);
+			}
+
+			OrcaAvoidance avoidance{ agentRadius, 4.f * agentRadius + 2.f * speed * 0.5f, 0.5f };
+			float avoidanceMs{ 0.f };
+			for (int frame{ 0 }; frame < nrOfFrames; ++frame)
+			{
+				if (isAvoiding)
+				{
+					const auto start = std::chrono::high_resolution_clock::now();
+					avoidance.Solve(pool, preferredVelocities.data(), safeVelocities.data(), deltaT);
+					avoidanceMs += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+				}
+
+				for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+					pool.SetLinearVelocity(idx, isAvoiding ? safeVelocities[idx] : preferredVelocities[idx]);
+				pool.Integrate(deltaT);
+				pool.TrimToWorld({ 0.f, 0.f }, { corridorLength, corridorWidth }, false);
+			}
+
+			SpatialHash spatialHash{ 2.f * agentRadius, nrOfAgents };
+			spatialHash.Rebuild(pool.GetPositionsX(), pool.GetPositionsY(), nrOfAgents);
+			int nrOfOverlapping{ 0 };
+			std::array<int, 1> overlapping;
+			for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+			{
+				// A little slack, the safe velocities keep agents just touching
+				if (spatialHash.QueryNeighbors(pool.GetPosition(idx), 1.9f * agentRadius, idx, overlapping.data(), 1) > 0)
+					++nrOfOverlapping;
+			}
+
+			if (isAvoiding)
+				m_CorridorBenchmark[sizeIdx * 3] = avoidanceMs / nrOfFrames;
+			m_CorridorBenchmark[sizeIdx * 3 + 1 + mode] = 100.f * nrOfOverlapping / nrOfAgents;
+		}
+	}
+}
+
+void FlockBenchmarks::BenchmarkLargeFlock()
+{
+	//A flock of 50k kinematic agents, as dense as the one of App_Flocking, updated in parallel for 60 frames
+	const int nrOfAgents{ 50000 };
+	const int nrOfFrames{ 60 };
+	const float deltaT{ 1.f / 60.f };
+	const float worldSize{ m_WorldSize * sqrtf(static_cast<float>(nrOfAgents) / m_FlockSize) };
+
+	Flock flock{ nrOfAgents, worldSize, nullptr, true, true };
+	flock.SetKNearest(m_LargeFlockKNearest);
+
+	float totalMs{ 0.f };
+	float maxMs{ 0.f };
+	for (int frame{ 0 }; frame < nrOfFrames; ++frame)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		flock.Update(deltaT);
+		const float frameMs{ std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count() };
+		totalMs += frameMs;
+		maxMs = max(maxMs, frameMs);
+	}
+	m_LargeFlockBenchmarkMs[0] = totalMs / nrOfFrames;
+	m_LargeFlockBenchmarkMs[1] = maxMs;
+}
+
+void FlockBenchmarks::VerifyParallelUpdate()
+{
+	//Two flocks from the same seed, one updated in a single block (on one thread) and one in small blocks spread over all threads.
+	//Every agent only reads the pool and its own state, so after some frames the agents have to be at the same place to the bit.
+	const int nrOfFrames{ 10 };
+	const float deltaT{ 1.f / 60.f };
+	const unsigned int seed{ GetRandomSeed() };
+
+	SetRandomSeed(seed);
+	Flock serialFlock{ m_FlockSize, m_WorldSize, nullptr, true, true };
+	serialFlock.SetUpdateBlockSize(m_FlockSize);
+	SetRandomSeed(seed);
+	Flock parallelFlock{ m_FlockSize, m_WorldSize, nullptr, true, true };
+	parallelFlock.SetUpdateBlockSize(16);
+
+	for (int frame{ 0 }; frame < nrOfFrames; ++frame)
+	{
+		serialFlock.Update(deltaT);
+		parallelFlock.Update(deltaT);
+	}
+
+	m_NrOfParallelMismatches = 0;
+	for (int idx{ 0 }; idx < m_FlockSize; ++idx)
+	{
+		const SteeringAgent* pSerial{ serialFlock.GetAgents()[idx] };
+		const SteeringAgent* pParallel{ parallelFlock.GetAgents()[idx] };
+		const Vector2 serialPos{ pSerial->GetPosition() };
+		const Vector2 parallelPos{ pParallel->GetPosition() };
+		const Vector2 serialVel{ pSerial->GetLinearVelocity() };
+		const Vector2 parallelVel{ pParallel->GetLinearVelocity() };
+		if (serialPos.x != parallelPos.x || serialPos.y != parallelPos.y || serialVel.x != parallelVel.x || serialVel.y != parallelVel.y)
+			++m_NrOfParallelMismatches;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+
+//Benchmarks of the flock, its steering and the spatial indices it uses, with a result line and a button each.
+//The flock settings are the ones of App_Flocking, the agents are made by the benchmarks themselves.
+class FlockBenchmarks final
+{
+public:
+	FlockBenchmarks() = default;
+	~FlockBenchmarks() = default;
+
+	void UpdateImGui();
+
+private:
+	//Datamembers
+	int m_FlockSize = 2500;
+	float m_WorldSize = 200.f;
+	float m_NeighborhoodRadius = 15.f;
+	int m_NrOfNearest = 7;
+	bool m_LargeFlockKNearest = false; //The 50k flock with the k nearest neighbors instead of all of them
+
+	std::array<float, 2> m_SteeringBenchmarkMs = {}; //Evade/seek/wander/arrive/flee for the whole flock, per agent and batched
+	std::array<float, 3> m_SpatialPartitioningBenchmarkMs = {}; //Spatial hash rebuild and queries, for 1k, 10k and 100k agents
+	std::array<float, 2> m_NeighborhoodBenchmarkMs = {}; //A pass per average, and the summary
+	std::array<float, 6> m_ClusteringBenchmarkMs = {}; //Mean, standard deviation and max frame time of a flock bunching up, all neighbors and k nearest
+	std::array<float, 6> m_SpatialIndexBenchmarkMs = {}; //Spatial hash and loose quadtree, for uniform, clustered and moving hotspot agents
+	std::array<float, 9> m_CorridorBenchmark = {}; //Avoidance ms per frame, overlapping agents in % with and without avoidance, for 5k, 10k and 20k agents
+	int m_NrOfParallelMismatches = -1; //Agents that end up elsewhere with one block than with small blocks on all threads, -1 before the check
+	std::array<float, 2> m_LargeFlockBenchmarkMs = {}; //Mean and max update of a flock of 50k kinematic agents
+
+	void BenchmarkSteering();
+	void BenchmarkSpatialPartitioning();
+	void BenchmarkNeighborhood();
+	void BenchmarkClustering();
+	void BenchmarkSpatialIndex();
+	void BenchmarkCorridor();
+	void BenchmarkLargeFlock();
+	void VerifyParallelUpdate();
+
+	//C++ make the class non-copyable
+	FlockBenchmarks(const FlockBenchmarks&) = delete;
+	FlockBenchmarks& operator=(const FlockBenchmarks&) = delete;
+};
@@ -0,0 +1,567 @@
+//Precompiled Header [ALWAYS ON TOP IN CPP]
+#include "stdafx.h"
+
+//Includes
+#include "NavMeshBenchmarks.h"
+#include "framework/EliteAI/EliteGraphs/ENavGraph.h"
+#include "framework/EliteAI/EliteNavigation/Algorithms/ENavMeshQuery.h"
+#include "framework/EliteGeometry/EGeometry2DOperations.h"
+#include "framework/EliteGeometry/EGeometry2DBatchUtilities.h"
+#include <cstring>
+#include <memory>
+#if defined(_WIN32) && defined(_DEBUG)
+#include <crtdbg.h>
+
+//Allocation counting for BenchmarkPathQueries, only the debug CRT calls allocation hooks.
+//The hook is installed around the counted queries and only counts on the thread that runs them.
+namespace
+{
+	thread_local bool sIsCountingAllocations = false;
+	thread_local int sNrOfAllocations = 0;
+
+	int __cdecl CountAllocation(int allocType, void*, size_t, int, long, const unsigned char*, int)
+	{
+		if (sIsCountingAllocations && (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC))
+			++sNrOfAllocations;
+		return TRUE;
+	}
+}
+#endif
+
+//Destructor
+NavMeshBenchmarks::~NavMeshBenchmarks()
+{
+	SAFE_DELETE(m_pLevelNavGraph)
+}
+
+//Functions
+void NavMeshBenchmarks::UpdateImGui()
+{
+	ImGui::Text("Union 100: %.2f ms", m_UnionBenchmarkMs[0]);
+	ImGui::Text("Union 1k: %.2f ms", m_UnionBenchmarkMs[1]);
+	ImGui::Text("Union 10k: %.2f ms", m_UnionBenchmarkMs[2]);
+	if (ImGui::Button("Benchmark Union"))
+		BenchmarkObstacleUnion();
+	ImGui::Spacing();
+
+	ImGui::Text("Triangulate 1k: %.2f ms", m_TriangulationBenchmarkMs[0]);
+	ImGui::Text("Triangulate 4k: %.2f ms", m_TriangulationBenchmarkMs[1]);
+	ImGui::Text("Triangulate 16k: %.2f ms", m_TriangulationBenchmarkMs[2]);
+	if (ImGui::Button("Benchmark Triangulation"))
+		BenchmarkTriangulation();
+	ImGui::Spacing();
+
+	ImGui::Text("Obstacle add: %.3f ms", m_ObstacleBenchmarkMs[0]);
+	ImGui::Text("Obstacle remove: %.3f ms", m_ObstacleBenchmarkMs[1]);
+	ImGui::Text("Obstacle slowest: %.2f ms", m_ObstacleBenchmarkMs[2]);
+	ImGui::Text("Full rebuild: %.2f ms", m_ObstacleBenchmarkMs[3]);
+	if (ImGui::Button("Benchmark Obstacles"))
+		BenchmarkDynamicObstacles();
+	ImGui::Spacing();
+
+	ImGui::Text("Locate linear: %.2f us", m_PointLocationBenchmarkUs[0]);
+	ImGui::Text("Locate grid: %.3f us", m_PointLocationBenchmarkUs[1]);
+	ImGui::Text("Locate batch: %.3f us", m_PointLocationBenchmarkUs[2]);
+	ImGui::Text("Locate mismatches: %d", m_NrOfLocationMismatches);
+	if (ImGui::Button("Benchmark Point Location"))
+		BenchmarkPointLocation();
+	ImGui::Spacing();
+
+	ImGui::Text("Draw outlines x100: %.2f ms", m_PolygonBenchmarkMs[0]);
+	ImGui::Text("Overlap 1k boxes: %.2f ms", m_PolygonBenchmarkMs[1]);
+	ImGui::Text("Overlapping pairs: %d", m_NrOfOverlappingBoxes);
+	if (ImGui::Button("Benchmark Polygon"))
+		BenchmarkPolygonAccess();
+	ImGui::Spacing();
+
+	ImGui::Text("1M points scalar: %.2f ms", m_SimdBenchmarkMs[0]);
+	ImGui::Text("1M points batched: %.2f ms", m_SimdBenchmarkMs[1]);
+	ImGui::Text("1M triangles scalar: %.2f ms", m_SimdBenchmarkMs[2]);
+	ImGui::Text("1M triangles batched: %.2f ms", m_SimdBenchmarkMs[3]);
+	ImGui::Text("SIMD mismatches: %d", m_NrOfSimdMismatches);
+	if (ImGui::Button("Benchmark SIMD"))
+		BenchmarkSimdKernels();
+	ImGui::Spacing();
+
+	ImGui::Text("Path query: %.2f us", m_QueryBenchmarkUs);
+	ImGui::Text("Query allocations: %d", m_NrOfQueryAllocations);
+	if (ImGui::Button("Benchmark Path Query"))
+		BenchmarkPathQueries();
+	ImGui::Spacing();
+
+	ImGui::Text("Raycasts: %.0f per second", m_RaycastsPerSecond);
+	ImGui::Text("Clear raycasts: %d", m_NrOfClearRaycasts);
+	if (ImGui::Button("Benchmark Raycast"))
+		BenchmarkRaycasts();
+}
+
+const Elite::NavGraph* NavMeshBenchmarks::GetLevelNavGraph()
+{
+	//The base box of App_NavMeshGraph, with its colliders (center, width and height) added as obstacles
+	if (!m_pLevelNavGraph)
+	{
+		std::list<Elite::Vector2> baseBox{ { -60, 30 },{ -60, -30 },{ 60, -30 },{ 60, 30 } };
+		m_pLevelNavGraph = new Elite::NavGraph(Elite::Polygon(baseBox), m_AgentRadius);
+
+		const std::array<Elite::Vector2, 4> centers{ { { 25.f, 12.f },{ -35.f, 7.f },{ -13.f, -8.f },{ 15.f, -21.f } } };
+		const std::array<Elite::Vector2, 4> sizes{ { { 45.f, 7.f },{ 14.f, 10.f },{ 30.f, 2.f },{ 50.f, 3.f } } };
+		for (size_t i = 0; i < centers.size(); ++i)
+		{
+			const Elite::Vector2 halfSize = sizes[i] * 0.5f;
+			m_pLevelNavGraph->AddObstacle(Elite::Polygon({ centers[i] + Elite::Vector2(-halfSize.x, halfSize.y), centers[i] + halfSize,
+				centers[i] + Elite::Vector2(halfSize.x, -halfSize.y), centers[i] - halfSize }));
+		}
+	}
+	return m_pLevelNavGraph;
+}
+
+void NavMeshBenchmarks::BenchmarkObstacleUnion()
+{
+	//Random expanded boxes (same seed every run) in an area that makes them overlap in big clusters
+	const std::array<int, 3> nrBoxes = { 100, 1000, 10000 };
+	for (size_t i = 0; i < nrBoxes.size(); ++i)
+	{
+		std::mt19937 generator(1337);
+		const float areaSize = sqrtf(static_cast<float>(nrBoxes[i])) * 6.0f;
+		std::uniform_real_distribution<float> positionDistribution(-areaSize, areaSize);
+		std::uniform_real_distribution<float> sizeDistribution(1.0f, 8.0f);
+
+		std::vector<Elite::Polygon> boxes;
+		boxes.reserve(nrBoxes[i]);
+		for (int boxIdx = 0; boxIdx < nrBoxes[i]; ++boxIdx)
+		{
+			const Elite::Vector2 center(positionDistribution(generator), positionDistribution(generator));
+			const Elite::Vector2 halfSize(sizeDistribution(generator), sizeDistribution(generator));
+			Elite::Polygon box({ center + Elite::Vector2(-halfSize.x, halfSize.y), center + halfSize,
+				center + Elite::Vector2(halfSize.x, -halfSize.y), center - halfSize });
+			box.ExpandShape(m_AgentRadius);
+			boxes.push_back(box);
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		const auto merged = Elite::UnionPolygons(boxes);
+		const auto end = std::chrono::high_resolution_clock::now();
+		m_UnionBenchmarkMs[i] = std::chrono::duration<float, std::milli>(end - start).count();
+	}
+}
+
+void NavMeshBenchmarks::BenchmarkTriangulation()
+{
+	//A circle with random radii (same seed every run), so about half of the points are reflex, and a grid of small hexagonal holes.
+	//Ear clipping tests the reflex points for every ear, the time grows close to quadratically with the points.
+	const std::array<int, 3> nrPoints = { 1000, 4000, 16000 };
+	const float radius = 100.0f;
+	for (size_t i = 0; i < nrPoints.size(); ++i)
+	{
+		std::mt19937 generator(1337);
+		std::uniform_real_distribution<float> radiusDistribution(0.9f * radius, radius);
+
+		std::vector<Elite::Vector2> outline;
+		outline.reserve(nrPoints[i]);
+		for (int pointIdx = 0; pointIdx < nrPoints[i]; ++pointIdx)
+		{
+			const float angle = 2.0f * static_cast<float>(E_PI) * pointIdx / nrPoints[i];
+			outline.push_back(Elite::Vector2(cosf(angle), sinf(angle)) * radiusDistribution(generator));
+		}
+
+		std::vector<std::vector<Elite::Vector2>> holes;
+		for (int holeIdx = 0; holeIdx < 16; ++holeIdx)
+		{
+			const Elite::Vector2 center((holeIdx % 4 - 1.5f) * 0.3f * radius, (holeIdx / 4 - 1.5f) * 0.3f * radius);
+			std::vector<Elite::Vector2> hole;
+			for (int pointIdx = 0; pointIdx < 6; ++pointIdx)
+			{
+				const float angle = static_cast<float>(E_PI) * pointIdx / 3.0f;
+				hole.push_back(center + Elite::Vector2(cosf(angle), sinf(angle)) * 0.05f * radius);
+			}
+			holes.push_back(hole);
+		}
+
+		Elite::Polygon polygon(outline, holes);
+		const auto start = std::chrono::high_resolution_clock::now();
+		polygon.Triangulate();
+		const auto end = std::chrono::high_resolution_clock::now();
+		m_TriangulationBenchmarkMs[i] = std::chrono::duration<float, std::milli>(end - start).count();
+	}
+}
+
+void NavMeshBenchmarks::BenchmarkDynamicObstacles()
+{
+	//A separate graph over a big box, with up to 64 random boxes (same seed every run) alive at a time. Every step adds one,
+	//once there are 64 a random one is removed first. Overlapping boxes can't be patched in, those rebuild the whole mesh.
+	const int nrSteps = 2000;
+	const int maxNrObstacles = 64;
+	const float areaSize = 100.0f;
+	std::mt19937 generator(1337);
+	std::uniform_real_distribution<float> positionDistribution(-areaSize, areaSize);
+	std::uniform_real_distribution<float> sizeDistribution(0.5f, 3.0f);
+
+	const std::vector<Elite::Vector2> area{ { -areaSize - 10.0f, -areaSize - 10.0f },{ areaSize + 10.0f, -areaSize - 10.0f },
+		{ areaSize + 10.0f, areaSize + 10.0f },{ -areaSize - 10.0f, areaSize + 10.0f } };
+	Elite::NavGraph navGraph(Elite::Polygon(area), m_AgentRadius);
+	std::vector<int> obstacleIds;
+	std::vector<Elite::Polygon> obstacles;
+	float addMs = 0.0f, removeMs = 0.0f, slowestMs = 0.0f;
+	int nrRemoves = 0;
+	for (int step = 0; step < nrSteps; ++step)
+	{
+		if (static_cast<int>(obstacleIds.size()) == maxNrObstacles)
+		{
+			std::uniform_int_distribution<int> obstacleDistribution(0, maxNrObstacles - 1);
+			const int obstacleIdx = obstacleDistribution(generator);
+			const auto start = std::chrono::high_resolution_clock::now();
+			navGraph.RemoveObstacle(obstacleIds[obstacleIdx]);
+			const float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			removeMs += ms;
+			slowestMs = max(slowestMs, ms);
+			++nrRemoves;
+			obstacleIds[obstacleIdx] = obstacleIds.back();
+			obstacleIds.pop_back();
+			obstacles[obstacleIdx] = obstacles.back();
+			obstacles.pop_back();
+		}
+
+		const Elite::Vector2 center(positionDistribution(generator), positionDistribution(generator));
+		const Elite::Vector2 halfSize(sizeDistribution(generator), sizeDistribution(generator));
+		const Elite::Polygon box({ center + Elite::Vector2(-halfSize.x, halfSize.y), center + halfSize,
+			center + Elite::Vector2(halfSize.x, -halfSize.y), center - halfSize });
+		const auto start = std::chrono::high_resolution_clock::now();
+		obstacleIds.push_back(navGraph.AddObstacle(box));
+		const float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		addMs += ms;
+		slowestMs = max(slowestMs, ms);
+		obstacles.push_back(box);
+	}
+	m_ObstacleBenchmarkMs[0] = addMs / nrSteps;
+	m_ObstacleBenchmarkMs[1] = removeMs / max(nrRemoves, 1);
+	m_ObstacleBenchmarkMs[2] = slowestMs;
+
+	//What every add or remove would cost without the local rebuild
+	Elite::Polygon fullMesh(area);
+	for (auto& obstacle : obstacles)
+	{
+		obstacle.OrientateWithChildren(Elite::Winding::CW);
+		obstacle.ExpandShape(m_AgentRadius);
+		fullMesh.AddChild(obstacle);
+	}
+	const auto start = std::chrono::high_resolution_clock::now();
+	Elite::NavGraph fullGraph(fullMesh, m_AgentRadius);
+	m_ObstacleBenchmarkMs[3] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void NavMeshBenchmarks::BenchmarkPointLocation()
+{
+	//A square with a grid of 60x60 small square holes, about 20000 triangles, and random positions in it (same seed every run).
+	//The linear scan tests every triangle like GetTriangleFromPosition did without the grid, it only gets the first positions.
+	const int nrHolesPerSide = 60;
+	const float size = 300.0f;
+	const float holeSpacing = size / nrHolesPerSide;
+	const std::vector<Elite::Vector2> outline{ { 0.0f, 0.0f },{ size, 0.0f },{ size, size },{ 0.0f, size } };
+	std::vector<std::vector<Elite::Vector2>> holes;
+	for (int holeIdx = 0; holeIdx < nrHolesPerSide * nrHolesPerSide; ++holeIdx)
+	{
+		const Elite::Vector2 center((holeIdx % nrHolesPerSide + 0.5f) * holeSpacing, (holeIdx / nrHolesPerSide + 0.5f) * holeSpacing);
+		const float halfSize = 0.2f * holeSpacing;
+		holes.push_back({ center + Elite::Vector2(-halfSize, -halfSize), center + Elite::Vector2(halfSize, -halfSize),
+			center + Elite::Vector2(halfSize, halfSize), center + Elite::Vector2(-halfSize, halfSize) });
+	}
+	Elite::Polygon polygon(outline, holes);
+	const auto& triangles = polygon.Triangulate();
+
+	const int nrPositions = 100000;
+	const int nrLinearPositions = 1000;
+	std::mt19937 generator(1337);
+	std::uniform_real_distribution<float> positionDistribution(0.0f, size);
+	std::vector<Elite::Vector2> positions(nrPositions);
+	for (auto& position : positions)
+		position = Elite::Vector2(positionDistribution(generator), positionDistribution(generator));
+	std::vector<const Elite::Triangle*> linearTriangles(nrLinearPositions);
+	std::vector<const Elite::Triangle*> gridTriangles(nrPositions);
+	std::vector<const Elite::Triangle*> batchTriangles(nrPositions);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < nrLinearPositions; ++i)
+	{
+		const auto it = std::find_if(triangles.begin(), triangles.end(), [&](const Elite::Triangle* pTriangle)
+			{
+				return Elite::PointInTriangle(positions[i], pTriangle->p1, pTriangle->p2, pTriangle->p3);
+			});
+		linearTriangles[i] = (it == triangles.end()) ? nullptr : *it;
+	}
+	m_PointLocationBenchmarkUs[0] = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / nrLinearPositions;
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < nrPositions; ++i)
+		gridTriangles[i] = polygon.GetTriangleFromPosition(positions[i]);
+	m_PointLocationBenchmarkUs[1] = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / nrPositions;
+
+	start = std::chrono::high_resolution_clock::now();
+	polygon.LocateTriangles(positions.data(), nrPositions, batchTriangles.data());
+	m_PointLocationBenchmarkUs[2] = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / nrPositions;
+
+	m_NrOfLocationMismatches = 0;
+	for (int i = 0; i < nrPositions; ++i)
+	{
+		if ((i < nrLinearPositions && gridTriangles[i] != linearTriangles[i]) || batchTriangles[i] != gridTriangles[i])
+			++m_NrOfLocationMismatches;
+	}
+}
+
+void NavMeshBenchmarks::BenchmarkPolygonAccess()
+{
+	//Render path: the outlines of the level drawn 100 times, like the navigation mesh app draws them every frame
+	const Elite::NavGraph* pNavGraph = GetLevelNavGraph();
+	const int nrDraws = 100;
+	const auto vpPolygons = pNavGraph->GetNavMeshPolygons();
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int drawIdx = 0; drawIdx < nrDraws; ++drawIdx)
+	{
+		for (const auto pPolygon : vpPolygons)
+			DEBUGRENDERER2D->DrawPolygon(pPolygon, Color(0.1f, 0.1f, 0.1f), 0.4f);
+	}
+	m_PolygonBenchmarkMs[0] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	//Overlap path: the bounds of every pair of random boxes (same seed every run), read from the cached bounds
+	const int nrBoxes = 1000;
+	std::mt19937 generator(1337);
+	std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> sizeDistribution(1.0f, 8.0f);
+	std::vector<Elite::Polygon> boxes;
+	boxes.reserve(nrBoxes);
+	for (int boxIdx = 0; boxIdx < nrBoxes; ++boxIdx)
+	{
+		const Elite::Vector2 center(positionDistribution(generator), positionDistribution(generator));
+		const Elite::Vector2 halfSize(sizeDistribution(generator), sizeDistribution(generator));
+		boxes.push_back(Elite::Polygon({ center + Elite::Vector2(-halfSize.x, halfSize.y), center + halfSize,
+			center + Elite::Vector2(halfSize.x, -halfSize.y), center - halfSize }));
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	m_NrOfOverlappingBoxes = 0;
+	for (int first = 0; first < nrBoxes; ++first)
+	{
+		for (int second = first + 1; second < nrBoxes; ++second)
+		{
+			if (boxes[first].OverlappingXAxis(boxes[second]) && boxes[first].OverlappingYAxis(boxes[second]))
+				++m_NrOfOverlappingBoxes;
+		}
+	}
+	m_PolygonBenchmarkMs[1] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void NavMeshBenchmarks::BenchmarkSimdKernels()
+{
+	//1. Every batched function against its scalar version on random triangles (same seed every run), also degenerate ones, and points
+	//that are random, on the corners, on the edges, inside or just next to an edge. Distances have to match bit for bit.
+	std::mt19937 generator(1337);
+	std::uniform_real_distribution<float> coordinateDistribution(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+	std::uniform_int_distribution<int> kindDistribution(0, 4);
+	const auto randomPosition = [&]() { return Elite::Vector2(coordinateDistribution(generator), coordinateDistribution(generator)); };
+	const auto isSameDistance = [](float a, float b)
+	{
+		unsigned int aBits, bBits;
+		std::memcpy(&aBits, &a, sizeof(float));
+		std::memcpy(&bBits, &b, sizeof(float));
+		return aBits == bBits || (std::isnan(a) && std::isnan(b));
+	};
+
+	const int maxNrPoints = 37;
+	std::vector<float> pointsX(maxNrPoints), pointsY(maxNrPoints), distances(maxNrPoints);
+	std::array<bool, maxNrPoints> inTriangle, inBoundingBox;
+	m_NrOfSimdMismatches = 0;
+	for (int triangleIdx = 0; triangleIdx < 20000; ++triangleIdx)
+	{
+		std::array<Elite::Vector2, 3> corners{ { randomPosition(), randomPosition(), randomPosition() } };
+		if (triangleIdx % 50 == 0)
+			corners[2] = corners[1];
+		else if (triangleIdx % 77 == 0)
+			corners[2] = (corners[0] + corners[1]) * 0.5f;
+
+		const int nrPoints = 1 + triangleIdx % maxNrPoints;
+		Elite::TriangleBatch batch;
+		for (int i = 0; i < nrPoints; ++i)
+		{
+			const Elite::Vector2 edgeStart = corners[i % 3];
+			const Elite::Vector2 edge = corners[(i + 1) % 3] - edgeStart;
+			Elite::Vector2 point;
+			switch (kindDistribution(generator))
+			{
+			case 0: point = randomPosition(); break;
+			case 1: point = edgeStart; break;
+			case 2: point = edgeStart + edge * unitDistribution(generator); break;
+			case 3: point = edgeStart + edge * unitDistribution(generator) + Elite::Vector2(unitDistribution(generator) - 0.5f, unitDistribution(generator) - 0.5f) * 1e-4f; break;
+			default: point = (corners[0] + corners[1] + corners[2]) / 3.0f; break;
+			}
+			pointsX[i] = point.x;
+			pointsY[i] = point.y;
+
+			//The triangles of the batch are this one and triangles around the points
+			if (i % 3 == 0)
+				batch.Add(corners[0], corners[1], corners[2]);
+			else
+				batch.Add(point, point + randomPosition() * 0.3f, point + randomPosition() * 0.3f);
+		}
+
+		Elite::PointsInTriangleBoundingBox(pointsX.data(), pointsY.data(), nrPoints, corners[0], corners[1], corners[2], inBoundingBox.data());
+		Elite::DistancesSquarePointsToLine(corners[0], corners[1], pointsX.data(), pointsY.data(), nrPoints, distances.data());
+		for (int i = 0; i < nrPoints; ++i)
+		{
+			const Elite::Vector2 point(pointsX[i], pointsY[i]);
+			if (inBoundingBox[i] != Elite::PointInTriangleBoundingBox(point, corners[0], corners[1], corners[2])
+				|| !isSameDistance(distances[i], Elite::DistanceSquarePointToLine(corners[0], corners[1], point)))
+				++m_NrOfSimdMismatches;
+		}
+
+		for (const bool onLineAllowed : { false, true })
+		{
+			Elite::PointsInTriangle(pointsX.data(), pointsY.data(), nrPoints, corners[0], corners[1], corners[2], inTriangle.data(), onLineAllowed);
+			int firstInside = -1;
+			for (int i = 0; i < nrPoints; ++i)
+			{
+				const bool isInside = Elite::PointInTriangle(Elite::Vector2(pointsX[i], pointsY[i]), corners[0], corners[1], corners[2], onLineAllowed);
+				if (isInside && firstInside == -1)
+					firstInside = i;
+				if (inTriangle[i] != isInside)
+					++m_NrOfSimdMismatches;
+			}
+			if (Elite::FindPointInTriangle(pointsX.data(), pointsY.data(), nrPoints, corners[0], corners[1], corners[2], onLineAllowed) != firstInside)
+				++m_NrOfSimdMismatches;
+
+			for (int i = 0; i < nrPoints; ++i)
+			{
+				const Elite::Vector2 point(pointsX[i], pointsY[i]);
+				Elite::PointInTriangles(point, batch, 0, nrPoints, inTriangle.data(), onLineAllowed);
+				int firstTriangle = -1;
+				for (int t = 0; t < nrPoints; ++t)
+				{
+					const bool isInside = Elite::PointInTriangle(point, Elite::Vector2(batch.tipX[t], batch.tipY[t]),
+						Elite::Vector2(batch.prevX[t], batch.prevY[t]), Elite::Vector2(batch.nextX[t], batch.nextY[t]), onLineAllowed);
+					if (isInside && firstTriangle == -1)
+						firstTriangle = t;
+					if (inTriangle[t] != isInside)
+						++m_NrOfSimdMismatches;
+				}
+				if (Elite::FindTriangleContainingPoint(point, batch, 0, nrPoints, onLineAllowed) != firstTriangle)
+					++m_NrOfSimdMismatches;
+			}
+		}
+	}
+
+	//2. 1M random points against one triangle and one point against 1M random triangles, with the scalar function in a loop and batched
+	const int nrElements = 1 << 20;
+	std::vector<float> benchmarkX(nrElements), benchmarkY(nrElements);
+	Elite::TriangleBatch benchmarkBatch;
+	benchmarkBatch.Reserve(nrElements);
+	for (int i = 0; i < nrElements; ++i)
+	{
+		benchmarkX[i] = coordinateDistribution(generator);
+		benchmarkY[i] = coordinateDistribution(generator);
+		benchmarkBatch.Add(randomPosition(), randomPosition(), randomPosition());
+	}
+	std::unique_ptr<bool[]> results(new bool[nrElements]);
+	const Elite::Vector2 tip(-5.0f, -5.0f), prev(6.0f, -4.0f), next(0.0f, 7.0f);
+	const Elite::Vector2 point(0.3f, 0.2f);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < nrElements; ++i)
+		results[i] = Elite::PointInTriangle(Elite::Vector2(benchmarkX[i], benchmarkY[i]), tip, prev, next);
+	m_SimdBenchmarkMs[0] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	Elite::PointsInTriangle(benchmarkX.data(), benchmarkY.data(), nrElements, tip, prev, next, results.get());
+	m_SimdBenchmarkMs[1] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < nrElements; ++i)
+	{
+		results[i] = Elite::PointInTriangle(point, Elite::Vector2(benchmarkBatch.tipX[i], benchmarkBatch.tipY[i]),
+			Elite::Vector2(benchmarkBatch.prevX[i], benchmarkBatch.prevY[i]), Elite::Vector2(benchmarkBatch.nextX[i], benchmarkBatch.nextY[i]));
+	}
+	m_SimdBenchmarkMs[2] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	start = std::chrono::high_resolution_clock::now();
+	Elite::PointInTriangles(point, benchmarkBatch, 0, nrElements, results.get());
+	m_SimdBenchmarkMs[3] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void NavMeshBenchmarks::BenchmarkPathQueries()
+{
+	//Paths between the centers of random triangles of the level (same seed every run), written into a span.
+	//The first round lets the buffers of the query grow, the second round is timed and the third one has to do without allocating.
+	const Elite::NavGraph* pNavGraph = GetLevelNavGraph();
+	std::vector<Elite::Vector2> centers;
+	for (const auto pPolygon : pNavGraph->GetNavMeshPolygons())
+	{
+		for (const auto pTriangle : pPolygon->GetTriangles())
+			centers.push_back((pTriangle->p1 + pTriangle->p2 + pTriangle->p3) / 3.0f);
+	}
+	if (centers.empty())
+		return;
+
+	const int nrQueries = 2000;
+	std::mt19937 generator(1337);
+	std::uniform_int_distribution<int> centerDistribution(0, static_cast<int>(centers.size()) - 1);
+	std::vector<Elite::Vector2> startPositions(nrQueries), endPositions(nrQueries);
+	for (int i = 0; i < nrQueries; ++i)
+	{
+		startPositions[i] = centers[centerDistribution(generator)];
+		endPositions[i] = centers[centerDistribution(generator)];
+	}
+	Elite::NavMeshQuery query(pNavGraph);
+	std::array<Elite::Vector2, 256> path;
+
+	for (int i = 0; i < nrQueries; ++i)
+		query.FindPath(startPositions[i], endPositions[i], Elite::Span<Elite::Vector2>(path.data(), static_cast<int>(path.size())));
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < nrQueries; ++i)
+		query.FindPath(startPositions[i], endPositions[i], Elite::Span<Elite::Vector2>(path.data(), static_cast<int>(path.size())));
+	m_QueryBenchmarkUs = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / nrQueries;
+
+#if defined(_WIN32) && defined(_DEBUG)
+	sNrOfAllocations = 0;
+	sIsCountingAllocations = true;
+	const _CRT_ALLOC_HOOK pPreviousHook = _CrtSetAllocHook(CountAllocation);
+	for (int i = 0; i < nrQueries; ++i)
+		query.FindPath(startPositions[i], endPositions[i], Elite::Span<Elite::Vector2>(path.data(), static_cast<int>(path.size())));
+	_CrtSetAllocHook(pPreviousHook);
+	sIsCountingAllocations = false;
+	m_NrOfQueryAllocations = sNrOfAllocations;
+#endif
+}
+
+void NavMeshBenchmarks::BenchmarkRaycasts()
+{
+	//Rays between the centers of random triangles of the level (same seed every run), with the hit position
+	const Elite::NavGraph* pNavGraph = GetLevelNavGraph();
+	std::vector<Elite::Vector2> centers;
+	for (const auto pPolygon : pNavGraph->GetNavMeshPolygons())
+	{
+		for (const auto pTriangle : pPolygon->GetTriangles())
+			centers.push_back((pTriangle->p1 + pTriangle->p2 + pTriangle->p3) / 3.0f);
+	}
+	if (centers.empty())
+		return;
+
+	const int nrRaycasts = 100000;
+	std::mt19937 generator(1337);
+	std::uniform_int_distribution<int> centerDistribution(0, static_cast<int>(centers.size()) - 1);
+	std::vector<Elite::Vector2> startPositions(nrRaycasts), endPositions(nrRaycasts);
+	for (int i = 0; i < nrRaycasts; ++i)
+	{
+		startPositions[i] = centers[centerDistribution(generator)];
+		endPositions[i] = centers[centerDistribution(generator)];
+	}
+
+	m_NrOfClearRaycasts = 0;
+	Elite::Vector2 hitPosition;
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < nrRaycasts; ++i)
+	{
+		if (pNavGraph->Raycast(startPositions[i], endPositions[i], &hitPosition))
+			++m_NrOfClearRaycasts;
+	}
+	const float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+	m_RaycastsPerSecond = nrRaycasts / max(seconds, 1e-6f);
+}
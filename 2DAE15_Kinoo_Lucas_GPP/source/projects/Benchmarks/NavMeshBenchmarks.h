@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+
+namespace Elite
+{
+	class NavGraph;
+}
+
+//Benchmarks of the navigation mesh and the geometry under it, with a result line and a button each.
+//Every benchmark sets up its own input with a fixed seed, so runs can be compared.
+class NavMeshBenchmarks final
+{
+public:
+	NavMeshBenchmarks() = default;
+	~NavMeshBenchmarks();
+
+	void UpdateImGui();
+
+private:
+	//Datamembers
+	float m_AgentRadius = 1.0f; //The navigation meshes are built for agents of this radius
+	Elite::NavGraph* m_pLevelNavGraph = nullptr; //The level of App_NavMeshGraph, built by the first benchmark that needs it
+
+	std::array<float, 3> m_UnionBenchmarkMs = {}; //Time to merge 100, 1000 and 10000 overlapping boxes
+	std::array<float, 3> m_TriangulationBenchmarkMs = {}; //Time to triangulate a jagged outline of 1000, 4000 and 16000 points with 16 holes
+	std::array<float, 4> m_ObstacleBenchmarkMs = {}; //Average add and remove of 2000 random obstacles, the slowest one, and a full rebuild with 64 obstacles
+	std::array<float, 3> m_PointLocationBenchmarkUs = {}; //Time per position on a mesh of about 20000 triangles: linear scan, grid and LocateTriangles
+	int m_NrOfLocationMismatches = -1; //Positions where the grid found another triangle than the linear scan, -1 before the first benchmark
+	std::array<float, 2> m_PolygonBenchmarkMs = {}; //Drawing the level outlines 100 times, overlap tests of all pairs of 1000 boxes
+	int m_NrOfOverlappingBoxes = 0; //Pairs of the overlap test that overlap
+	std::array<float, 4> m_SimdBenchmarkMs = {}; //1M points against a triangle and a point against 1M triangles, scalar and batched
+	int m_NrOfSimdMismatches = -1; //Batched results that differ from the scalar functions in any bit, -1 before the first benchmark
+	float m_QueryBenchmarkUs = 0.0f; //Time per path query between random triangles of the level
+	int m_NrOfQueryAllocations = -1; //Heap allocations of all the queries once the buffers have grown, -1 when not counted (debug builds only)
+	float m_RaycastsPerSecond = 0.0f; //Raycasts between random triangles of the level
+	int m_NrOfClearRaycasts = 0; //Raycasts of the benchmark that reached their end
+
+	const Elite::NavGraph* GetLevelNavGraph();
+	void BenchmarkObstacleUnion();
+	void BenchmarkTriangulation();
+	void BenchmarkDynamicObstacles();
+	void BenchmarkPointLocation();
+	void BenchmarkPolygonAccess();
+	void BenchmarkSimdKernels();
+	void BenchmarkPathQueries();
+	void BenchmarkRaycasts();
+
+	//C++ make the class non-copyable
+	NavMeshBenchmarks(const NavMeshBenchmarks&) = delete;
+	NavMeshBenchmarks& operator=(const NavMeshBenchmarks&) = delete;
+};
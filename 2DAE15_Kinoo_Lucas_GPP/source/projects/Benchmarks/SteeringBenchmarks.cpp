@@ -0,0 +1,144 @@
+//Precompiled Header [ALWAYS ON TOP IN CPP]
+#include "stdafx.h"
+
+//Includes
+#include "SteeringBenchmarks.h"
+#include "projects/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "projects/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
+#include "projects/Movement/SteeringBehaviors/CombinedSteering/CombinedSteeringBehaviors.h"
+#include "projects/Movement/SteeringBehaviors/CombinedSteering/ComposedSteering.h"
+#include "projects/Movement/SteeringBehaviors/SpacePartitioning/SpacePartitioning.h"
+#include "projects/Shared/KinematicAgentPool.h"
+
+using namespace Elite;
+
+//Functions
+void SteeringBenchmarks::UpdateImGui()
+{
+	const int nrsOfObstacles[]{ 100, 1000, 10000 };
+	for (int idx{ 0 }; idx < 3; ++idx)
+		ImGui::Text("Avoid %d: %.0f ns (all %.0f ns)", nrsOfObstacles[idx], m_ObstacleAvoidanceBenchmarkNs[idx * 2], m_ObstacleAvoidanceBenchmarkNs[idx * 2 + 1]);
+	if (ImGui::Button("Benchmark Avoidance"))
+		BenchmarkObstacleAvoidance();
+	ImGui::Spacing();
+
+	ImGui::Text("Composed runtime: %.0f ns", m_ComposedSteeringBenchmarkNs[0]);
+	ImGui::Text("Composed compile time: %.0f ns", m_ComposedSteeringBenchmarkNs[1]);
+	if (ImGui::Button("Benchmark Composition"))
+		BenchmarkComposedSteering();
+}
+
+void SteeringBenchmarks::BenchmarkObstacleAvoidance()
+{
+	//The same agents among more and more obstacles, in a world that grows along so they are as dense everywhere.
+	//Once with the grid and once with all obstacles in one cell, which checks every obstacle for every agent.
+	const std::array<int, 3> nrsOfObstacles{ 100, 1000, 10000 };
+	const int nrOfAgents{ 10000 };
+	const int nrOfRuns{ 10 };
+	const float areaPerObstacle{ 100.f };
+
+	for (size_t sizeIdx{ 0 }; sizeIdx < nrsOfObstacles.size(); ++sizeIdx)
+	{
+		const int nrOfObstacles{ nrsOfObstacles[sizeIdx] };
+		const float worldSize{ sqrtf(nrOfObstacles * areaPerObstacle) };
+		RandomStream random{ GetRandomSeed() };
+
+		std::vector<Vector2> centers(nrOfObstacles);
+		std::vector<float> radii(nrOfObstacles);
+		for (int idx{ 0 }; idx < nrOfObstacles; ++idx)
+		{
+			centers[idx] = Vector2{ random.NextFloat(0.f, worldSize), random.NextFloat(0.f, worldSize) };
+			radii[idx] = random.NextFloat(0.5f, 2.f);
+		}
+
+		KinematicAgentPool pool{};
+		pool.Reserve(nrOfAgents);
+		for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+		{
+			const int agentIdx{ pool.AddAgent({ random.NextFloat(0.f, worldSize), random.NextFloat(0.f, worldSize) }) };
+			const float angle{ random.NextFloat(0.f, 2.f * static_cast<float>(E_PI)) };
+			pool.SetLinearVelocity(agentIdx, { 5.f * cosf(angle), 5.f * sinf(angle) });
+		}
+		const AgentSpan agents{ pool, 0, nrOfAgents };
+		std::vector<SteeringOutput> outputs(nrOfAgents);
+
+		for (int mode{ 0 }; mode < 2; ++mode)
+		{
+			ObstacleGrid obstacleGrid{ mode == 0 ? 5.f : 2.f * worldSize };
+			obstacleGrid.Build(centers.data(), radii.data(), nrOfObstacles);
+			ObstacleAvoidance obstacleAvoidance{ &obstacleGrid };
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (int run{ 0 }; run < nrOfRuns; ++run)
+				obstacleAvoidance.CalculateSteeringBatch(0.f, agents, outputs.data());
+			const auto end = std::chrono::high_resolution_clock::now();
+			m_ObstacleAvoidanceBenchmarkNs[sizeIdx * 2 + mode] = std::chrono::duration<float, std::nano>(end - start).count() / (nrOfRuns * nrOfAgents);
+		}
+	}
+}
+
+void SteeringBenchmarks::BenchmarkComposedSteering()
+{
+	//Priority{ Evade, Blended{ Seek, Wander } } per agent, with the behaviors behind pointers and with the composed templates.
+	//Only the agents close to the evade target evade, the others fall through to the blend. Both start from the same wander states.
+	const int nrOfAgents{ 10000 };
+	const int nrOfRuns{ 10 };
+	const float worldSize{ 100.f };
+	RandomStream random{ GetRandomSeed() };
+
+	KinematicAgentPool pool{};
+	pool.Reserve(nrOfAgents);
+	std::vector<SteeringAgent*> agents{};
+	agents.reserve(nrOfAgents);
+	for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+	{
+		SteeringAgent* pAgent{ new SteeringAgent(&pool) };
+		pAgent->SetPosition({ random.NextFloat(0.f, worldSize), random.NextFloat(0.f, worldSize) });
+		pAgent->SetLinearVelocity({ random.NextFloat(-5.f, 5.f), random.NextFloat(-5.f, 5.f) });
+		pAgent->SetMaxLinearSpeed(15.f);
+		agents.push_back(pAgent);
+	}
+	std::vector<SteeringState> startStates{};
+	for (SteeringAgent* pAgent : agents)
+		startStates.push_back(pAgent->GetSteeringState());
+
+	TargetData seekTarget{};
+	seekTarget.Position = Vector2{ worldSize * 0.5f, worldSize * 0.5f };
+	TargetData evadeTarget{};
+	evadeTarget.Position = Vector2{ worldSize * 0.25f, worldSize * 0.5f };
+	evadeTarget.LinearVelocity = Vector2{ 5.f, 0.f };
+
+	Seek seek{};
+	Wander wander{};
+	Evade evade{};
+	seek.SetTarget(seekTarget);
+	evade.SetTarget(evadeTarget);
+	BlendedSteering blendedSteering{ { { &seek, 0.5f }, { &wander, 0.5f } } };
+	PrioritySteering prioritySteering{ { &evade, &blendedSteering } };
+
+	ComposedSteering<Priority<Evade, Blend<Weighted<Seek>, Weighted<Wander>>>> composedSteering{};
+	auto& pipeline = composedSteering.GetPipelineRef();
+	pipeline.GetBehaviorRef<0>().SetTarget(evadeTarget);
+	pipeline.GetBehaviorRef<1>().GetBehaviorRef<0>().SetTarget(seekTarget);
+	pipeline.GetBehaviorRef<1>().GetWeightsRef() = { 0.5f, 0.5f };
+
+	std::vector<SteeringOutput> outputs(nrOfAgents);
+	for (int mode{ 0 }; mode < 2; ++mode)
+	{
+		for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+			agents[idx]->GetSteeringState() = startStates[idx];
+
+		ISteeringBehavior* pSteering{ mode == 0 ? static_cast<ISteeringBehavior*>(&prioritySteering) : &composedSteering };
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (int run{ 0 }; run < nrOfRuns; ++run)
+		{
+			for (int idx{ 0 }; idx < nrOfAgents; ++idx)
+				outputs[idx] = pSteering->CalculateSteering(0.f, agents[idx]);
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+		m_ComposedSteeringBenchmarkNs[mode] = std::chrono::duration<float, std::nano>(end - start).count() / (nrOfRuns * nrOfAgents);
+	}
+
+	for (SteeringAgent* pAgent : agents)
+		SAFE_DELETE(pAgent);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <array>
+
+//Benchmarks of single steering behaviors and their combinations, with a result line and a button each.
+class SteeringBenchmarks final
+{
+public:
+	SteeringBenchmarks() = default;
+	~SteeringBenchmarks() = default;
+
+	void UpdateImGui();
+
+private:
+	//Datamembers
+	std::array<float, 6> m_ObstacleAvoidanceBenchmarkNs = {}; //Per agent, grid and every obstacle, for 100, 1000 and 10000 obstacles
+	std::array<float, 2> m_ComposedSteeringBenchmarkNs = {}; //Per agent, Priority{ Evade, Blended{ Seek, Wander } } composed at runtime and at compile time
+
+	void BenchmarkObstacleAvoidance();
+	void BenchmarkComposedSteering();
+
+	//C++ make the class non-copyable
+	SteeringBenchmarks(const SteeringBenchmarks&) = delete;
+	SteeringBenchmarks& operator=(const SteeringBenchmarks&) = delete;
+};
@@ -28,6 +28,7 @@ App_AgarioGame_BT::~App_AgarioGame_BT()
 
 	SAFE_DELETE(m_pContactListener);
 	SAFE_DELETE(m_pSmartAgent);
+	SAFE_DELETE(m_pSpatialLookup);
 
 	for (auto pNC : m_vNavigationColliders)
 		SAFE_DELETE(pNC);
@@ -51,6 +52,9 @@ void App_AgarioGame_BT::Start()
 	//Creating the world contact listener that informs us of collisions
 	m_pContactListener = new AgarioContactListener();
 
+	//Spatial index of the food and the other agents, the deepest nodes about the size of a search
+	m_pSpatialLookup = new BTAgarioLookup{ LooseQuadtree{ ZeroVector2, m_TrimWorldSize, 30.f }, LooseQuadtree{ ZeroVector2, m_TrimWorldSize, 30.f }, &m_pFoodVec, &m_pAgentVec };
+
 	//Create food items
 	m_pFoodVec.reserve(m_AmountOfFood);
 	for (int i = 0; i < m_AmountOfFood; i++)
@@ -144,11 +148,15 @@ void App_AgarioGame_BT::Update(float deltaTime)
 		m_GameOver = true;
 		return;
 	}
+	//The searches of the decision making use the positions at the start of the frame
+	m_pSpatialLookup->Update();
+
 	//Update the custom agent
 	m_pSmartAgent->Update(deltaTime);
 
-	//Update the other agents and food
+	//Update the other agents and food, the eaten food is deleted before the agents search
 	UpdateAgarioEntities(m_pFoodVec, deltaTime);
+	m_pSpatialLookup->Update();
 	UpdateAgarioEntities(m_pAgentVec, deltaTime);
 
 	//Check if we need to spawn new food
@@ -181,8 +189,7 @@ Blackboard* App_AgarioGame_BT::CreateBlackboard(AgarioAgent* a)
 {
 	Elite::Blackboard* pBlackboard = new Elite::Blackboard();
 	pBlackboard->AddData("Agent", a);
-	pBlackboard->AddData("AgentsVec", &m_pAgentVec);
-	pBlackboard->AddData("FoodVec", &m_pFoodVec);
+	pBlackboard->AddData("SpatialLookup", m_pSpatialLookup);
 	pBlackboard->AddData("WorldSize", m_TrimWorldSize);
 	pBlackboard->AddData("Target", Elite::Vector2{});
 	pBlackboard->AddData("AgentFleeTarget", static_cast<AgarioAgent*>(nullptr)); // Needs the cast for the type
@@ -9,6 +9,9 @@ class AgarioFood;
 class AgarioAgent;
 class AgarioContactListener;
 class NavigationColliderElement;
+class LooseQuadtree;
+template<typename TSpatialIndex>
+class AgarioSpatialLookup;
 
 class App_AgarioGame_BT final : public IApp
 {
@@ -31,6 +34,8 @@ private:
 	float m_TimeSinceLastFoodSpawn{ 0.f };
 	std::vector<AgarioFood*> m_pFoodVec{};
 
+	AgarioSpatialLookup<LooseQuadtree>* m_pSpatialLookup = nullptr; //Food and agent searches of the decision making
+
 	AgarioContactListener* m_pContactListener = nullptr;
 	bool m_GameOver = false;
 
@@ -12,8 +12,12 @@
 #include "framework/EliteAI/EliteDecisionMaking/EliteBehaviorTree/EBehaviorTree.h"
 #include "projects/Shared/Agario/AgarioAgent.h"
 #include "projects/Shared/Agario/AgarioFood.h"
+#include "projects/Shared/Agario/AgarioSpatialLookup.h"
 #include "projects/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
 
+//The searches of this game go through a loose quadtree, the agents grow and bunch up around the food
+using BTAgarioLookup = AgarioSpatialLookup<LooseQuadtree>;
+
 //-----------------------------------------------------------------
 // Behaviors
 //-----------------------------------------------------------------
@@ -92,33 +96,17 @@ namespace BT_Conditions
 	bool IsFoodNearby(Elite::Blackboard* pBlackboard)
 	{
 		AgarioAgent* pAgent{ nullptr };
-		std::vector<AgarioFood*>* pfoodVec;
+		BTAgarioLookup* pLookup{ nullptr };
 
 		if (!pBlackboard->GetData("Agent", pAgent) || !pAgent)
 			return false;
 
-		if (!pBlackboard->GetData("FoodVec", pfoodVec) || !pfoodVec)
-			return false;
-
-		if (pfoodVec->empty())
+		if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup)
 			return false;
 
 		const float searchRadius{ pAgent->GetRadius() + gSeekRadius };
 
-		float closestDistSqr{ searchRadius * searchRadius };
-		AgarioFood* pClosestFood{ nullptr };
-		Elite::Vector2 agentPos{ pAgent->GetPosition() };
-
-		for (auto& pFood : *pfoodVec)
-		{
-			const float distSqr{ pFood->GetPosition().DistanceSquared(agentPos) };
-
-			if (distSqr < closestDistSqr)
-			{
-				closestDistSqr = distSqr;
-				pClosestFood = pFood;
-			}
-		}
+		AgarioFood* pClosestFood{ pLookup->FindClosestFood(pAgent->GetPosition(), searchRadius) };
 
 		if (!pClosestFood)
 			return false;
@@ -130,15 +118,12 @@ namespace BT_Conditions
 	bool IsBiggerAgentNearby(Elite::Blackboard* pBlackboard)
 	{
 		AgarioAgent* pAgent{ nullptr };
-		std::vector<AgarioAgent*>* pAgentsVec;
+		BTAgarioLookup* pLookup{ nullptr };
 
 		if (!pBlackboard->GetData("Agent", pAgent) || !pAgent)
 			return false;
 
-		if (!pBlackboard->GetData("AgentsVec", pAgentsVec) || !pAgentsVec)
-			return false;
-
-		if (pAgentsVec->empty())
+		if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup)
 			return false;
 
 		const float searchRadius{ pAgent->GetRadius() + gFleeRadius };
@@ -146,23 +131,10 @@ namespace BT_Conditions
 		// Debug draw search radius
 		DEBUGRENDERER2D->DrawCircle(pAgent->GetPosition(), searchRadius, { 1.f, .0f, 0.f }, DEBUGRENDERER2D->NextDepthSlice());
 
-		float closestDistSqr{ searchRadius * searchRadius };
-		AgarioAgent* pClosestAgent{ nullptr };
-		Elite::Vector2 agentPos{ pAgent->GetPosition() };
-
-		for (auto& pOtherAgent : *pAgentsVec)
-		{
-			if (pOtherAgent == pAgent)
-				continue;
-
-			const float distSqr{ pOtherAgent->GetPosition().DistanceSquared(agentPos) };
-
-			if (distSqr < closestDistSqr && pOtherAgent->GetRadius() > pAgent->GetRadius())
+		AgarioAgent* pClosestAgent{ pLookup->FindClosestAgent(pAgent->GetPosition(), searchRadius, [pAgent](const AgarioAgent* pOtherAgent)
 			{
-				closestDistSqr = distSqr;
-				pClosestAgent = pOtherAgent;
-			}
-		}
+				return pOtherAgent != pAgent && pOtherAgent->GetRadius() > pAgent->GetRadius();
+			}) };
 
 		if (!pClosestAgent)
 			return false;
@@ -178,15 +150,12 @@ namespace BT_Conditions
 	bool IsSmallerAgentNearby(Elite::Blackboard* pBlackboard)
 	{
 		AgarioAgent* pAgent{ nullptr };
-		std::vector<AgarioAgent*>* pAgentsVec;
+		BTAgarioLookup* pLookup{ nullptr };
 
 		if (!pBlackboard->GetData("Agent", pAgent) || !pAgent)
 			return false;
 
-		if (!pBlackboard->GetData("AgentsVec", pAgentsVec) || !pAgentsVec)
-			return false;
-
-		if (pAgentsVec->empty())
+		if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup)
 			return false;
 
 		const float searchRadius{ pAgent->GetRadius() + gSeekRadius };
@@ -194,23 +163,10 @@ namespace BT_Conditions
 		// Debug draw search radius
 		DEBUGRENDERER2D->DrawCircle(pAgent->GetPosition(), searchRadius, { .0f, 1.f, 0.f }, DEBUGRENDERER2D->NextDepthSlice());
 
-		float closestDistSqr{ searchRadius * searchRadius };
-		AgarioAgent* pClosestAgent{ nullptr };
-		Elite::Vector2 agentPos{ pAgent->GetPosition() };
-
-		for (auto& pOtherAgent : *pAgentsVec)
-		{
-			if (pOtherAgent == pAgent)
-				continue;
-
-			const float distSqr{ pOtherAgent->GetPosition().DistanceSquared(agentPos) };
-
-			if (distSqr < closestDistSqr && pOtherAgent->GetRadius() + 1.f < pAgent->GetRadius())
+		AgarioAgent* pClosestAgent{ pLookup->FindClosestAgent(pAgent->GetPosition(), searchRadius, [pAgent](const AgarioAgent* pOtherAgent)
 			{
-				closestDistSqr = distSqr;
-				pClosestAgent = pOtherAgent;
-			}
-		}
+				return pOtherAgent != pAgent && pOtherAgent->GetRadius() + 1.f < pAgent->GetRadius();
+			}) };
 
 		if (!pClosestAgent)
 			return false;
@@ -225,43 +181,27 @@ namespace BT_Conditions
 	bool IsTargetNotNearBiggerAgent(Elite::Blackboard* pBlackboard)
 	{
 		AgarioAgent* pAgent{ nullptr };
-		std::vector<AgarioAgent*>* pAgentsVec;
+		BTAgarioLookup* pLookup{ nullptr };
 		Elite::Vector2 targetPos{};
 
 		if (!pBlackboard->GetData("Agent", pAgent) || !pAgent)
 			return true;
 
-		if (!pBlackboard->GetData("AgentsVec", pAgentsVec) || !pAgentsVec)
+		if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup)
 			return true;
 
 		if (!pBlackboard->GetData("Target", targetPos))
 			return true;
 
-		if (pAgentsVec->empty())
-			return true;
-
 		const float searchRadius{ pAgent->GetRadius() + gFleeRadius };
 
 		// Debug draw search radius
 		DEBUGRENDERER2D->DrawCircle(targetPos, searchRadius, { 1.f, .0f, 0.f }, DEBUGRENDERER2D->NextDepthSlice());
 
-		float closestDistSqr{ searchRadius * searchRadius };
-		AgarioAgent* pClosestAgent{ nullptr };
-		Elite::Vector2 agentPos{ pAgent->GetPosition() };
-
-		for (auto& pOtherAgent : *pAgentsVec)
-		{
-			if (pOtherAgent == pAgent)
-				continue;
-
-			const float distSqr{ pOtherAgent->GetPosition().DistanceSquared(targetPos) };
-
-			if (distSqr < closestDistSqr && pOtherAgent->GetRadius() > pAgent->GetRadius())
+		AgarioAgent* pClosestAgent{ pLookup->FindClosestAgent(targetPos, searchRadius, [pAgent](const AgarioAgent* pOtherAgent)
 			{
-				closestDistSqr = distSqr;
-				pClosestAgent = pOtherAgent;
-			}
-		}
+				return pOtherAgent != pAgent && pOtherAgent->GetRadius() > pAgent->GetRadius();
+			}) };
 
 		if (!pClosestAgent)
 			return true;
@@ -30,6 +30,7 @@ App_AgarioGame::~App_AgarioGame()
 
 	SAFE_DELETE(m_pContactListener);
 	SAFE_DELETE(m_pCustomAgent);
+	SAFE_DELETE(m_pSpatialLookup);
 	for (auto& s : m_pStates)
 	{
 		SAFE_DELETE(s)
@@ -46,6 +47,9 @@ void App_AgarioGame::Start()
 	//Creating the world contact listener that informs us of collisions
 	m_pContactListener = new AgarioContactListener();
 
+	//Spatial index of the food and the other agents, cells about the size of a search
+	m_pSpatialLookup = new FSMAgarioLookup{ SpatialHash{ 30.f, 256 }, SpatialHash{ 30.f, 256 }, &m_pFoodVec, &m_pAgentVec };
+
 	//Create food items
 	m_pFoodVec.reserve(m_AmountOfFood);
 	for (int i = 0; i < m_AmountOfFood; i++)
@@ -150,17 +154,23 @@ void App_AgarioGame::Update(float deltaTime)
 		m_GameOver = true;
 
 		//Update the other agents and food
+		m_pSpatialLookup->Update();
 		UpdateAgarioEntities(m_pFoodVec, deltaTime);
+		m_pSpatialLookup->Update();
 		UpdateAgarioEntities(m_pAgentVec, deltaTime);
 		return;
 	}
 
+	//The searches of the decision making use the positions at the start of the frame
+	m_pSpatialLookup->Update();
+
 	//Update the custom agent
 	m_pCustomAgent->Update(deltaTime);
 	m_pCustomAgent->TrimToWorld(m_TrimWorldSize, false);
 
-	//Update the other agents and food
+	//Update the other agents and food, the eaten food is deleted before the agents search
 	UpdateAgarioEntities(m_pFoodVec, deltaTime);
+	m_pSpatialLookup->Update();
 	UpdateAgarioEntities(m_pAgentVec, deltaTime);
 
 	//Check if we need to spawn new food
@@ -194,8 +204,7 @@ Blackboard* App_AgarioGame::CreateBlackboard(AgarioAgent* a)
 	Blackboard* pBlackboard = new Blackboard();
 
 	pBlackboard->AddData("Agent", a);
-	pBlackboard->AddData("AgentVec", &m_pAgentVec);
-	pBlackboard->AddData("FoodVec", &m_pFoodVec);
+	pBlackboard->AddData("SpatialLookup", m_pSpatialLookup);
 	pBlackboard->AddData("NearestFood", static_cast<AgarioFood*>(nullptr));
 	pBlackboard->AddData("Target", static_cast<AgarioAgent*>(nullptr));
 	pBlackboard->AddData("WorldSize", m_TrimWorldSize);
@@ -8,6 +8,9 @@
 class AgarioFood;
 class AgarioAgent;
 class AgarioContactListener;
+class SpatialHash;
+template<typename TSpatialIndex>
+class AgarioSpatialLookup;
 
 class App_AgarioGame final : public IApp
 {
@@ -30,6 +33,8 @@ private:
 	float m_TimeSinceLastFoodSpawn{ 0.f };
 	std::vector<AgarioFood*> m_pFoodVec{};
 
+	AgarioSpatialLookup<SpatialHash>* m_pSpatialLookup = nullptr; //Food and agent searches of the decision making
+
 	AgarioContactListener* m_pContactListener = nullptr;
 	bool m_GameOver = false;
 
@@ -112,8 +112,8 @@ bool FSMConditions::FoodNearbyCondition::Evaluate(Elite::Blackboard* pBlackboard
 	AgarioAgent* pAgent;
 	if (!pBlackboard->GetData("Agent", pAgent) || !pAgent) return false;
 
-	std::vector<AgarioFood*>* pFoodVec;
-	if (!pBlackboard->GetData("FoodVec", pFoodVec) || !pAgent) return false;
+	FSMAgarioLookup* pLookup;
+	if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup) return false;
 
 	const float radius{ pAgent->GetRadius() + gSeekRadius };
 
@@ -121,28 +121,12 @@ bool FSMConditions::FoodNearbyCondition::Evaluate(Elite::Blackboard* pBlackboard
 
 	DEBUGRENDERER2D->DrawCircle(agentPos, radius, Elite::Color{ .0f, 1.f, .0f }, DEBUGRENDERER2D->NextDepthSlice());
 
-	auto isCloser{ [agentPos](AgarioFood* pFood1, AgarioFood* pFood2)
-		{
-			const float dist1{ Elite::DistanceSquared(pFood1->GetPosition(), agentPos) };
-			const float dist2{ Elite::DistanceSquared(pFood2->GetPosition(), agentPos) };
+	AgarioFood* pClosestFood{ pLookup->FindClosestFood(agentPos, radius) };
 
-			return dist1 < dist2;
-		}
-	};
+	if (!pClosestFood) return false;
 
-	const auto closestElementIt{ std::min_element(pFoodVec->begin(), pFoodVec->end(), isCloser) };
-
-	if (closestElementIt == pFoodVec->end()) return false;
-
-	AgarioFood* pClosestFood{ *closestElementIt };
-
-	if (Elite::DistanceSquared(pClosestFood->GetPosition(), agentPos) < radius * radius)
-	{
-		pBlackboard->ChangeData("NearestFood", pClosestFood);
-		return true;
-	}
-
-	return false;
+	pBlackboard->ChangeData("NearestFood", pClosestFood);
+	return true;
 }
 
 bool FSMConditions::NoFoodNearbyCondition::Evaluate(Elite::Blackboard* pBlackboard) const
@@ -163,8 +147,8 @@ bool FSMConditions::BiggerAgentNearbyCondition::Evaluate(Elite::Blackboard* pBla
 	AgarioAgent* pAgent;
 	if (!pBlackboard->GetData("Agent", pAgent) || !pAgent) return false;
 
-	std::vector<AgarioAgent*>* pAgentVector;
-	if (!pBlackboard->GetData("AgentVec", pAgentVector) || !pAgentVector) return false;
+	FSMAgarioLookup* pLookup;
+	if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup) return false;
 
 	const float radius{ pAgent->GetRadius() + gFleeRadius };
 
@@ -172,15 +156,14 @@ bool FSMConditions::BiggerAgentNearbyCondition::Evaluate(Elite::Blackboard* pBla
 
 	DEBUGRENDERER2D->DrawCircle(agentPos, radius, Elite::Color{ 1.f, .0f, .0f }, DEBUGRENDERER2D->NextDepthSlice());
 
-	// Loop over all agents and check if they are bigger than the current agent
-	for (AgarioAgent* pOtherAgent : *pAgentVector)
+	// Loop over the agents within the radius and check if they are bigger than the current agent
+	std::vector<AgarioAgent*> nearbyAgents{};
+	pLookup->FindAgents(agentPos, radius, nearbyAgents);
+	for (AgarioAgent* pOtherAgent : nearbyAgents)
 	{
 		// Check if the other agent is bigger than the current agent
 		if (pOtherAgent->GetRadius() < pAgent->GetRadius()) continue;
 
-		// Check if the other agent is within the radius
-		if (Elite::DistanceSquared(pOtherAgent->GetPosition(), agentPos) > radius * radius) continue;
-
 		// Check if the other agent is not too close to the current agent
 		if (abs(pOtherAgent->GetRadius() - pAgent->GetRadius()) < 1.f) continue;
 
@@ -232,8 +215,8 @@ bool FSMConditions::SmallerAgentNearbyCondition::Evaluate(Elite::Blackboard* pBl
 	AgarioAgent* pAgent;
 	if (!pBlackboard->GetData("Agent", pAgent) || !pAgent) return false;
 
-	std::vector<AgarioAgent*>* pAgentVector;
-	if (!pBlackboard->GetData("AgentVec", pAgentVector) || !pAgentVector) return false;
+	FSMAgarioLookup* pLookup;
+	if (!pBlackboard->GetData("SpatialLookup", pLookup) || !pLookup) return false;
 
 	const float radius{ pAgent->GetRadius() + gSeekRadius };
 
@@ -241,15 +224,14 @@ bool FSMConditions::SmallerAgentNearbyCondition::Evaluate(Elite::Blackboard* pBl
 
 	DEBUGRENDERER2D->DrawCircle(agentPos, radius, Elite::Color{ 1.f, .0f, .0f }, DEBUGRENDERER2D->NextDepthSlice());
 
-	// Loop over all agents and check if they are smaller than the current agent
-	for (AgarioAgent* pOtherAgent : *pAgentVector)
+	// Loop over the agents within the radius and check if they are smaller than the current agent
+	std::vector<AgarioAgent*> nearbyAgents{};
+	pLookup->FindAgents(agentPos, radius, nearbyAgents);
+	for (AgarioAgent* pOtherAgent : nearbyAgents)
 	{
 		// Check if the other agent is smaller than the current agent
 		if (pOtherAgent->GetRadius() > pAgent->GetRadius()) continue;
 
-		// Check if the other agent is within the radius
-		if (Elite::DistanceSquared(pOtherAgent->GetPosition(), agentPos) > radius * radius) continue;
-
 		// Check if the other agent is not too close to the current agent
 		if (abs(pOtherAgent->GetRadius() - pAgent->GetRadius()) < 1.f) continue;
 
@@ -8,9 +8,13 @@
 
 #include "projects/Shared/Agario/AgarioAgent.h"
 #include "projects/Shared/Agario/AgarioFood.h"
+#include "projects/Shared/Agario/AgarioSpatialLookup.h"
 #include "projects/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
 #include "framework/EliteAI/EliteData/EBlackboard.h"
 
+//The searches of this game go through a spatial hash, the world is small and the agents spread out
+using FSMAgarioLookup = AgarioSpatialLookup<SpatialHash>;
+
 //------------
 //---STATES---
 //------------
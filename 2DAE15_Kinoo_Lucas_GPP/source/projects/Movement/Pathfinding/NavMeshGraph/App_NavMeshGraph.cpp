@@ -9,14 +9,15 @@ using namespace Elite;
 #include "projects/Movement/SteeringBehaviors/SteeringAgent.h"
 #include "projects/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
 
-#include "framework/EliteAI/EliteNavigation/Algorithms/ENavGraphPathfinding.h"
-
 //Statics
 bool App_NavMeshGraph::sShowPolygon = true;
 bool App_NavMeshGraph::sShowGraph = false;
 bool App_NavMeshGraph::sDrawPortals = false;
 bool App_NavMeshGraph::sDrawFinalPath = true;
 bool App_NavMeshGraph::sDrawNonOptimisedPath = false;
+bool App_NavMeshGraph::sToggleObstacle = false;
+bool App_NavMeshGraph::sUseTiledNavMesh = false;
+bool App_NavMeshGraph::sStreamTiles = false;
 
 //Destructor
 App_NavMeshGraph::~App_NavMeshGraph()
@@ -49,10 +50,7 @@ void App_NavMeshGraph::Start()
 	m_vNavigationColliders.push_back(new NavigationColliderElement(Elite::Vector2(15.f, -21.f), 50.0f, 3.0f));
 
 	//----------- NAVMESH  ------------
-	std::list<Elite::Vector2> baseBox
-	{ { -60, 30 },{ -60, -30 },{ 60, -30 },{ 60, 30 } };
-
-	m_pNavGraph = new Elite::NavGraph(Elite::Polygon(baseBox), m_AgentRadius);
+	CreateNavGraph();
 
 	//----------- AGENT ------------
 	m_pSeekBehavior = new Seek();
@@ -69,15 +67,45 @@ void App_NavMeshGraph::Start()
 
 void App_NavMeshGraph::Update(float deltaTime)
 {
+	//Stress test for the local navigation mesh rebuild: add/remove an obstacle (door) every frame
+	if (sToggleObstacle)
+	{
+		if (m_DynamicObstacleId == -1)
+		{
+			const std::vector<Elite::Vector2> door{ { 38.5f, -10.f },{ 38.5f, 0.f },{ 41.5f, 0.f },{ 41.5f, -10.f } };
+			m_DynamicObstacleId = m_pNavGraph->AddObstacle(Elite::Polygon(door));
+		}
+		else
+		{
+			m_pNavGraph->RemoveObstacle(m_DynamicObstacleId);
+			m_DynamicObstacleId = -1;
+		}
+	}
+
+	//Only keep the tiles around the agent loaded
+	if (sUseTiledNavMesh)
+	{
+		if (sStreamTiles)
+			m_pNavGraph->UpdateLoadedTiles(m_pAgent->GetPosition(), m_TileStreamRadius);
+		else
+			m_pNavGraph->LoadAllTiles();
+	}
+
 	//Update target/path based on input
 	if (INPUTMANAGER->IsMouseButtonUp(InputMouseButton::eMiddle))
 	{
 		auto mouseData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseButton, Elite::InputMouseButton::eMiddle);
 		Elite::Vector2 mouseTarget = DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld(
 			Elite::Vector2((float)mouseData.X, (float)mouseData.Y));
-		m_vPath = NavMeshPathfinding::FindPath(m_pAgent->GetPosition(), mouseTarget, m_pNavGraph, m_DebugNodePositions, m_Portals);
+		//Debug output is only gathered when it is drawn
+		m_NavMeshQuery.SetDebugOutput(sDrawNonOptimisedPath ? &m_DebugNodePositions : nullptr, sDrawPortals ? &m_Portals : nullptr);
+		m_NavMeshQuery.FindPath(m_pAgent->GetPosition(), mouseTarget, m_vPath);
 	}
 
+	//Shortcut the path, skip points while the one after them is in a straight line on the navigation mesh
+	while (m_vPath.size() > 1 && m_pNavGraph->Raycast(m_pAgent->GetPosition(), m_vPath[1]))
+		m_vPath.erase(m_vPath.begin());
+
 	//Check if a path exist and move to the following point
 	if (m_vPath.size() > 0)
 	{
@@ -114,10 +142,13 @@ void App_NavMeshGraph::Render(float deltaTime) const
 
 	if (sShowPolygon)
 	{
-		DEBUGRENDERER2D->DrawPolygon(m_pNavGraph->GetNavMeshPolygon(),
-			Color(0.1f, 0.1f, 0.1f));
-		DEBUGRENDERER2D->DrawSolidPolygon(m_pNavGraph->GetNavMeshPolygon(),
-			Color(0.0f, 0.5f, 0.1f, 0.05f), 0.4f);
+		for (const auto pPolygon : m_pNavGraph->GetNavMeshPolygons())
+		{
+			DEBUGRENDERER2D->DrawPolygon(pPolygon,
+				Color(0.1f, 0.1f, 0.1f));
+			DEBUGRENDERER2D->DrawSolidPolygon(pPolygon,
+				Color(0.0f, 0.5f, 0.1f, 0.05f), 0.4f);
+		}
 	}
 
 	if (sDrawPortals)
@@ -156,6 +187,21 @@ void App_NavMeshGraph::Render(float deltaTime) const
 	}
 }
 
+void App_NavMeshGraph::CreateNavGraph()
+{
+	SAFE_DELETE(m_pNavGraph)
+	m_DynamicObstacleId = -1;
+	m_vPath.clear();
+	m_Portals.clear();
+	m_DebugNodePositions.clear();
+
+	std::list<Elite::Vector2> baseBox
+	{ { -60, 30 },{ -60, -30 },{ 60, -30 },{ 60, 30 } };
+
+	m_pNavGraph = new Elite::NavGraph(Elite::Polygon(baseBox), m_AgentRadius, sUseTiledNavMesh ? m_NavMeshTileSize : 0.0f);
+	m_NavMeshQuery.SetNavGraph(m_pNavGraph);
+}
+
 void App_NavMeshGraph::UpdateImGui()
 {
 	//------- UI --------
@@ -199,6 +245,11 @@ void App_NavMeshGraph::UpdateImGui()
 		ImGui::Checkbox("Show Portals", &sDrawPortals);
 		ImGui::Checkbox("Show Path Nodes", &sDrawNonOptimisedPath);
 		ImGui::Checkbox("Show Final Path", &sDrawFinalPath);
+		ImGui::Checkbox("Toggle Obstacle", &sToggleObstacle);
+		if (ImGui::Checkbox("Tiled NavMesh", &sUseTiledNavMesh))
+			CreateNavGraph();
+		if (sUseTiledNavMesh)
+			ImGui::Checkbox("Stream Tiles", &sStreamTiles);
 		ImGui::Spacing();
 		ImGui::Spacing();
 
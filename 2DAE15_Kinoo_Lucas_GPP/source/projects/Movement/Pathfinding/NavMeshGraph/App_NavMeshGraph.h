@@ -8,6 +8,7 @@
 
 #include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphRenderer.h"
 #include "framework/EliteAI/EliteNavigation/Algorithms/EPathSmoothing.h"
+#include "framework/EliteAI/EliteNavigation/Algorithms/ENavMeshQuery.h"
 
 class NavigationColliderElement;
 class SteeringAgent;
@@ -48,9 +49,13 @@ private:
 
 	// --Pathfinder--
 	std::vector<Elite::Vector2> m_vPath;
+	Elite::NavMeshQuery m_NavMeshQuery{ nullptr };
 
 	// --Graph--
 	Elite::NavGraph* m_pNavGraph = nullptr;
+	int m_DynamicObstacleId = -1;
+	float m_NavMeshTileSize = 30.0f;
+	float m_TileStreamRadius = 35.0f;
 	Elite::GraphRenderer m_GraphRenderer{};
 
 	// --Debug drawing information--
@@ -61,7 +66,11 @@ private:
 	static bool sDrawPortals;
 	static bool sDrawFinalPath;
 	static bool sDrawNonOptimisedPath;
+	static bool sToggleObstacle;
+	static bool sUseTiledNavMesh;
+	static bool sStreamTiles;
 
+	void CreateNavGraph();
 	void UpdateImGui();
 private:
 	//C++ make the class non-copyable
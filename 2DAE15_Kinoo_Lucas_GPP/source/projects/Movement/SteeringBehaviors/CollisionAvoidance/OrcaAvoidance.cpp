@@ -0,0 +1,219 @@
+#include "stdafx.h"
+#include "OrcaAvoidance.h"
+#include "projects/Shared/KinematicAgentPool.h"
+
+using namespace Elite;
+
+namespace
+{
+	const float Epsilon{ 0.00001f };
+}
+
+OrcaAvoidance::OrcaAvoidance(float agentRadius, float neighborRadius, float timeHorizon /*= 1.f*/, int maxNrOfNeighbors /*= 10*/)
+	: m_AgentRadius{ agentRadius }
+	, m_TimeHorizon{ max(timeHorizon, 0.01f) }
+	, m_MaxNrOfNeighbors{ Clamp(maxNrOfNeighbors, 0, MaxNrOfNeighbors) }
+	, m_SpatialHash{ neighborRadius }
+{
+}
+
+void OrcaAvoidance::Solve(const KinematicAgentPool& pool, const Vector2* pPreferredVelocities, Vector2* pSafeVelocities, float deltaT)
+{
+	m_SpatialHash.Rebuild(pool.GetPositionsX(), pool.GetPositionsY(), pool.GetSize());
+
+	const int blockSize{ 256 };
+	JOBSYSTEM->ParallelFor(pool.GetSize(), blockSize, [this, &pool, pPreferredVelocities, pSafeVelocities, deltaT](int begin, int end, int)
+		{
+			for (int idx{ begin }; idx < end; ++idx)
+				pSafeVelocities[idx] = SolveAgent(pool, idx, pPreferredVelocities[idx], deltaT);
+		});
+}
+
+Vector2 OrcaAvoidance::SolveAgent(const KinematicAgentPool& pool, int agentIdx, const Vector2& preferredVelocity, float deltaT) const
+{
+	const Vector2 position{ pool.GetPosition(agentIdx) };
+	const Vector2 velocity{ pool.GetLinearVelocity(agentIdx) };
+	const float maxSpeed{ pool.GetMaxLinearSpeed(agentIdx) };
+
+	std::array<int, MaxNrOfNeighbors> neighbors;
+	const int nrOfNeighbors{ m_SpatialHash.QueryNearest(position, m_SpatialHash.GetCellSize(), agentIdx, m_MaxNrOfNeighbors, neighbors.data()) };
+
+	// A half plane per neighbor: the velocities that leave the velocity obstacle (the relative velocities that collide within the
+	// time horizon, a truncated cone) along the shortest way out u. This agent takes half of u, the neighbor the other half.
+	const float invTimeHorizon{ 1.f / m_TimeHorizon };
+	const float combinedRadius{ 2.f * m_AgentRadius };
+	const float combinedRadiusSquared{ combinedRadius * combinedRadius };
+	Lines lines;
+	for (int neighborIdx{ 0 }; neighborIdx < nrOfNeighbors; ++neighborIdx)
+	{
+		const int otherIdx{ neighbors[neighborIdx] };
+		const Vector2 relativePosition{ pool.GetPosition(otherIdx) - position };
+		const Vector2 relativeVelocity{ velocity - pool.GetLinearVelocity(otherIdx) };
+		const float distanceSquared{ relativePosition.MagnitudeSquared() };
+
+		Line& line{ lines[neighborIdx] };
+		Vector2 u{};
+		if (distanceSquared > combinedRadiusSquared)
+		{
+			// From the center of the cut off circle of the cone to the relative velocity
+			const Vector2 w{ relativeVelocity - invTimeHorizon * relativePosition };
+			const float wLengthSquared{ w.MagnitudeSquared() };
+			const float dotProduct{ w.Dot(relativePosition) };
+
+			if (dotProduct < 0.f && dotProduct * dotProduct > combinedRadiusSquared * wLengthSquared)
+			{
+				// Closest to the cut off circle
+				const float wLength{ sqrtf(wLengthSquared) };
+				const Vector2 unitW{ w / wLength };
+				line.direction = Vector2{ unitW.y, -unitW.x };
+				u = (combinedRadius * invTimeHorizon - wLength) * unitW;
+			}
+			else
+			{
+				// Closest to one of the legs of the cone
+				const float leg{ sqrtf(distanceSquared - combinedRadiusSquared) };
+				if (relativePosition.Cross(w) > 0.f)
+				{
+					line.direction = Vector2{ relativePosition.x * leg - relativePosition.y * combinedRadius, relativePosition.x * combinedRadius + relativePosition.y * leg } / distanceSquared;
+				}
+				else
+				{
+					line.direction = -Vector2{ relativePosition.x * leg + relativePosition.y * combinedRadius, -relativePosition.x * combinedRadius + relativePosition.y * leg } / distanceSquared;
+				}
+				u = relativeVelocity.Dot(line.direction) * line.direction - relativeVelocity;
+			}
+		}
+		else
+		{
+			// Overlapping already: get apart within this frame
+			const float invDeltaT{ 1.f / deltaT };
+			const Vector2 w{ relativeVelocity - invDeltaT * relativePosition };
+			const float wLength{ w.Magnitude() };
+			const Vector2 unitW{ wLength > 0.f ? w / wLength : Vector2{ 1.f, 0.f } };
+			line.direction = Vector2{ unitW.y, -unitW.x };
+			u = (combinedRadius * invDeltaT - wLength) * unitW;
+		}
+		line.point = velocity + 0.5f * u;
+	}
+
+	Vector2 result{};
+	const int failedLine{ SolveInPlanes(lines.data(), nrOfNeighbors, maxSpeed, preferredVelocity, false, result) };
+	if (failedLine < nrOfNeighbors)
+		SolveLeastViolating(lines.data(), nrOfNeighbors, failedLine, maxSpeed, result);
+	return result;
+}
+
+bool OrcaAvoidance::SolveOnLine(const Line* pLines, int lineIdx, float maxSpeed, const Vector2& optimum, bool isDirection, Vector2& result)
+{
+	// The part of the line within the max speed circle, cut by the lines before it
+	const Line& line{ pLines[lineIdx] };
+	const float dotProduct{ line.point.Dot(line.direction) };
+	const float discriminant{ dotProduct * dotProduct + maxSpeed * maxSpeed - line.point.MagnitudeSquared() };
+	if (discriminant < 0.f)
+		return false;
+
+	const float sqrtDiscriminant{ sqrtf(discriminant) };
+	float tLeft{ -dotProduct - sqrtDiscriminant };
+	float tRight{ -dotProduct + sqrtDiscriminant };
+	for (int otherIdx{ 0 }; otherIdx < lineIdx; ++otherIdx)
+	{
+		const Line& other{ pLines[otherIdx] };
+		const float denominator{ line.direction.Cross(other.direction) };
+		const float numerator{ other.direction.Cross(line.point - other.point) };
+
+		// Parallel lines: all or nothing
+		if (fabsf(denominator) <= Epsilon)
+		{
+			if (numerator < 0.f)
+				return false;
+			continue;
+		}
+
+		const float t{ numerator / denominator };
+		if (denominator >= 0.f)
+			tRight = min(tRight, t);
+		else
+			tLeft = max(tLeft, t);
+
+		if (tLeft > tRight)
+			return false;
+	}
+
+	if (isDirection)
+	{
+		result = line.point + (optimum.Dot(line.direction) > 0.f ? tRight : tLeft) * line.direction;
+		return true;
+	}
+
+	const float t{ Clamp(line.direction.Dot(optimum - line.point), tLeft, tRight) };
+	result = line.point + t * line.direction;
+	return true;
+}
+
+int OrcaAvoidance::SolveInPlanes(const Line* pLines, int nrOfLines, float maxSpeed, const Vector2& optimum, bool isDirection, Vector2& result)
+{
+	// Start at the optimum within the max speed, then every line it violates moves it onto that line (randomized incremental, in order)
+	if (isDirection)
+		result = optimum * maxSpeed;
+	else if (optimum.MagnitudeSquared() > maxSpeed * maxSpeed)
+		result = optimum.GetNormalized() * maxSpeed;
+	else
+		result = optimum;
+
+	for (int lineIdx{ 0 }; lineIdx < nrOfLines; ++lineIdx)
+	{
+		if (pLines[lineIdx].direction.Cross(pLines[lineIdx].point - result) <= 0.f)
+			continue;
+
+		const Vector2 previousResult{ result };
+		if (!SolveOnLine(pLines, lineIdx, maxSpeed, optimum, isDirection, result))
+		{
+			result = previousResult;
+			return lineIdx;
+		}
+	}
+	return nrOfLines;
+}
+
+void OrcaAvoidance::SolveLeastViolating(const Line* pLines, int nrOfLines, int firstFailedLine, float maxSpeed, Vector2& result)
+{
+	// No velocity satisfies all lines: minimize the largest distance into the forbidden side, a linear program one dimension up,
+	// solved as a 2D one per violated line on the bisectors with the lines before it
+	float distance{ 0.f };
+	Lines projectedLines;
+	for (int lineIdx{ firstFailedLine }; lineIdx < nrOfLines; ++lineIdx)
+	{
+		const Line& line{ pLines[lineIdx] };
+		if (line.direction.Cross(line.point - result) <= distance)
+			continue;
+
+		int nrOfProjectedLines{ 0 };
+		for (int otherIdx{ 0 }; otherIdx < lineIdx; ++otherIdx)
+		{
+			const Line& other{ pLines[otherIdx] };
+			Line& projectedLine{ projectedLines[nrOfProjectedLines] };
+			const float determinant{ line.direction.Cross(other.direction) };
+			if (fabsf(determinant) <= Epsilon)
+			{
+				// Parallel in the same direction: the other line is never the worse one
+				if (line.direction.Dot(other.direction) > 0.f)
+					continue;
+				projectedLine.point = 0.5f * (line.point + other.point);
+			}
+			else
+			{
+				projectedLine.point = line.point + (other.direction.Cross(line.point - other.point) / determinant) * line.direction;
+			}
+			projectedLine.direction = (other.direction - line.direction).GetNormalized();
+			++nrOfProjectedLines;
+		}
+
+		const Vector2 previousResult{ result };
+		if (SolveInPlanes(projectedLines.data(), nrOfProjectedLines, maxSpeed, Vector2{ -line.direction.y, line.direction.x }, true, result) < nrOfProjectedLines)
+		{
+			// Can only fail by rounding, the result was already as good as it gets
+			result = previousResult;
+		}
+		distance = line.direction.Cross(line.point - result);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "../SpacePartitioning/SpacePartitioning.h"
+
+class KinematicAgentPool;
+
+//ORCA (optimal reciprocal collision avoidance): runs after the steering and turns the velocity every agent wants into the closest velocity
+//that doesn't hit a neighbor within the time horizon, trusting the neighbors to take half of the avoiding.
+//Every neighbor gives a half plane of allowed velocities, a small linear program picks the velocity in all of them (and under the max speed)
+//closest to the preferred one. When the half planes leave no room, the velocity that violates them the least is taken.
+//The agents are solved in parallel, they only read the positions and velocities of the pool.
+class OrcaAvoidance final
+{
+public:
+	static const int MaxNrOfNeighbors = SpatialHash::MaxNrOfNearest;
+
+	OrcaAvoidance(float agentRadius, float neighborRadius, float timeHorizon = 1.f, int maxNrOfNeighbors = 10);
+
+	//pPreferredVelocities in, pSafeVelocities out, pool.GetSize() each. They may be the same array.
+	//Rebuilds the spatial index from the pool, then solves every agent on the job system.
+	void Solve(const KinematicAgentPool& pool, const Elite::Vector2* pPreferredVelocities, Elite::Vector2* pSafeVelocities, float deltaT);
+
+	float GetAgentRadius() const { return m_AgentRadius; }
+	void SetAgentRadius(float agentRadius) { m_AgentRadius = agentRadius; }
+	float GetTimeHorizon() const { return m_TimeHorizon; }
+	void SetTimeHorizon(float timeHorizon) { m_TimeHorizon = max(timeHorizon, 0.01f); }
+	int GetMaxNrOfNeighbors() const { return m_MaxNrOfNeighbors; }
+	void SetMaxNrOfNeighbors(int maxNrOfNeighbors) { m_MaxNrOfNeighbors = Elite::Clamp(maxNrOfNeighbors, 0, MaxNrOfNeighbors); }
+
+private:
+	//Velocities on the left of the line (point + t * direction) are allowed
+	struct Line
+	{
+		Elite::Vector2 point;
+		Elite::Vector2 direction;
+	};
+	using Lines = std::array<Line, MaxNrOfNeighbors>;
+
+	float m_AgentRadius;
+	float m_TimeHorizon;
+	int m_MaxNrOfNeighbors;
+	SpatialHash m_SpatialHash; //Cells of the neighbor radius, rebuilt by every Solve
+
+	Elite::Vector2 SolveAgent(const KinematicAgentPool& pool, int agentIdx, const Elite::Vector2& preferredVelocity, float deltaT) const;
+
+	//The linear programs, on the first nrOfLines lines. Within the circle of maxSpeed, closest to optimum (or furthest in its direction when isDirection)
+	static bool SolveOnLine(const Line* pLines, int lineIdx, float maxSpeed, const Elite::Vector2& optimum, bool isDirection, Elite::Vector2& result);
+	static int SolveInPlanes(const Line* pLines, int nrOfLines, float maxSpeed, const Elite::Vector2& optimum, bool isDirection, Elite::Vector2& result); //Returns the first line that failed, nrOfLines on success
+	static void SolveLeastViolating(const Line* pLines, int nrOfLines, int firstFailedLine, float maxSpeed, Elite::Vector2& result);
+};
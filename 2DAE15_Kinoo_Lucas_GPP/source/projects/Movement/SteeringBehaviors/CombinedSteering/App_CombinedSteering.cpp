@@ -6,18 +6,23 @@
 #include "../SteeringAgent.h"
 #include "CombinedSteeringBehaviors.h"
 #include "projects/Movement/SteeringBehaviors/Obstacle.h"
+#include "projects/Movement/SteeringBehaviors/SpacePartitioning/SpacePartitioning.h"
 
 using namespace Elite;
 App_CombinedSteering::~App_CombinedSteering()
 {
-	SAFE_DELETE(m_pBlendedSteering)
+	SAFE_DELETE(m_pDrunkSteering)
 		SAFE_DELETE(m_pDrunkAgent)
-		SAFE_DELETE(m_pDrunkWander)
 		SAFE_DELETE(m_pEvadingAgent)
 		SAFE_DELETE(m_pEvade)
 		SAFE_DELETE(m_pPrioritySteering)
-		SAFE_DELETE(m_pSeek)
 		SAFE_DELETE(m_pWander)
+		SAFE_DELETE(m_pObstacleAvoidance)
+		SAFE_DELETE(m_pObstacleGrid)
+
+	for (auto& o : m_Obstacles)
+		SAFE_DELETE(o);
+	m_Obstacles.clear();
 }
 
 void App_CombinedSteering::Start()
@@ -25,13 +30,16 @@ void App_CombinedSteering::Start()
 	DEBUGRENDERER2D->GetActiveCamera()->SetZoom(55.0f);
 	DEBUGRENDERER2D->GetActiveCamera()->SetCenter(Elite::Vector2(m_TrimWorldSize / 1.5f, m_TrimWorldSize / 2));
 
-	m_pSeek = new Seek();
-	m_pDrunkWander = new Wander();
-	m_pDrunkWander->SetWanderOffset(0.f);
-	m_pBlendedSteering = new BlendedSteering({ { m_pSeek, 0.5f }, { m_pDrunkWander, 0.5f } });
+	AddObstacles();
+	m_pObstacleAvoidance = new ObstacleAvoidance(m_pObstacleGrid);
+
+	m_pDrunkSteering = new DrunkSteering();
+	m_pDrunkSteering->GetPipelineRef().GetBehaviorRef<0>().SetObstacles(m_pObstacleGrid);
+	m_pDrunkSteering->GetPipelineRef().GetBehaviorRef<1>().GetBehaviorRef<1>().SetWanderOffset(0.f);
+	m_pDrunkSteering->GetPipelineRef().GetBehaviorRef<1>().GetWeightsRef() = { 0.5f, 0.5f };
 
 	m_pDrunkAgent = new SteeringAgent();
-	m_pDrunkAgent->SetSteeringBehavior(m_pBlendedSteering);
+	m_pDrunkAgent->SetSteeringBehavior(m_pDrunkSteering);
 	m_pDrunkAgent->SetMaxLinearSpeed(15.f);
 	m_pDrunkAgent->SetMass(0.f);
 	m_pDrunkAgent->SetAutoOrient(true);
@@ -39,7 +47,7 @@ void App_CombinedSteering::Start()
 
 	m_pEvade = new Evade();
 	m_pWander = new Wander();
-	m_pPrioritySteering = new PrioritySteering({ m_pEvade, m_pWander });
+	m_pPrioritySteering = new PrioritySteering({ m_pObstacleAvoidance, m_pEvade, m_pWander });
 
 	m_pEvadingAgent = new SteeringAgent();
 	m_pEvadingAgent->SetSteeringBehavior(m_pPrioritySteering);
@@ -57,7 +65,7 @@ void App_CombinedSteering::Update(float deltaTime)
 		m_MouseTarget.Position = DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld({ static_cast<float>(mouseData.X), static_cast<float>(mouseData.Y) });
 	}
 
-	m_pSeek->SetTarget(m_MouseTarget);
+	m_pDrunkSteering->GetPipelineRef().GetBehaviorRef<1>().GetBehaviorRef<0>().SetTarget(m_MouseTarget);
 	m_pDrunkAgent->Update(deltaTime);
 	m_pDrunkAgent->SetRenderBehavior(m_CanDebugRender);
 
@@ -131,8 +139,9 @@ void App_CombinedSteering::Update(float deltaTime)
 		ImGui::Text("Behavior Weights");
 		ImGui::Spacing();
 
-		ImGui::SliderFloat("Seek", &m_pBlendedSteering->GetWeightedBehaviorsRef()[0].weight, 0.f, 1.f, "%.2");
-		ImGui::SliderFloat("Wander", &m_pBlendedSteering->GetWeightedBehaviorsRef()[1].weight, 0.f, 1.f, "%.2");
+		auto& drunkWeights = m_pDrunkSteering->GetPipelineRef().GetBehaviorRef<1>().GetWeightsRef();
+		ImGui::SliderFloat("Seek", &drunkWeights[0], 0.f, 1.f, "%.2");
+		ImGui::SliderFloat("Wander", &drunkWeights[1], 0.f, 1.f, "%.2");
 
 		//End
 		ImGui::PopAllowKeyboardFocus();
@@ -147,6 +156,9 @@ void App_CombinedSteering::Render(float deltaTime) const
 	m_pDrunkAgent->Render(deltaTime);
 	m_pEvadingAgent->Render(deltaTime);
 
+	if (m_CanDebugRender)
+		m_pObstacleGrid->RenderCells();
+
 	if (m_TrimWorld)
 	{
 		RenderWorldBounds(m_TrimWorldSize);
@@ -156,3 +168,23 @@ void App_CombinedSteering::Render(float deltaTime) const
 	if (m_VisualizeMouseTarget)
 		DEBUGRENDERER2D->DrawSolidCircle(m_MouseTarget.Position, 0.3f, { 0.f,0.f }, { 1.f,0.f,0.f }, -0.8f);
 }
+
+void App_CombinedSteering::AddObstacles()
+{
+	//Random obstacles in the world that don't touch, the grid is built once
+	for (int tries{ 0 }; tries < 200 && static_cast<int>(m_Obstacles.size()) < m_NrOfObstacles; ++tries)
+	{
+		const float radius{ randomFloat(1.f, 2.5f) };
+		const Vector2 center{ randomVector2(radius, m_TrimWorldSize - radius) };
+
+		bool isFree{ true };
+		for (const auto& obstacle : m_Obstacles)
+			isFree = isFree && Distance(center, obstacle->GetCenter()) > radius + obstacle->GetRadius() + 3.f;
+
+		if (isFree)
+			m_Obstacles.push_back(new Obstacle(center, radius));
+	}
+
+	m_pObstacleGrid = new ObstacleGrid(5.f);
+	m_pObstacleGrid->Build(m_Obstacles);
+}
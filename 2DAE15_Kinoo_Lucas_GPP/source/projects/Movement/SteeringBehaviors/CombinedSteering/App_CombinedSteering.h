@@ -5,10 +5,12 @@
 //-----------------------------------------------------------------
 #include "framework/EliteInterfaces/EIApp.h"
 #include "projects/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
+#include "ComposedSteering.h"
 
 class SteeringAgent;
-class BlendedSteering;
 class PrioritySteering;
+class Obstacle;
+class ObstacleGrid;
 
 //-----------------------------------------------------------------
 // Application
@@ -38,14 +40,21 @@ private:
 	SteeringAgent* m_pDrunkAgent{ nullptr };
 	SteeringAgent* m_pEvadingAgent{ nullptr };
 
-	// Blended Steering
-	BlendedSteering* m_pBlendedSteering{ nullptr };
-	Seek* m_pSeek{ nullptr };
-	Wander* m_pDrunkWander{ nullptr };
+	// Blended steering behind obstacle avoidance, composed at compile time
+	using DrunkSteering = ComposedSteering<Priority<ObstacleAvoidance, Blend<Weighted<Seek>, Weighted<Wander>>>>;
+	DrunkSteering* m_pDrunkSteering{ nullptr };
 
 	// Priority steering
 	PrioritySteering* m_pPrioritySteering{ nullptr };
 	Evade* m_pEvade{ nullptr };
 	Wander* m_pWander{ nullptr };
+
+	// Obstacle avoidance, first priority of both agents
+	std::vector<Obstacle*> m_Obstacles{};
+	ObstacleGrid* m_pObstacleGrid{ nullptr };
+	ObstacleAvoidance* m_pObstacleAvoidance{ nullptr };
+	const int m_NrOfObstacles{ 6 };
+
+	void AddObstacles();
 };
 #endif
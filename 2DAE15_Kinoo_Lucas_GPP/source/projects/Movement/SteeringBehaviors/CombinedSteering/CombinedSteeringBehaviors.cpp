@@ -1,8 +1,92 @@
 #include "stdafx.h"
 #include "CombinedSteeringBehaviors.h"
 #include <algorithm>
+#include <deque>
 #include "../SteeringAgent.h"
 
+namespace
+{
+	//Scratch buffers of the batched combined behaviors. Combined behaviors can contain combined behaviors, so there is a set per
+	//nesting level. Also one per thread, the same behavior can be evaluated by multiple threads. Only grows, no allocations once big enough.
+	struct BatchScratch
+	{
+		std::vector<SteeringOutput> outputs;
+		std::vector<int> agentIndices;
+		std::vector<float> positionsX, positionsY, linearVelocitiesX, linearVelocitiesY, orientations, maxLinearSpeeds;
+		std::vector<SteeringState> states;
+		std::vector<SteeringAgent*> agents;
+	};
+	thread_local std::deque<BatchScratch> g_BatchScratches; //deque, growing it keeps the references to the other levels valid
+	thread_local size_t g_BatchDepth = 0;
+
+	//Scratch of the current nesting level while it is in scope
+	class ScopedBatchScratch final
+	{
+	public:
+		ScopedBatchScratch()
+		{
+			if (g_BatchScratches.size() <= g_BatchDepth)
+				g_BatchScratches.emplace_back();
+			m_pScratch = &g_BatchScratches[g_BatchDepth++];
+		}
+		~ScopedBatchScratch() { --g_BatchDepth; }
+
+		BatchScratch& Get() const { return *m_pScratch; }
+
+	private:
+		BatchScratch* m_pScratch = nullptr;
+	};
+
+	//Copies the agents with the given indices into the scratch arrays, so they can be passed as one span.
+	//The steering states are changed by the behaviors, ScatterStates writes them back.
+	AgentSpan GatherAgents(const AgentSpan& agents, BatchScratch& scratch)
+	{
+		const size_t count{ scratch.agentIndices.size() };
+		scratch.positionsX.resize(count);
+		scratch.positionsY.resize(count);
+		scratch.linearVelocitiesX.resize(count);
+		scratch.linearVelocitiesY.resize(count);
+		scratch.orientations.resize(count);
+		scratch.maxLinearSpeeds.resize(count);
+		scratch.agents.resize(count);
+		scratch.states.resize(agents.pStates ? count : 0);
+		for (size_t idx{ 0 }; idx < count; ++idx)
+		{
+			const int agentIdx{ scratch.agentIndices[idx] };
+			scratch.positionsX[idx] = agents.pPositionsX[agentIdx];
+			scratch.positionsY[idx] = agents.pPositionsY[agentIdx];
+			scratch.linearVelocitiesX[idx] = agents.pLinearVelocitiesX[agentIdx];
+			scratch.linearVelocitiesY[idx] = agents.pLinearVelocitiesY[agentIdx];
+			scratch.orientations[idx] = agents.pOrientations[agentIdx];
+			scratch.maxLinearSpeeds[idx] = agents.pMaxLinearSpeeds[agentIdx];
+			scratch.agents[idx] = agents.ppAgents ? agents.ppAgents[agentIdx] : nullptr;
+			if (agents.pStates)
+				scratch.states[idx] = agents.pStates[agentIdx];
+		}
+
+		AgentSpan gathered{};
+		gathered.pPositionsX = scratch.positionsX.data();
+		gathered.pPositionsY = scratch.positionsY.data();
+		gathered.pLinearVelocitiesX = scratch.linearVelocitiesX.data();
+		gathered.pLinearVelocitiesY = scratch.linearVelocitiesY.data();
+		gathered.pOrientations = scratch.orientations.data();
+		gathered.pMaxLinearSpeeds = scratch.maxLinearSpeeds.data();
+		gathered.ppAgents = agents.ppAgents ? scratch.agents.data() : nullptr;
+		gathered.pStates = agents.pStates ? scratch.states.data() : nullptr;
+		gathered.Count = static_cast<int>(count);
+		return gathered;
+	}
+
+	void ScatterStates(const AgentSpan& agents, const BatchScratch& scratch)
+	{
+		if (!agents.pStates)
+			return;
+
+		for (size_t idx{ 0 }; idx < scratch.agentIndices.size(); ++idx)
+			agents.pStates[scratch.agentIndices[idx]] = scratch.states[idx];
+	}
+}
+
 BlendedSteering::BlendedSteering(std::vector<WeightedBehavior> weightedBehaviors)
 	:m_WeightedBehaviors(weightedBehaviors)
 {
@@ -15,7 +99,7 @@ SteeringOutput BlendedSteering::CalculateSteering(float deltaT, SteeringAgent* p
 	SteeringOutput blendedSteering = {};
 	auto totalWeight = 0.f;
 
-	for (auto weightedBehavior : m_WeightedBehaviors)
+	for (const auto& weightedBehavior : m_WeightedBehaviors)
 	{
 		auto steering = weightedBehavior.pBehavior->CalculateSteering(deltaT, pAgent);
 		blendedSteering.LinearVelocity += weightedBehavior.weight * steering.LinearVelocity;
@@ -30,12 +114,42 @@ SteeringOutput BlendedSteering::CalculateSteering(float deltaT, SteeringAgent* p
 		blendedSteering *= scale;
 	}
 
-	if (pAgent->CanRenderBehavior())
+	if (ELITE_STEERING_DEBUG_RENDERING && pAgent->CanRenderBehavior())
 		DEBUGRENDERER2D->DrawDirection(pAgent->GetPosition(), blendedSteering.LinearVelocity, 7, { 0, 1, 1 }, 0.40f);
 
 	return blendedSteering;
 }
 
+void BlendedSteering::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	ScopedBatchScratch scopedScratch{};
+	std::vector<SteeringOutput>& steerings{ scopedScratch.Get().outputs };
+	steerings.resize(agents.Count);
+
+	std::fill(pOutputs, pOutputs + agents.Count, SteeringOutput{});
+	auto totalWeight = 0.f;
+
+	//One call per behavior for all agents, then the same sums as CalculateSteering
+	for (const auto& weightedBehavior : m_WeightedBehaviors)
+	{
+		weightedBehavior.pBehavior->CalculateSteeringBatch(deltaT, agents, steerings.data());
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+		{
+			pOutputs[idx].LinearVelocity += weightedBehavior.weight * steerings[idx].LinearVelocity;
+			pOutputs[idx].AngularVelocity += weightedBehavior.weight * steerings[idx].AngularVelocity;
+		}
+
+		totalWeight += weightedBehavior.weight;
+	}
+
+	if (totalWeight > 0.f)
+	{
+		auto scale = 1.f / totalWeight;
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+			pOutputs[idx] *= scale;
+	}
+}
+
 //*****************
 //PRIORITY STEERING
 SteeringOutput PrioritySteering::CalculateSteering(float deltaT, SteeringAgent* pAgent)
@@ -53,3 +167,43 @@ SteeringOutput PrioritySteering::CalculateSteering(float deltaT, SteeringAgent*
 	//If non of the behavior return a valid output, last behavior is returned
 	return steering;
 }
+
+void PrioritySteering::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	if (m_PriorityBehaviors.empty())
+	{
+		std::fill(pOutputs, pOutputs + agents.Count, SteeringOutput{});
+		return;
+	}
+
+	//The first behavior for all agents, every next behavior only for the agents without a valid steering yet
+	m_PriorityBehaviors.front()->CalculateSteeringBatch(deltaT, agents, pOutputs);
+
+	ScopedBatchScratch scopedScratch{};
+	BatchScratch& scratch{ scopedScratch.Get() };
+	scratch.agentIndices.clear();
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		if (!pOutputs[idx].IsValid)
+			scratch.agentIndices.push_back(idx);
+	}
+
+	for (size_t behaviorIdx{ 1 }; behaviorIdx < m_PriorityBehaviors.size() && !scratch.agentIndices.empty(); ++behaviorIdx)
+	{
+		const AgentSpan remainingAgents{ GatherAgents(agents, scratch) };
+		scratch.outputs.resize(remainingAgents.Count);
+		m_PriorityBehaviors[behaviorIdx]->CalculateSteeringBatch(deltaT, remainingAgents, scratch.outputs.data());
+		ScatterStates(agents, scratch);
+
+		//Scatter the results back, keep the agents that still have no valid steering
+		size_t nrRemaining{ 0 };
+		for (int idx{ 0 }; idx < remainingAgents.Count; ++idx)
+		{
+			const int agentIdx{ scratch.agentIndices[idx] };
+			pOutputs[agentIdx] = scratch.outputs[idx];
+			if (!scratch.outputs[idx].IsValid)
+				scratch.agentIndices[nrRemaining++] = agentIdx;
+		}
+		scratch.agentIndices.resize(nrRemaining);
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <array>
+#include <tuple>
+#include <utility>
+#include "../Steering/SteeringBehaviors.h"
+#include "../SteeringAgent.h"
+
+//Combined steering composed at compile time, e.g. Priority<Evade, Blend<Weighted<Seek>, Weighted<Wander>>>.
+//The combinators hold their behaviors by value and call them by their own type, without virtual dispatch, so the whole
+//pipeline can be inlined. Same results as PrioritySteering and BlendedSteering with the same behaviors and weights.
+//ComposedSteering puts a pipeline behind ISteeringBehavior, for a SteeringAgent: one virtual call per agent for all of it.
+
+//Steering of a part of a pipeline: behaviors are called by their own type, combinators directly
+template<typename TBehavior, typename std::enable_if<std::is_base_of<ISteeringBehavior, TBehavior>::value>::type* = nullptr>
+inline SteeringOutput CalculateComposedSteering(TBehavior& behavior, float deltaT, SteeringAgent* pAgent)
+{
+	return behavior.TBehavior::CalculateSteering(deltaT, pAgent);
+}
+
+template<typename TCombinator, typename std::enable_if<!std::is_base_of<ISteeringBehavior, TCombinator>::value>::type* = nullptr>
+inline SteeringOutput CalculateComposedSteering(TCombinator& combinator, float deltaT, SteeringAgent* pAgent)
+{
+	return combinator.CalculateSteering(deltaT, pAgent);
+}
+
+//**************
+//WEIGHTED
+//A behavior of a Blend, its weight is kept with the other weights in the Blend
+template<typename TBehavior>
+class Weighted final
+{
+public:
+	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) { return CalculateComposedSteering(m_Behavior, deltaT, pAgent); }
+	TBehavior& GetBehaviorRef() { return m_Behavior; }
+
+private:
+	TBehavior m_Behavior{};
+};
+
+//**************
+//BLEND
+template<typename... TWeightedBehaviors>
+class Blend final
+{
+public:
+	static const int NrOfBehaviors = static_cast<int>(sizeof...(TWeightedBehaviors));
+	using Weights = std::array<float, NrOfBehaviors>; //In the order of the behaviors
+
+	Blend() { m_Weights.fill(1.f / NrOfBehaviors); }
+	explicit Blend(const Weights& weights) : m_Weights(weights) {}
+
+	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent)
+	{
+		SteeringOutput blendedSteering = {};
+		float totalWeight{ 0.f };
+		AddSteerings(deltaT, pAgent, blendedSteering, totalWeight, std::index_sequence_for<TWeightedBehaviors...>{});
+
+		if (totalWeight > 0.f)
+		{
+			auto scale = 1.f / totalWeight;
+			blendedSteering *= scale;
+		}
+
+		if (ELITE_STEERING_DEBUG_RENDERING && pAgent->CanRenderBehavior())
+			DEBUGRENDERER2D->DrawDirection(pAgent->GetPosition(), blendedSteering.LinearVelocity, 7, { 0, 1, 1 }, 0.40f);
+
+		return blendedSteering;
+	}
+
+	template<size_t Idx>
+	auto& GetBehaviorRef() { return std::get<Idx>(m_Behaviors).GetBehaviorRef(); }
+	//Plain floats, can be edited in between steerings (an ImGui::SliderFloat per weight)
+	Weights& GetWeightsRef() { return m_Weights; }
+
+private:
+	std::tuple<TWeightedBehaviors...> m_Behaviors{};
+	Weights m_Weights{};
+
+	//A statement per behavior, in order
+	template<size_t... Idx>
+	void AddSteerings(float deltaT, SteeringAgent* pAgent, SteeringOutput& blendedSteering, float& totalWeight, std::index_sequence<Idx...>)
+	{
+		using Expand = int[];
+		(void)Expand{ 0, (AddSteering(std::get<Idx>(m_Behaviors).CalculateSteering(deltaT, pAgent), m_Weights[Idx], blendedSteering, totalWeight), 0)... };
+	}
+
+	static void AddSteering(const SteeringOutput& steering, float weight, SteeringOutput& blendedSteering, float& totalWeight)
+	{
+		blendedSteering.LinearVelocity += weight * steering.LinearVelocity;
+		blendedSteering.AngularVelocity += weight * steering.AngularVelocity;
+		totalWeight += weight;
+	}
+};
+
+//**************
+//PRIORITY
+template<typename... TBehaviors>
+class Priority final
+{
+public:
+	static const int NrOfBehaviors = static_cast<int>(sizeof...(TBehaviors));
+
+	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) { return SteerFrom<0>(deltaT, pAgent); }
+
+	template<size_t Idx>
+	auto& GetBehaviorRef() { return std::get<Idx>(m_Behaviors); }
+
+private:
+	std::tuple<TBehaviors...> m_Behaviors{};
+
+	//The first valid steering from Idx on. If none of the behaviors is valid, the last one is returned
+	template<size_t Idx, typename std::enable_if<(Idx + 1 < sizeof...(TBehaviors))>::type* = nullptr>
+	SteeringOutput SteerFrom(float deltaT, SteeringAgent* pAgent)
+	{
+		const SteeringOutput steering{ CalculateComposedSteering(std::get<Idx>(m_Behaviors), deltaT, pAgent) };
+		return steering.IsValid ? steering : SteerFrom<Idx + 1>(deltaT, pAgent);
+	}
+
+	template<size_t Idx, typename std::enable_if<(Idx + 1 == sizeof...(TBehaviors))>::type* = nullptr>
+	SteeringOutput SteerFrom(float deltaT, SteeringAgent* pAgent)
+	{
+		return CalculateComposedSteering(std::get<Idx>(m_Behaviors), deltaT, pAgent);
+	}
+};
+
+//**************
+//COMPOSED STEERING
+template<typename TPipeline>
+class ComposedSteering final : public ISteeringBehavior
+{
+public:
+	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override { return m_Pipeline.CalculateSteering(deltaT, pAgent); }
+	//Per agent as well (needs agents.ppAgents), but with a single virtual call for the span
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override
+	{
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+			pOutputs[idx] = m_Pipeline.CalculateSteering(deltaT, agents.ppAgents[idx]);
+	}
+
+	TPipeline& GetPipelineRef() { return m_Pipeline; }
+
+private:
+	TPipeline m_Pipeline{};
+
+	using ISteeringBehavior::SetTarget; // made private because targets need to be set on the individual behaviors, not the combined behavior
+};
@@ -21,7 +21,7 @@ void App_Flocking::Start()
 	DEBUGRENDERER2D->GetActiveCamera()->SetZoom(55.0f);
 	DEBUGRENDERER2D->GetActiveCamera()->SetCenter(Elite::Vector2(m_TrimWorldSize / 1.5f, m_TrimWorldSize / 2));
 
-	m_pFlock = new Flock(m_FlockSize, m_TrimWorldSize, m_pAgentToEvade, true);
+	m_pFlock = new Flock(m_FlockSize, m_TrimWorldSize, m_pAgentToEvade, true, m_UseKinematicAgents);
 }
 
 void App_Flocking::Update(float deltaTime)
@@ -34,6 +34,20 @@ void App_Flocking::Update(float deltaTime)
 	}
 
 	m_pFlock->UpdateAndRenderUI();
+
+	//Appended to the window of the flock. The agents are created with or without rigid bodies, so switching builds a new flock.
+	bool windowActive = true;
+	ImGui::Begin("Gameplay Programming", &windowActive, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+	ImGui::Spacing();
+	ImGui::Separator();
+	ImGui::Spacing();
+	if (ImGui::Checkbox("Kinematic agents (no Box2D)", &m_UseKinematicAgents))
+	{
+		SAFE_DELETE(m_pFlock);
+		m_pFlock = new Flock(m_FlockSize, m_TrimWorldSize, m_pAgentToEvade, true, m_UseKinematicAgents);
+	}
+	ImGui::End();
+
 	m_pFlock->Update(deltaTime);
 	if (m_UseMouseTarget)
 		m_pFlock->SetTarget_Seek(m_MouseTarget);
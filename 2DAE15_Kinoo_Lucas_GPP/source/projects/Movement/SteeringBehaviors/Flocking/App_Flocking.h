@@ -32,6 +32,7 @@ private:
 
 	float m_TrimWorldSize = 200.f;
 	int m_FlockSize = 2500;
+	bool m_UseKinematicAgents = false; //Box2D free flock agents (opt-in through the UI), needed for the bigger flocks
 
 	Flock* m_pFlock = nullptr;
 	SteeringAgent* m_pAgentToEvade = nullptr;
@@ -5,19 +5,66 @@
 #include "../Steering/SteeringBehaviors.h"
 #include "../CombinedSteering/CombinedSteeringBehaviors.h"
 #include "../SpacePartitioning/SpacePartitioning.h"
+#include "../CollisionAvoidance/OrcaAvoidance.h"
+#include "../LevelOfDetail/SteeringLod.h"
+#include "projects/Shared/KinematicAgentPool.h"
 
 using namespace Elite;
 
+namespace
+{
+	// Partial selection of the candidates without spatial partitioning: the k nearest first (in any order), returns how many are kept
+	template<typename T, typename GetPosition>
+	int KeepNearest(T* pNeighbors, int nrOfNeighbors, int k, const Vector2& agentPos, GetPosition getPosition)
+	{
+		if (nrOfNeighbors <= k) return nrOfNeighbors;
+
+		std::nth_element(pNeighbors, pNeighbors + k, pNeighbors + nrOfNeighbors, [&agentPos, &getPosition](const T& a, const T& b)
+			{
+				return DistanceSquared(getPosition(a), agentPos) < DistanceSquared(getPosition(b), agentPos);
+			});
+		return k;
+	}
+}
+
+void NeighborhoodSummary::AddNeighbor(const Vector2& agentPos, const SteeringAgent* pNeighbor)
+{
+	const Vector2 neighborPos{ pNeighbor->GetPosition() };
+	CenterOfMass += neighborPos;
+	AverageVelocity += pNeighbor->GetLinearVelocity();
+
+	// Unit vector away from the neighbor divided by the distance, nothing for neighbors on top of the agent
+	const Vector2 toAgent{ agentPos - neighborPos };
+	const float distanceSquared{ toAgent.MagnitudeSquared() };
+	if (distanceSquared > 0.f)
+		Separation += toAgent / distanceSquared;
+
+	++NrOfNeighbors;
+}
+
+void NeighborhoodSummary::Finish(const Vector2& agentPos)
+{
+	if (NrOfNeighbors == 0)
+	{
+		CenterOfMass = agentPos;
+		return;
+	}
+
+	const float invNrOfNeighbors{ 1.f / NrOfNeighbors };
+	CenterOfMass *= invNrOfNeighbors;
+	AverageVelocity *= invNrOfNeighbors;
+}
+
 //Constructor & Destructor
 Flock::Flock(
 	int flockSize /*= 50*/,
 	float worldSize /*= 100.f*/,
 	SteeringAgent* pAgentToEvade /*= nullptr*/,
 
-	bool trimWorld /*= false*/
+	bool trimWorld /*= false*/,
+	bool useKinematicAgents /*= false*/
 )
 	: m_FlockSize{ flockSize }
-	//, m_pCellSpace{ new CellSpace{worldSize, worldSize, 15, 15, flockSize } }
 	, m_TrimWorld{ trimWorld }
 	, m_WorldSize{ worldSize }
 	, m_NeighborhoodRadius{ 15 }
@@ -25,7 +72,9 @@ Flock::Flock(
 	, m_pAgentToEvade{ pAgentToEvade }
 {
 	m_Agents.resize(m_FlockSize);
+	m_SteeringStates.reserve(m_FlockSize);
 	m_Neighbors.resize(m_FlockSize);
+	m_NeighborIndices.resize(m_FlockSize);
 
 	m_pCohesionBehavior = new Cohesion(this);
 	m_pEvadeBehavior = new Evade();
@@ -38,19 +87,32 @@ Flock::Flock(
 	m_pBlendedSteering = new BlendedSteering({ { m_pCohesionBehavior,0.25f }, { m_pSeparationBehavior,0.25f }, { m_pVelMatchBehavior,0.25f },{m_pWanderBehavior,0.25f },{m_pSeekBehavior,0.25f} });
 	m_pPrioritySteering = new PrioritySteering({ m_pEvadeBehavior, m_pBlendedSteering });
 
-	m_pCellSpace = new CellSpace{ worldSize, worldSize, static_cast<int>(m_QueryRadius) * 2, static_cast<int>(m_QueryRadius) * 2, flockSize };
+	m_pSpatialHash = new SpatialHash{ m_NeighborhoodRadius, max(flockSize, 1024) };
+	m_pQuadtree = new LooseQuadtree{ ZeroVector2, m_WorldSize, m_NeighborhoodRadius };
+
+	if (useKinematicAgents)
+	{
+		m_pKinematicPool = new KinematicAgentPool();
+		m_pKinematicPool->Reserve(m_FlockSize);
+
+		m_Neighborhoods.resize(m_FlockSize);
+		m_SteeringOutputs.resize(m_FlockSize);
+		m_ThreadNeighbors.resize(JOBSYSTEM->GetNrOfThreads());
+		m_AvoidanceVelocities.resize(m_FlockSize);
+		m_pLod = new SteeringLod();
+	}
 
 	for (int idx{ 0 }; idx < m_FlockSize; ++idx)
 	{
-		m_Agents[idx] = new SteeringAgent();
+		m_Agents[idx] = m_pKinematicPool ? new SteeringAgent(m_pKinematicPool) : new SteeringAgent();
 		m_Agents[idx]->SetAutoOrient(true);
 		m_Agents[idx]->SetMaxLinearSpeed(50.0f);
 		m_Agents[idx]->SetMass(0.f);
-		m_Agents[idx]->SetPosition({ static_cast<float>(rand() % static_cast<int>(m_WorldSize)), static_cast<float>(rand() % static_cast<int>(m_WorldSize)) });
+		m_Agents[idx]->SetPosition({ static_cast<float>(randomInt(static_cast<int>(m_WorldSize))), static_cast<float>(randomInt(static_cast<int>(m_WorldSize))) });
 		m_Agents[idx]->SetSteeringBehavior(m_pPrioritySteering);
 
-		m_pCellSpace->AddAgent(m_Agents[idx]);
-		m_OldPos.push_back(m_Agents[idx]->GetPosition());
+		m_SteeringStates.emplace_back(static_cast<unsigned int>(idx));
+		m_Agents[idx]->SetSteeringState(&m_SteeringStates.back());
 	}
 
 	m_pAgentToEvade = new SteeringAgent();
@@ -58,7 +120,7 @@ Flock::Flock(
 	m_pAgentToEvade->SetBodyColor({ 1, 0, 0 });
 	m_pAgentToEvade->SetMaxLinearSpeed(50.0f);
 	m_pAgentToEvade->SetMass(0.f);
-	m_pAgentToEvade->SetPosition({ static_cast<float>(rand() % static_cast<int>(m_WorldSize)), static_cast<float>(rand() % static_cast<int>(m_WorldSize)) });
+	m_pAgentToEvade->SetPosition({ static_cast<float>(randomInt(static_cast<int>(m_WorldSize))), static_cast<float>(randomInt(static_cast<int>(m_WorldSize))) });
 	m_pAgentToEvade->SetSteeringBehavior(m_pEvadingAgentSeekBehavior);
 }
 
@@ -66,7 +128,10 @@ Flock::~Flock()
 {
 	SAFE_DELETE(m_pAgentToEvade)
 		SAFE_DELETE(m_pBlendedSteering)
-		SAFE_DELETE(m_pCellSpace)
+		SAFE_DELETE(m_pSpatialHash)
+		SAFE_DELETE(m_pQuadtree)
+		SAFE_DELETE(m_pAvoidance)
+		SAFE_DELETE(m_pLod)
 		SAFE_DELETE(m_pCohesionBehavior)
 		SAFE_DELETE(m_pEvadeBehavior)
 		SAFE_DELETE(m_pEvadingAgentSeekBehavior)
@@ -82,64 +147,291 @@ Flock::~Flock()
 		}
 
 	m_Agents.clear();
+	SAFE_DELETE(m_pKinematicPool)
 }
 void Flock::Update(float deltaT)
 {
+	const auto start = std::chrono::high_resolution_clock::now();
 	m_pEvadeBehavior->SetTarget(m_pAgentToEvade->GetPosition());
 
-	int oldPosIdx{ 0 };
+	if (m_pKinematicPool && m_TrimWorld)
+	{
+		m_pKinematicPool->TrimToWorld({ 0, 0 }, { m_WorldSize, m_WorldSize });
+	}
 
-	for (SteeringAgent* pAgent : m_Agents)
+	// Neighbors are looked up among the positions at the start of the frame
+	if (m_SpatialPartitioning && m_UseQuadtree)
 	{
-		if (pAgent == nullptr) continue;
+		m_pQuadtree->Rebuild(m_Agents);
+	}
+	else if (m_SpatialPartitioning)
+	{
+		m_pSpatialHash->Rebuild(m_Agents);
+	}
 
-		if (m_TrimWorld)
+	if (IsUpdatingInParallel())
+	{
+		UpdateParallel(deltaT);
+	}
+	else
+	{
+		for (SteeringAgent* pAgent : m_Agents)
 		{
-			pAgent->TrimToWorld(m_WorldSize);
-		}
+			if (pAgent == nullptr) continue;
 
-		pAgent->Update(deltaT);
+			if (m_TrimWorld && !m_pKinematicPool)
+			{
+				pAgent->TrimToWorld(m_WorldSize);
+			}
 
-		if (m_SpatialPartitioning)
-		{
-			m_pCellSpace->RegisterNeighbors(pAgent, m_QueryRadius);
-			m_pCellSpace->UpdateAgentCell(pAgent, m_OldPos[oldPosIdx]);
-			m_OldPos[oldPosIdx++] = pAgent->GetPosition();
-		}
-		else
-		{
 			RegisterNeighbors(pAgent);
-		}
+			pAgent->Update(deltaT);
 
-		pAgent->SetRenderBehavior(m_DebugRenderSteering);
+			pAgent->SetRenderBehavior(m_DebugRenderSteering);
 
-		if (pAgent != m_Agents.back()) continue;
+			if (pAgent != m_Agents.back()) continue;
 
-		// Only execute the code below if the agent is the last one in the vector
-		pAgent->SetRenderBehavior(m_DebugRenderNeighborhood);
+			// Only execute the code below if the agent is the last one in the vector
+			pAgent->SetRenderBehavior(m_DebugRenderNeighborhood);
 
-		if (!m_DebugRenderNeighborhood) continue;
+			if (!m_DebugRenderNeighborhood) continue;
 
-		DEBUGRENDERER2D->DrawCircle(pAgent->GetPosition(), m_NeighborhoodRadius, { 1.f, 1.f, 1.f, 0.5f }, 0.f);
-		DEBUGRENDERER2D->DrawDirection(pAgent->GetPosition(), this->GetAverageNeighborPos(), 7, { 1.f, 0.f, 0.f });
+			DEBUGRENDERER2D->DrawCircle(pAgent->GetPosition(), m_NeighborhoodRadius, { 1.f, 1.f, 1.f, 0.5f }, 0.f);
+			DEBUGRENDERER2D->DrawDirection(pAgent->GetPosition(), m_Neighborhood.CenterOfMass, 7, { 1.f, 0.f, 0.f });
 
-		for (const auto& neighbor : m_Neighbors)
-		{
-			if (neighbor == nullptr) continue;
-			neighbor->SetBodyColor({ 0.f, 1.f, 0.f });
+			for (const auto& neighbor : m_Neighbors)
+			{
+				if (neighbor == nullptr) continue;
+				neighbor->SetBodyColor({ 0.f, 1.f, 0.f });
+			}
 		}
 	}
 
+	// Kinematic agents are not moved by the physics world, move them all at once
+	if (m_pKinematicPool)
+	{
+		m_pKinematicPool->Integrate(deltaT);
+	}
+
 	if (m_pAgentToEvade)
 	{
 		m_pAgentToEvade->Update(deltaT);
 		m_pAgentToEvade->TrimToWorld(m_WorldSize);
 	}
+
+	m_UpdateMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 }
+
+void Flock::UpdateParallel(float deltaT)
+{
+	// Read phase: nothing writes the pool, every agent only writes its own neighborhood and steering output
+	const int nrAgents{ static_cast<int>(m_Agents.size()) };
+	const int blockSize{ m_UpdateBlockSize };
+	if (m_UseLod)
+	{
+		SteerScheduledAgents(deltaT);
+	}
+	else
+	{
+		SteerAllAgents(deltaT, blockSize);
+	}
+
+	// Avoidance phase: the velocities the steering wants become velocities that don't collide, still reading the pool only.
+	// Agents that didn't steer this frame want what they wanted last time
+	if (m_CollisionAvoidance)
+	{
+		if (!m_pAvoidance)
+			m_pAvoidance = new OrcaAvoidance{ m_Agents[0]->GetRadius(), m_NeighborhoodRadius, 0.5f };
+
+		for (int idx{ 0 }; idx < nrAgents; ++idx)
+			m_AvoidanceVelocities[idx] = m_SteeringOutputs[idx].LinearVelocity;
+		m_pAvoidance->Solve(*m_pKinematicPool, m_AvoidanceVelocities.data(), m_AvoidanceVelocities.data(), deltaT);
+	}
+
+	// Apply phase: every agent only writes its own slot of the pool
+	JOBSYSTEM->ParallelFor(nrAgents, blockSize, [this, deltaT](int begin, int end, int)
+		{
+			for (int idx{ begin }; idx < end; ++idx)
+			{
+				// ORCA counts on the agents taking the safe velocity right away, steering towards it would still collide
+				if (m_CollisionAvoidance)
+				{
+					m_Agents[idx]->SetLinearVelocity(m_AvoidanceVelocities[idx]);
+					m_SteeringOutputs[idx].LinearVelocity = m_AvoidanceVelocities[idx];
+				}
+				if (!m_UseLod)
+					m_Agents[idx]->ApplySteering(m_SteeringOutputs[idx], deltaT);
+			}
+		});
+
+	// With level of detail only the scheduled agents steer, over the time since they steered last. The others keep their velocity
+	if (m_UseLod)
+	{
+		const std::vector<int>& scheduledAgents{ m_pLod->GetScheduledAgents() };
+		JOBSYSTEM->ParallelFor(static_cast<int>(scheduledAgents.size()), blockSize, [this, &scheduledAgents](int begin, int end, int)
+			{
+				for (int idx{ begin }; idx < end; ++idx)
+				{
+					const int agentIdx{ scheduledAgents[idx] };
+					m_Agents[agentIdx]->ApplySteering(m_SteeringOutputs[agentIdx], m_pLod->GetElapsedTime(agentIdx));
+				}
+			});
+	}
+
+	if (!m_DebugRenderNeighborhood) return;
+
+	SteeringAgent* pLastAgent{ m_Agents.back() };
+	std::vector<int>& neighbors{ m_ThreadNeighbors[0] };
+	QueryNeighbors(static_cast<int>(m_Agents.size()) - 1, neighbors);
+
+	DEBUGRENDERER2D->DrawCircle(pLastAgent->GetPosition(), m_NeighborhoodRadius, { 1.f, 1.f, 1.f, 0.5f }, 0.f);
+	DEBUGRENDERER2D->DrawDirection(pLastAgent->GetPosition(), GetNeighborhood(pLastAgent).CenterOfMass, 7, { 1.f, 0.f, 0.f });
+
+	for (SteeringAgent* pAgent : m_Agents)
+	{
+		pAgent->SetBodyColor({ 1.f, 1.f, 0.f });
+	}
+	for (int neighborIdx : neighbors)
+	{
+		m_Agents[neighborIdx]->SetBodyColor({ 0.f, 1.f, 0.f });
+	}
+}
+
+void Flock::SteerAllAgents(float deltaT, int blockSize)
+{
+	const int nrAgents{ static_cast<int>(m_Agents.size()) };
+	JOBSYSTEM->ParallelFor(nrAgents, blockSize, [this, deltaT](int begin, int end, int threadIdx)
+		{
+			std::vector<int>& neighbors{ m_ThreadNeighbors[threadIdx] };
+			for (int idx{ begin }; idx < end; ++idx)
+			{
+				const SteeringAgent* pAgent{ m_Agents[idx] };
+				const Vector2 agentPos{ pAgent->GetPosition() };
+				QueryNeighbors(idx, neighbors);
+
+				NeighborhoodSummary& neighborhood{ m_Neighborhoods[pAgent->GetPoolIdx()] };
+				neighborhood = NeighborhoodSummary{};
+				for (int neighborIdx : neighbors)
+				{
+					neighborhood.AddNeighbor(agentPos, m_Agents[neighborIdx]);
+				}
+				neighborhood.Finish(agentPos);
+			}
+
+			// The flock added its agents to a new pool in order, so pool index == agent index
+			AgentSpan agents{ *m_pKinematicPool, begin, end - begin, m_Agents.data() + begin };
+			agents.pStates = m_SteeringStates.data() + begin;
+			m_pPrioritySteering->CalculateSteeringBatch(deltaT, agents, m_SteeringOutputs.data() + begin);
+		});
+}
+
+void Flock::SteerScheduledAgents(float deltaT)
+{
+	// Tiers from the distance to what the camera shows and to the agents the flock reacts to
+	const auto* pCamera = DEBUGRENDERER2D->GetActiveCamera();
+	const Vector2 corner{ pCamera->ConvertScreenToWorld({ 0.f, 0.f }) };
+	const Vector2 oppositeCorner{ pCamera->ConvertScreenToWorld({ static_cast<float>(pCamera->GetWidth()), static_cast<float>(pCamera->GetHeight()) }) };
+	m_pLod->SetView({ min(corner.x, oppositeCorner.x), min(corner.y, oppositeCorner.y) }, { max(corner.x, oppositeCorner.x), max(corner.y, oppositeCorner.y) });
+	const std::array<Vector2, 2> interestPoints{ m_pAgentToEvade->GetPosition(), m_SeekTarget };
+	m_pLod->SetInterestPoints(interestPoints.data(), static_cast<int>(interestPoints.size()));
+	m_pLod->Schedule(m_pKinematicPool->GetPositionsX(), m_pKinematicPool->GetPositionsY(), static_cast<int>(m_Agents.size()), deltaT);
+
+	// The same as the read phase of all agents, on copies of the scheduled ones. A tier at a time, to time them
+	const std::vector<int>& scheduledAgents{ m_pLod->GetScheduledAgents() };
+	const AgentSpan gatheredAgents{ m_pLod->GatherScheduledAgents(*m_pKinematicPool, m_Agents.data()) };
+	m_LodOutputs.resize(scheduledAgents.size());
+	const int blockSize{ m_UpdateBlockSize };
+	for (int tier{ 0 }; tier < SteeringLod::NrOfTiers; ++tier)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		const int tierBegin{ m_pLod->GetTierBegin(tier) };
+		JOBSYSTEM->ParallelFor(m_pLod->GetNrOfScheduledAgents(tier), blockSize, [this, deltaT, &scheduledAgents, &gatheredAgents, tierBegin](int begin, int end, int threadIdx)
+			{
+				std::vector<int>& neighbors{ m_ThreadNeighbors[threadIdx] };
+				for (int idx{ tierBegin + begin }; idx < tierBegin + end; ++idx)
+				{
+					const int agentIdx{ scheduledAgents[idx] };
+					const Vector2 agentPos{ m_Agents[agentIdx]->GetPosition() };
+					QueryNeighbors(agentIdx, neighbors);
+
+					NeighborhoodSummary& neighborhood{ m_Neighborhoods[agentIdx] };
+					neighborhood = NeighborhoodSummary{};
+					for (int neighborIdx : neighbors)
+					{
+						neighborhood.AddNeighbor(agentPos, m_Agents[neighborIdx]);
+					}
+					neighborhood.Finish(agentPos);
+				}
+
+				m_pPrioritySteering->CalculateSteeringBatch(deltaT, gatheredAgents.Slice(tierBegin + begin, end - begin), m_LodOutputs.data() + tierBegin + begin);
+				for (int idx{ tierBegin + begin }; idx < tierBegin + end; ++idx)
+					m_SteeringOutputs[scheduledAgents[idx]] = m_LodOutputs[idx];
+			});
+		m_pLod->SetSteeringMs(tier, std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+	}
+}
+
+void Flock::QueryNeighbors(int agentIdx, std::vector<int>& neighbors) const
+{
+	if (m_SpatialPartitioning && m_UseQuadtree)
+	{
+		QueryNeighbors(*m_pQuadtree, agentIdx, neighbors);
+		return;
+	}
+	if (m_SpatialPartitioning)
+	{
+		QueryNeighbors(*m_pSpatialHash, agentIdx, neighbors);
+		return;
+	}
+
+	// Same test as RegisterNeighbors
+	const Vector2 agentPos{ m_Agents[agentIdx]->GetPosition() };
+	neighbors.clear();
+	for (int otherIdx{ 0 }; otherIdx < static_cast<int>(m_Agents.size()); ++otherIdx)
+	{
+		if (otherIdx == agentIdx) continue;
+
+		const float distance{ (m_Agents[otherIdx]->GetPosition() - agentPos).Magnitude() };
+		if (distance < m_NeighborhoodRadius)
+		{
+			neighbors.push_back(otherIdx);
+		}
+	}
+
+	if (m_KNearest)
+	{
+		neighbors.resize(KeepNearest(neighbors.data(), static_cast<int>(neighbors.size()), m_NrOfNearest, agentPos,
+			[this](int neighborIdx) { return m_Agents[neighborIdx]->GetPosition(); }));
+	}
+}
+
+template<typename TSpatialIndex>
+void Flock::QueryNeighbors(const TSpatialIndex& spatialIndex, int agentIdx, std::vector<int>& neighbors) const
+{
+	const Vector2 agentPos{ m_Agents[agentIdx]->GetPosition() };
+	if (m_KNearest)
+	{
+		neighbors.resize(TSpatialIndex::MaxNrOfNearest);
+		neighbors.resize(spatialIndex.QueryNearest(agentPos, m_NeighborhoodRadius, agentIdx, m_NrOfNearest, neighbors.data()));
+		return;
+	}
+	spatialIndex.QueryNeighbors(agentPos, m_NeighborhoodRadius, agentIdx, neighbors);
+}
+
+template<typename TSpatialIndex>
+int Flock::QueryNeighborIndices(const TSpatialIndex& spatialIndex, const Vector2& agentPos)
+{
+	// The index of the agent is unknown, so it is found as well: one nearest extra
+	return m_KNearest
+		? spatialIndex.QueryNearest(agentPos, m_NeighborhoodRadius, -1, m_NrOfNearest + 1, m_NeighborIndices.data())
+		: spatialIndex.QueryNeighbors(agentPos, m_NeighborhoodRadius, -1, m_NeighborIndices.data(), m_FlockSize);
+}
+
 void Flock::Render(float deltaT)
 {
 	m_pAgentToEvade->Render(deltaT);
-	if (m_DebugRenderPartitions) m_pCellSpace->RenderCells();
+	if (m_DebugRenderPartitions && m_SpatialPartitioning && m_UseQuadtree) m_pQuadtree->RenderCells();
+	else if (m_DebugRenderPartitions && m_SpatialPartitioning) m_pSpatialHash->RenderCells();
 
 	if (m_FlockSize > 250) return;
 	for (SteeringAgent* pAgent : m_Agents)
@@ -189,6 +481,10 @@ void Flock::UpdateAndRenderUI()
 	ImGui::Spacing();
 
 	ImGui::Checkbox("Spatial Partitioning", &m_SpatialPartitioning);
+	ImGui::Checkbox("Loose quadtree", &m_UseQuadtree);
+	ImGui::Checkbox("K nearest neighbors", &m_KNearest);
+	if (m_KNearest)
+		ImGui::SliderInt("K", &m_NrOfNearest, 1, SpatialHash::MaxNrOfNearest - 1);
 	ImGui::Checkbox("Debug Render partitions", &m_DebugRenderPartitions);
 	ImGui::Checkbox("Debug Render neighborhood", &m_DebugRenderNeighborhood);
 	ImGui::Checkbox("Debug Render steering", &m_DebugRenderSteering);
@@ -199,6 +495,25 @@ void Flock::UpdateAndRenderUI()
 	ImGui::SliderFloat("Vel Match", &m_pBlendedSteering->GetWeightedBehaviorsRef()[2].weight, 0.f, 1.f, "%.2");
 	ImGui::SliderFloat("Wander", &m_pBlendedSteering->GetWeightedBehaviorsRef()[3].weight, 0.f, 1.f, "%.2");
 
+	if (m_pKinematicPool)
+	{
+		ImGui::Spacing();
+		ImGui::Separator();
+		ImGui::Spacing();
+
+		ImGui::Checkbox("Parallel update", &m_ParallelUpdate);
+		ImGui::Checkbox("Collision avoidance", &m_CollisionAvoidance); //Part of the parallel update
+		ImGui::Checkbox("Level of detail", &m_UseLod); //Part of the parallel update
+		for (int tier{ 0 }; tier < SteeringLod::NrOfTiers; ++tier)
+		{
+			ImGui::Text("Every %d: %d agents, %d steered, %.2f ms", m_pLod->GetTierInterval(tier), m_pLod->GetNrOfAgents(tier),
+				m_pLod->GetNrOfScheduledAgents(tier), m_pLod->GetSteeringMs(tier));
+		}
+		ImGui::SliderFloat3("Tier distances", m_pLod->GetTierDistancesRef().data(), 0.f, m_WorldSize, "%.0f");
+		ImGui::Text("Flock update: %.2f ms", m_UpdateMs);
+		ImGui::Text("Threads: %d", JOBSYSTEM->GetNrOfThreads());
+	}
+
 	//End
 	ImGui::PopAllowKeyboardFocus();
 	ImGui::End();
@@ -206,72 +521,67 @@ void Flock::UpdateAndRenderUI()
 
 void Flock::RegisterNeighbors(SteeringAgent* pAgent)
 {
+	size_t oldNrOfNeighbors{ m_NrOfNeighbors };
+	const Vector2 agentPos{ pAgent->GetPosition() };
 	m_NrOfNeighbors = 0;
-	for (SteeringAgent* pOtherAgent : m_Agents)
-	{
-		pOtherAgent->SetBodyColor({ 1.f,1.f,0.f });
-
-		if (pAgent == pOtherAgent) continue;
+	m_Neighborhood = NeighborhoodSummary{};
 
-		const float distance{ (pOtherAgent->GetPosition() - pAgent->GetPosition()).Magnitude() };
-		if (distance < m_NeighborhoodRadius)
-		{
-			m_Neighbors[m_NrOfNeighbors++] = pOtherAgent;
-		}
-	}
-
-	// Overwrite left over agents with nullptr
-	for (size_t i{ m_NrOfNeighbors }; i < m_Agents.size(); ++i)
-	{
-		m_Neighbors[i] = nullptr;
-	}
-}
-
-Elite::Vector2 Flock::GetAverageNeighborPos() const
-{
-	Elite::Vector2 avgPos{};
 	if (m_SpatialPartitioning)
 	{
-		for (size_t idx{ 0 }; idx < m_pCellSpace->GetNeighbors().size(); ++idx)
+		const int nrFound{ m_UseQuadtree ? QueryNeighborIndices(*m_pQuadtree, agentPos) : QueryNeighborIndices(*m_pSpatialHash, agentPos) };
+		for (int idx{ 0 }; idx < nrFound; ++idx)
 		{
-			if (m_pCellSpace->GetNeighbors()[idx] == nullptr) continue;
+			SteeringAgent* pNeighbor{ m_Agents[m_NeighborIndices[idx]] };
+			if (pNeighbor == pAgent) continue;
+			if (m_KNearest && static_cast<int>(m_NrOfNeighbors) == m_NrOfNearest) break;
 
-			avgPos += m_pCellSpace->GetNeighbors()[idx]->GetPosition();
+			m_Neighbors[m_NrOfNeighbors++] = pNeighbor;
 		}
-		return avgPos / static_cast<float>(m_pCellSpace->GetNeighbors().size());
 	}
-
-	for (size_t idx{ 0 }; idx < m_NrOfNeighbors; ++idx)
+	else
 	{
-		avgPos += m_Neighbors[idx]->GetPosition();
-	}
-	return avgPos / static_cast<float>(m_NrOfNeighbors);
-}
+		for (SteeringAgent* pOtherAgent : m_Agents)
+		{
+			pOtherAgent->SetBodyColor({ 1.f,1.f,0.f });
 
-Elite::Vector2 Flock::GetAverageNeighborVelocity() const
-{
-	Elite::Vector2 avgVel{};
+			if (pAgent == pOtherAgent) continue;
 
-	if (m_SpatialPartitioning)
-	{
-		for (size_t idx{ 0 }; idx < m_pCellSpace->GetNeighbors().size(); ++idx)
-		{
-			if (m_pCellSpace->GetNeighbors()[idx] == nullptr) continue;
+			const float distance{ (pOtherAgent->GetPosition() - agentPos).Magnitude() };
+			if (distance < m_NeighborhoodRadius)
+			{
+				m_Neighbors[m_NrOfNeighbors++] = pOtherAgent;
+			}
+		}
 
-			avgVel += m_pCellSpace->GetNeighbors()[idx]->GetLinearVelocity();
+		if (m_KNearest)
+		{
+			oldNrOfNeighbors = max(oldNrOfNeighbors, m_NrOfNeighbors); // The ones that don't make the cut are left over as well
+			m_NrOfNeighbors = static_cast<size_t>(KeepNearest(m_Neighbors.data(), static_cast<int>(m_NrOfNeighbors), m_NrOfNearest, agentPos,
+				[](const SteeringAgent* pNeighbor) { return pNeighbor->GetPosition(); }));
 		}
-		return avgVel / static_cast<float>(m_pCellSpace->GetNeighbors().size());
 	}
 
-	for (size_t idx{ 0 }; idx < m_NrOfNeighbors; ++idx)
+	for (size_t i{ 0 }; i < m_NrOfNeighbors; ++i)
 	{
-		avgVel += m_Neighbors[idx]->GetLinearVelocity();
+		m_Neighborhood.AddNeighbor(agentPos, m_Neighbors[i]);
 	}
-	return avgVel / static_cast<float>(m_NrOfNeighbors);
+	m_Neighborhood.Finish(agentPos);
+
+	// Overwrite left over agents with nullptr, the ones after the old neighbors are nullptr already
+	for (size_t i{ m_NrOfNeighbors }; i < oldNrOfNeighbors; ++i)
+	{
+		m_Neighbors[i] = nullptr;
+	}
+}
+
+const NeighborhoodSummary& Flock::GetNeighborhood(const SteeringAgent* pAgent) const
+{
+	return IsUpdatingInParallel() ? m_Neighborhoods[pAgent->GetPoolIdx()] : m_Neighborhood;
 }
 
 void Flock::SetTarget_Seek(TargetData target)
 {
+	m_SeekTarget = target.Position;
 	m_pSeekBehavior->SetTarget(target);
 }
 
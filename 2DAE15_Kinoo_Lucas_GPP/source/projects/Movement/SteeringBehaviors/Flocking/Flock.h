@@ -6,7 +6,23 @@ class ISteeringBehavior;
 class SteeringAgent;
 class BlendedSteering;
 class PrioritySteering;
-class CellSpace;
+class SpatialHash;
+class LooseQuadtree;
+class KinematicAgentPool;
+class OrcaAvoidance;
+class SteeringLod;
+
+//Everything the flocking behaviors need of the neighbors of an agent, gathered in one pass over them
+struct NeighborhoodSummary
+{
+	Elite::Vector2 CenterOfMass = Elite::ZeroVector2; //The agent's own position without neighbors
+	Elite::Vector2 AverageVelocity = Elite::ZeroVector2;
+	Elite::Vector2 Separation = Elite::ZeroVector2; //Sum of the directions away from the neighbors divided by their distance, closer weighs more
+	int NrOfNeighbors = 0;
+
+	void AddNeighbor(const Elite::Vector2& agentPos, const SteeringAgent* pNeighbor);
+	void Finish(const Elite::Vector2& agentPos); //Sums to averages, after the last neighbor
+};
 
 class Flock final
 {
@@ -15,7 +31,8 @@ public:
 		int flockSize = 50,
 		float worldSize = 100.f,
 		SteeringAgent* pAgentToEvade = nullptr,
-		bool trimWorld = false);
+		bool trimWorld = false,
+		bool useKinematicAgents = false); //Flock agents without rigid bodies, integrated by a KinematicAgentPool
 
 	~Flock();
 
@@ -27,31 +44,56 @@ public:
 	int GetNrOfNeighbors() const { return m_NrOfNeighbors; }
 	const std::vector<SteeringAgent*>& GetNeighbors() const { return m_Neighbors; }
 
-	Elite::Vector2 GetAverageNeighborPos() const;
-	Elite::Vector2 GetAverageNeighborVelocity() const;
+	//Neighborhood of an agent. The parallel update summarizes it for every agent before steering,
+	//the serial one returns the neighborhood registered last (the one of the agent being updated).
+	const NeighborhoodSummary& GetNeighborhood(const SteeringAgent* pAgent) const;
 
 	void SetTarget_Seek(TargetData target);
 	void SetWorldTrimSize(float size) { m_WorldSize = size; }
+	void SetKNearest(bool isKNearest) { m_KNearest = isKNearest; }
+	void SetUpdateBlockSize(int blockSize) { m_UpdateBlockSize = max(blockSize, 1); } //Agents per job of the parallel update, the result doesn't depend on it
+	const std::vector<SteeringAgent*>& GetAgents() const { return m_Agents; }
 
 private:
 	//Datamembers
 	int m_FlockSize = 0;
 	std::vector<SteeringAgent*> m_Agents;
 	std::vector<SteeringAgent*> m_Neighbors;
+	KinematicAgentPool* m_pKinematicPool = nullptr;
+	std::vector<SteeringState> m_SteeringStates; //Per agent, random stream = agent index, so a flock runs the same for any number of threads
 
-	CellSpace* m_pCellSpace = nullptr;
-	std::vector<Elite::Vector2> m_OldPos;
+	SpatialHash* m_pSpatialHash = nullptr; //Rebuilt at the start of every update
+	LooseQuadtree* m_pQuadtree = nullptr; //Same, but agents only move when they change node. Adapts to clustered flocks
+	std::vector<int> m_NeighborIndices;
 
 	bool m_TrimWorld = false;
 	bool m_DebugRenderPartitions = false;
 	bool m_DebugRenderNeighborhood = false;
 	bool m_DebugRenderSteering = false;
 	bool m_SpatialPartitioning = true;
+	bool m_UseQuadtree = false;
+	bool m_ParallelUpdate = true; //Only for kinematic agents, rigid bodies are stepped by the physics world
 	float m_WorldSize = 0.f;
 
 	float m_NeighborhoodRadius = 10.f;
-	float m_QueryRadius = 10.f;
+	bool m_KNearest = false; //Only the m_NrOfNearest nearest agents within the radius are neighbors, bounds the work per agent in dense clusters
+	int m_NrOfNearest = 7;
 	size_t m_NrOfNeighbors = 0;
+	NeighborhoodSummary m_Neighborhood = {};
+
+	//Parallel update: neighborhoods and steering per agent (pool index), and neighbor scratch per job system thread
+	std::vector<NeighborhoodSummary> m_Neighborhoods;
+	std::vector<SteeringOutput> m_SteeringOutputs;
+	std::vector<std::vector<int>> m_ThreadNeighbors;
+	OrcaAvoidance* m_pAvoidance = nullptr; //Turns the steered velocities into velocities that don't collide
+	std::vector<Elite::Vector2> m_AvoidanceVelocities; //Preferred in, safe out
+	bool m_CollisionAvoidance = false;
+	SteeringLod* m_pLod = nullptr; //Agents far from the camera, the evading agent and the seek target steer less often
+	std::vector<SteeringOutput> m_LodOutputs; //Of the scheduled agents, in their order
+	Elite::Vector2 m_SeekTarget = Elite::ZeroVector2;
+	bool m_UseLod = false;
+	int m_UpdateBlockSize = 256;
+	float m_UpdateMs = 0.f;
 
 	SteeringAgent* m_pAgentToEvade = nullptr;
 
@@ -68,6 +110,15 @@ private:
 	PrioritySteering* m_pPrioritySteering = nullptr;
 
 	float* GetWeight(ISteeringBehavior* pBehaviour);
+	bool IsUpdatingInParallel() const { return m_pKinematicPool && m_ParallelUpdate; }
+	void UpdateParallel(float deltaT);
+	void SteerAllAgents(float deltaT, int blockSize); //The read phase of the parallel update, in blocks of blockSize agents
+	void SteerScheduledAgents(float deltaT); //The read phase of the parallel update, with level of detail
+	void QueryNeighbors(int agentIdx, std::vector<int>& neighbors) const;
+	template<typename TSpatialIndex>
+	void QueryNeighbors(const TSpatialIndex& spatialIndex, int agentIdx, std::vector<int>& neighbors) const;
+	template<typename TSpatialIndex>
+	int QueryNeighborIndices(const TSpatialIndex& spatialIndex, const Elite::Vector2& agentPos); //Into m_NeighborIndices, the agent itself included
 
 	Flock(const Flock& other);
 	Flock& operator=(const Flock& other);
@@ -8,20 +8,49 @@
 //COHESION (FLOCKING)
 SteeringOutput Cohesion::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 {
-	if (m_pFlock->GetNrOfNeighbors() == 0) return SteeringOutput();
+	const NeighborhoodSummary& neighborhood{ m_pFlock->GetNeighborhood(pAgent) };
+	if (neighborhood.NrOfNeighbors == 0) return SteeringOutput();
 
-	m_Target = m_pFlock->GetAverageNeighborPos();
+	return SeekTo(neighborhood.CenterOfMass, pAgent);
+}
+
+void Cohesion::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+		pOutputs[idx].LinearVelocity = m_pFlock->GetNeighborhood(agents.ppAgents[idx]).CenterOfMass;
 
-	return Seek::CalculateSteering(deltaT, pAgent);
+	SeekOutputTargets(agents, pOutputs);
+
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		if (m_pFlock->GetNeighborhood(agents.ppAgents[idx]).NrOfNeighbors == 0)
+			pOutputs[idx] = SteeringOutput();
+	}
 }
 
 //*********************
 //SEPARATION (FLOCKING)
 SteeringOutput Separation::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 {
-	m_Target = m_pFlock->GetAverageNeighborPos();
+	//Away from the neighbors, the closest ones weigh the most
+	SteeringOutput steering{};
+
+	steering.LinearVelocity = m_pFlock->GetNeighborhood(pAgent).Separation;
+	steering.LinearVelocity.Normalize();
+	steering.LinearVelocity *= pAgent->GetMaxLinearSpeed();
+
+	return steering;
+}
 
-	return Flee::CalculateSteering(deltaT, pAgent);
+void Separation::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		pOutputs[idx] = SteeringOutput();
+		pOutputs[idx].LinearVelocity = m_pFlock->GetNeighborhood(agents.ppAgents[idx]).Separation;
+		pOutputs[idx].LinearVelocity.Normalize();
+		pOutputs[idx].LinearVelocity *= agents.pMaxLinearSpeeds[idx];
+	}
 }
 
 //*************************
@@ -30,7 +59,7 @@ SteeringOutput VelocityMatch::CalculateSteering(float deltaT, SteeringAgent* pAg
 {
 	SteeringOutput steering{};
 
-	steering.LinearVelocity = m_pFlock->GetAverageNeighborVelocity();
+	steering.LinearVelocity = m_pFlock->GetNeighborhood(pAgent).AverageVelocity;
 	steering.LinearVelocity.Normalize();
 	steering.LinearVelocity *= pAgent->GetMaxLinearSpeed();
 
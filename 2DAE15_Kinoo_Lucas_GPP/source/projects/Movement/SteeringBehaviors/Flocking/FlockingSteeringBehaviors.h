@@ -11,6 +11,7 @@ public:
 
 	//Cohesion Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override; //Needs agents.ppAgents
 
 private:
 	Flock* m_pFlock = nullptr;
@@ -25,6 +26,7 @@ public:
 
 	//Cohesion Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override; //Needs agents.ppAgents
 
 private:
 	Flock* m_pFlock = nullptr;
@@ -0,0 +1,95 @@
+#include "stdafx.h"
+#include "SteeringLod.h"
+#include "projects/Shared/KinematicAgentPool.h"
+
+void SteeringLod::Schedule(const float* pPositionsX, const float* pPositionsY, int count, float deltaT)
+{
+	// The agents that steered last frame start counting again, agents that were added start as if they just steered
+	m_ElapsedTimes.resize(count, 0.f);
+	for (int agentIdx : m_ScheduledAgents)
+	{
+		if (agentIdx < count)
+			m_ElapsedTimes[agentIdx] = 0.f;
+	}
+
+	m_UnsortedAgents.clear();
+	m_ScheduledTiers.clear();
+	m_NrOfAgents.fill(0);
+
+	for (int agentIdx = 0; agentIdx < count; ++agentIdx)
+	{
+		const int tier{ GetTier(pPositionsX[agentIdx], pPositionsY[agentIdx]) };
+		++m_NrOfAgents[tier];
+
+		// Intervals are powers of two, a mask picks the frames
+		m_ElapsedTimes[agentIdx] += deltaT;
+		if (((m_Frame + static_cast<unsigned int>(agentIdx)) & static_cast<unsigned int>(GetTierInterval(tier) - 1)) != 0)
+			continue;
+
+		m_UnsortedAgents.push_back(agentIdx);
+		m_ScheduledTiers.push_back(tier);
+	}
+	++m_Frame;
+
+	// Group the scheduled agents by tier, in agent order within a tier (counting sort)
+	m_TierBegins.fill(0);
+	for (int tier : m_ScheduledTiers)
+		++m_TierBegins[tier + 1];
+	for (int tier = 0; tier < NrOfTiers; ++tier)
+		m_TierBegins[tier + 1] += m_TierBegins[tier];
+
+	std::array<int, NrOfTiers> nextSlots{};
+	std::copy(m_TierBegins.begin(), m_TierBegins.end() - 1, nextSlots.begin());
+	m_ScheduledAgents.resize(m_UnsortedAgents.size());
+	for (size_t idx = 0; idx < m_UnsortedAgents.size(); ++idx)
+		m_ScheduledAgents[nextSlots[m_ScheduledTiers[idx]]++] = m_UnsortedAgents[idx];
+}
+
+AgentSpan SteeringLod::GatherScheduledAgents(const KinematicAgentPool& pool, SteeringAgent* const* ppAgents)
+{
+	const size_t count{ m_ScheduledAgents.size() };
+	m_PositionsX.resize(count);
+	m_PositionsY.resize(count);
+	m_LinearVelocitiesX.resize(count);
+	m_LinearVelocitiesY.resize(count);
+	m_Orientations.resize(count);
+	m_MaxLinearSpeeds.resize(count);
+	m_Agents.resize(count);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		const int agentIdx{ m_ScheduledAgents[idx] };
+		m_PositionsX[idx] = pool.GetPositionsX()[agentIdx];
+		m_PositionsY[idx] = pool.GetPositionsY()[agentIdx];
+		m_LinearVelocitiesX[idx] = pool.GetLinearVelocitiesX()[agentIdx];
+		m_LinearVelocitiesY[idx] = pool.GetLinearVelocitiesY()[agentIdx];
+		m_Orientations[idx] = pool.GetOrientations()[agentIdx];
+		m_MaxLinearSpeeds[idx] = pool.GetMaxLinearSpeeds()[agentIdx];
+		m_Agents[idx] = ppAgents[agentIdx];
+	}
+
+	AgentSpan gathered{};
+	gathered.pPositionsX = m_PositionsX.data();
+	gathered.pPositionsY = m_PositionsY.data();
+	gathered.pLinearVelocitiesX = m_LinearVelocitiesX.data();
+	gathered.pLinearVelocitiesY = m_LinearVelocitiesY.data();
+	gathered.pOrientations = m_Orientations.data();
+	gathered.pMaxLinearSpeeds = m_MaxLinearSpeeds.data();
+	gathered.ppAgents = m_Agents.data();
+	gathered.Count = static_cast<int>(count);
+	return gathered;
+}
+
+int SteeringLod::GetTier(float x, float y) const
+{
+	// Distance to the view rectangle, 0 inside
+	const float viewDistanceX{ max(max(m_ViewBottomLeft.x - x, x - m_ViewTopRight.x), 0.f) };
+	const float viewDistanceY{ max(max(m_ViewBottomLeft.y - y, y - m_ViewTopRight.y), 0.f) };
+	float distanceSquared{ viewDistanceX * viewDistanceX + viewDistanceY * viewDistanceY };
+	for (const Elite::Vector2& interestPoint : m_InterestPoints)
+		distanceSquared = min(distanceSquared, Elite::Square(interestPoint.x - x) + Elite::Square(interestPoint.y - y));
+
+	int tier{ 0 };
+	while (tier < NrOfTiers - 1 && distanceSquared > Elite::Square(m_TierDistances[tier]))
+		++tier;
+	return tier;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include "../SteeringHelpers.h"
+
+//Level of detail of the steering: agents far from the view and from the interest points steer less often.
+//Every agent gets a tier from its distance, tier t steers every GetTierInterval(t) frames. In between the agent keeps its velocity,
+//the pool or the physics world moves it along (dead reckoning). Agent i of a tier steers when (frame + i) is a multiple of the interval,
+//so every frame steers about the same share of the agents of a tier.
+class SteeringLod final
+{
+public:
+	static const int NrOfTiers = 4;
+
+	SteeringLod() = default;
+
+	//What is seen, in world coordinates. Agents in it are at distance 0
+	void SetView(const Elite::Vector2& bottomLeft, const Elite::Vector2& topRight) { m_ViewBottomLeft = bottomLeft; m_ViewTopRight = topRight; }
+	//Points that need agents steering close to them as if they were in view (a target, the player, ...)
+	void SetInterestPoints(const Elite::Vector2* pInterestPoints, int count) { m_InterestPoints.assign(pInterestPoints, pInterestPoints + count); } //Reuses the storage
+
+	//Agents within distance d[t] of the view or an interest point get tier t (or lower), the others the last tier
+	std::array<float, NrOfTiers - 1>& GetTierDistancesRef() { return m_TierDistances; }
+	int GetTierInterval(int tier) const { return 1 << tier; } //1, 2, 4 and 8 frames
+
+	//Tiers of all agents and which of them steer this frame. Point i is agent i
+	void Schedule(const float* pPositionsX, const float* pPositionsY, int count, float deltaT);
+
+	//The agents that steer this frame, by tier: tier t is [GetTierBegin(t), GetTierBegin(t + 1))
+	const std::vector<int>& GetScheduledAgents() const { return m_ScheduledAgents; }
+	int GetTierBegin(int tier) const { return m_TierBegins[tier]; }
+	//The time since the agent steered last, what it steers with this frame
+	float GetElapsedTime(int agentIdx) const { return m_ElapsedTimes[agentIdx]; }
+	//Copies of the scheduled agents of the pool next to each other, in the same order, to steer them in batches (AgentSpan::Slice).
+	//Point i of the pool is ppAgents[i], the span uses the states of the agents. Valid until the next gather
+	AgentSpan GatherScheduledAgents(const KinematicAgentPool& pool, SteeringAgent* const* ppAgents);
+
+	//Statistics of the last frame
+	int GetNrOfAgents(int tier) const { return m_NrOfAgents[tier]; }
+	int GetNrOfScheduledAgents(int tier) const { return m_TierBegins[tier + 1] - m_TierBegins[tier]; }
+	float GetSteeringMs(int tier) const { return m_SteeringMs[tier]; }
+	void SetSteeringMs(int tier, float ms) { m_SteeringMs[tier] = ms; } //Measured by the caller, which does the steering
+
+private:
+	Elite::Vector2 m_ViewBottomLeft{};
+	Elite::Vector2 m_ViewTopRight{};
+	std::vector<Elite::Vector2> m_InterestPoints{};
+	std::array<float, NrOfTiers - 1> m_TierDistances{ 10.f, 40.f, 100.f };
+
+	unsigned int m_Frame = 0;
+	std::vector<float> m_ElapsedTimes{};
+	std::vector<int> m_ScheduledAgents{};
+	std::vector<int> m_UnsortedAgents{}; //Scratch of Schedule
+	std::vector<int> m_ScheduledTiers{};
+	std::array<int, NrOfTiers + 1> m_TierBegins{};
+	std::array<int, NrOfTiers> m_NrOfAgents{};
+	std::array<float, NrOfTiers> m_SteeringMs{};
+
+	std::vector<float> m_PositionsX{}; //The gathered agents
+	std::vector<float> m_PositionsY{};
+	std::vector<float> m_LinearVelocitiesX{};
+	std::vector<float> m_LinearVelocitiesY{};
+	std::vector<float> m_Orientations{};
+	std::vector<float> m_MaxLinearSpeeds{};
+	std::vector<SteeringAgent*> m_Agents{};
+
+	int GetTier(float x, float y) const;
+};
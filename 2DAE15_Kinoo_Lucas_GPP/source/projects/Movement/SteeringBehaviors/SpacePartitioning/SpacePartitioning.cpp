@@ -1,157 +1,775 @@
 #include "stdafx.h"
 #include "SpacePartitioning.h"
 #include "projects/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "projects/Movement/SteeringBehaviors/Obstacle.h"
+#include "framework/EliteGeometry/ESimd.h"
 
-// --- Cell ---
-// ------------
-Cell::Cell(float left, float bottom, float width, float height)
+namespace
 {
-	boundingBox.bottomLeft = Elite::Vector2{ left, bottom };
-	boundingBox.width = width;
-	boundingBox.height = height;
+	// Corners of a cell for the debug renderer, clockwise from the bottom left
+	std::vector<Elite::Vector2> GetRectPoints(float left, float bottom, float width, float height)
+	{
+		return { { left, bottom }, { left, bottom + height }, { left + width, bottom + height }, { left + width, bottom } };
+	}
 }
 
-std::vector<Elite::Vector2> Cell::GetRectPoints() const
+// --- Spatial Hash ---
+// --------------------
+SpatialHash::SpatialHash(float cellSize, int nrOfBuckets /*= 4096*/)
+	: m_CellSize(cellSize)
+	, m_InvCellSize(1.f / cellSize)
 {
-	auto left = boundingBox.bottomLeft.x;
-	auto bottom = boundingBox.bottomLeft.y;
-	auto width = boundingBox.width;
-	auto height = boundingBox.height;
+	int nrOfBucketsPow2{ 1 };
+	while (nrOfBucketsPow2 < nrOfBuckets)
+		nrOfBucketsPow2 <<= 1;
+
+	m_BucketMask = nrOfBucketsPow2 - 1;
+	m_BucketStarts.resize(nrOfBucketsPow2 + 1);
+}
 
-	std::vector<Elite::Vector2> rectPoints =
+void SpatialHash::Rebuild(const float* pPositionsX, const float* pPositionsY, int count)
+{
+	m_PointBuckets.resize(count);
+	m_SortedIndices.resize(count);
+	m_SortedPositionsX.resize(count);
+	m_SortedPositionsY.resize(count);
+
+	// 1. Count the points per bucket
+	std::fill(m_BucketStarts.begin(), m_BucketStarts.end(), 0);
+	for (int idx = 0; idx < count; ++idx)
 	{
-		{ left , bottom  },
-		{ left , bottom + height  },
-		{ left + width , bottom + height },
-		{ left + width , bottom  },
+		const int bucket{ GetBucket(ToCell(pPositionsX[idx]), ToCell(pPositionsY[idx])) };
+		m_PointBuckets[idx] = bucket;
+		++m_BucketStarts[bucket];
+	}
+
+	// 2. Prefix sum, every bucket starts at the end of its slice
+	int end{ 0 };
+	for (int& bucketStart : m_BucketStarts)
+	{
+		end += bucketStart;
+		bucketStart = end;
+	}
+
+	// 3. Scatter back to front, which moves every bucket start to the start of its slice and keeps the points of a bucket in order
+	for (int idx = count - 1; idx >= 0; --idx)
+	{
+		const int sortedIdx{ --m_BucketStarts[m_PointBuckets[idx]] };
+		m_SortedIndices[sortedIdx] = idx;
+		m_SortedPositionsX[sortedIdx] = pPositionsX[idx];
+		m_SortedPositionsY[sortedIdx] = pPositionsY[idx];
+	}
+}
+
+void SpatialHash::Rebuild(const std::vector<SteeringAgent*>& agents)
+{
+	m_PositionsX.resize(agents.size());
+	m_PositionsY.resize(agents.size());
+	for (size_t idx = 0; idx < agents.size(); ++idx)
+	{
+		const Elite::Vector2 pos{ agents[idx]->GetPosition() };
+		m_PositionsX[idx] = pos.x;
+		m_PositionsY[idx] = pos.y;
+	}
+
+	Rebuild(m_PositionsX.data(), m_PositionsY.data(), static_cast<int>(agents.size()));
+}
+
+int SpatialHash::QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int* pNeighbors, int capacity) const
+{
+	int nrOfNeighbors{ 0 };
+	ForEachNeighbor(pos, queryRadius, excludeIdx, [pNeighbors, capacity, &nrOfNeighbors](int pointIdx, float)
+		{
+			if (nrOfNeighbors == capacity)
+				return false;
+			pNeighbors[nrOfNeighbors++] = pointIdx;
+			return true;
+		});
+	return nrOfNeighbors;
+}
+
+void SpatialHash::QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, std::vector<int>& neighbors) const
+{
+	neighbors.clear();
+	ForEachNeighbor(pos, queryRadius, excludeIdx, [&neighbors](int pointIdx, float)
+		{
+			neighbors.push_back(pointIdx);
+			return true;
+		});
+}
+
+int SpatialHash::QueryNearest(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int k, int* pNearest) const
+{
+	k = Elite::Clamp(k, 0, MaxNrOfNearest);
+	if (k == 0)
+		return 0;
+
+	// Sorted by distance. Once full, the radius shrinks to the farthest one, so the rest of the points is filtered against that
+	std::array<float, MaxNrOfNearest> distancesSquared;
+	int nrOfNearest{ 0 };
+	float radiusSquared{ queryRadius * queryRadius };
+	auto addNearest = [pNearest, k, &distancesSquared, &nrOfNearest, &radiusSquared](int pointIdx, float distanceSquared)
+	{
+		if (!(distanceSquared < radiusSquared))
+			return true;
+
+		int idx{ nrOfNearest < k ? nrOfNearest++ : k - 1 };
+		for (; idx > 0 && distanceSquared < distancesSquared[idx - 1]; --idx)
+		{
+			distancesSquared[idx] = distancesSquared[idx - 1];
+			pNearest[idx] = pNearest[idx - 1];
+		}
+		distancesSquared[idx] = distanceSquared;
+		pNearest[idx] = pointIdx;
+
+		if (nrOfNearest == k)
+			radiusSquared = distancesSquared[k - 1];
+		return true;
 	};
 
-	return rectPoints;
+	const int left{ ToCell(pos.x - queryRadius) };
+	const int right{ ToCell(pos.x + queryRadius) };
+	const int bottom{ ToCell(pos.y - queryRadius) };
+	const int top{ ToCell(pos.y + queryRadius) };
+	const int nrOfCells{ (right - left + 1) * (top - bottom + 1) };
+	if (nrOfCells < 0 || nrOfCells > 64)
+	{
+		FilterPoints(0, GetNrOfPoints(), pos, radiusSquared, excludeIdx, addNearest);
+		return nrOfNearest;
+	}
+
+	// The cells nearest first (the one of pos has distance 0), so the radius shrinks fast in dense areas and far cells are skipped
+	std::array<std::pair<float, int>, 64> cells;
+	int cellIdx{ 0 };
+	for (int cellY = bottom; cellY <= top; ++cellY)
+	{
+		for (int cellX = left; cellX <= right; ++cellX)
+		{
+			const float distanceX{ max(max(cellX * m_CellSize - pos.x, pos.x - (cellX + 1) * m_CellSize), 0.f) };
+			const float distanceY{ max(max(cellY * m_CellSize - pos.y, pos.y - (cellY + 1) * m_CellSize), 0.f) };
+			cells[cellIdx++] = { distanceX * distanceX + distanceY * distanceY, GetBucket(cellX, cellY) };
+		}
+	}
+	std::sort(cells.begin(), cells.begin() + nrOfCells);
+
+	std::array<int, 64> visitedBuckets;
+	int nrOfVisitedBuckets{ 0 };
+	for (cellIdx = 0; cellIdx < nrOfCells && cells[cellIdx].first < radiusSquared; ++cellIdx)
+	{
+		const int bucket{ cells[cellIdx].second };
+		if (std::find(visitedBuckets.begin(), visitedBuckets.begin() + nrOfVisitedBuckets, bucket) != visitedBuckets.begin() + nrOfVisitedBuckets)
+			continue;
+		visitedBuckets[nrOfVisitedBuckets++] = bucket;
+
+		FilterPoints(m_BucketStarts[bucket], m_BucketStarts[bucket + 1], pos, radiusSquared, excludeIdx, addNearest);
+	}
+	return nrOfNearest;
+}
+
+template<typename AddNeighbor>
+void SpatialHash::ForEachNeighbor(const Elite::Vector2& pos, float queryRadius, int excludeIdx, AddNeighbor addNeighbor) const
+{
+	const int left{ ToCell(pos.x - queryRadius) };
+	const int right{ ToCell(pos.x + queryRadius) };
+	const int bottom{ ToCell(pos.y - queryRadius) };
+	const int top{ ToCell(pos.y + queryRadius) };
+	const float queryRadiusSquared{ queryRadius * queryRadius };
+
+	// More cells than buckets (or close): every bucket is visited anyway, check all points once
+	const int nrOfCells{ (right - left + 1) * (top - bottom + 1) };
+	if (nrOfCells < 0 || nrOfCells > 64)
+	{
+		FilterPoints(0, GetNrOfPoints(), pos, queryRadiusSquared, excludeIdx, addNeighbor);
+		return;
+	}
+
+	std::array<int, 64> visitedBuckets;
+	int nrOfVisitedBuckets{ 0 };
+	for (int cellY = bottom; cellY <= top; ++cellY)
+	{
+		for (int cellX = left; cellX <= right; ++cellX)
+		{
+			// Cells of the query that hash to the same bucket share their points, visit every bucket only once
+			const int bucket{ GetBucket(cellX, cellY) };
+			if (std::find(visitedBuckets.begin(), visitedBuckets.begin() + nrOfVisitedBuckets, bucket) != visitedBuckets.begin() + nrOfVisitedBuckets)
+				continue;
+			visitedBuckets[nrOfVisitedBuckets++] = bucket;
+
+			// Points of other cells in the bucket fail the distance test
+			if (!FilterPoints(m_BucketStarts[bucket], m_BucketStarts[bucket + 1], pos, queryRadiusSquared, excludeIdx, addNeighbor))
+				return;
+		}
+	}
 }
 
-// --- Partitioned Space ---
-// -------------------------
-CellSpace::CellSpace(float width, float height, int rows, int cols, int maxEntities)
-	: m_SpaceWidth(width)
-	, m_SpaceHeight(height)
-	, m_NrOfRows(rows)
-	, m_NrOfCols(cols)
-	, m_Neighbors(maxEntities)
-	, m_NrOfNeighbors(0)
+template<typename AddNeighbor>
+bool SpatialHash::FilterPoints(int begin, int end, const Elite::Vector2& pos, const float& queryRadiusSquared, int excludeIdx, AddNeighbor& addNeighbor) const
 {
-	m_CellWidth = width / cols;
-	m_CellHeight = height / rows;
+	const float* pPositionsX{ m_SortedPositionsX.data() };
+	const float* pPositionsY{ m_SortedPositionsY.data() };
+	int sortedIdx{ begin };
 
-	// Create cells
-	for (int row = 0; row < rows; ++row)
+#if defined(ELITE_SIMD_AVX2) || defined(ELITE_SIMD_SSE2)
+	// Distances of a lane of points at once, the points inside are added in order.
+	// The radius is read again for every lane, addNeighbor may shrink it.
+	using Elite::Simd;
+	const Simd::Float posX{ Simd::Set(pos.x) };
+	const Simd::Float posY{ Simd::Set(pos.y) };
+	std::array<float, Simd::Width> distancesSquared;
+	for (; sortedIdx + Simd::Width <= end; sortedIdx += Simd::Width)
 	{
-		for (int col = 0; col < cols; ++col)
+		const Simd::Float x{ Simd::Sub(Simd::Load(pPositionsX + sortedIdx), posX) };
+		const Simd::Float y{ Simd::Sub(Simd::Load(pPositionsY + sortedIdx), posY) };
+		const Simd::Float distanceSquared{ Simd::Add(Simd::Mul(x, x), Simd::Mul(y, y)) };
+		int insideLanes{ Simd::Bits(Simd::Less(distanceSquared, Simd::Set(queryRadiusSquared))) };
+		if (insideLanes == 0)
+			continue;
+
+		Simd::Store(distancesSquared.data(), distanceSquared);
+		for (int lane = 0; insideLanes != 0; ++lane, insideLanes >>= 1)
 		{
-			float left = col * m_CellWidth;
-			float bottom = row * m_CellHeight;
+			if ((insideLanes & 1) && m_SortedIndices[sortedIdx + lane] != excludeIdx && !addNeighbor(m_SortedIndices[sortedIdx + lane], distancesSquared[lane]))
+				return false;
+		}
+	}
+#endif
 
-			m_Cells.emplace_back(left, bottom, m_CellWidth, m_CellHeight);
+	for (; sortedIdx < end; ++sortedIdx)
+	{
+		const float x{ pPositionsX[sortedIdx] - pos.x };
+		const float y{ pPositionsY[sortedIdx] - pos.y };
+		const float distanceSquared{ x * x + y * y };
+		if (distanceSquared < queryRadiusSquared && m_SortedIndices[sortedIdx] != excludeIdx && !addNeighbor(m_SortedIndices[sortedIdx], distanceSquared))
+			return false;
+	}
+	return true;
+}
+
+void SpatialHash::RenderCells() const
+{
+	for (size_t bucket = 0; bucket + 1 < m_BucketStarts.size(); ++bucket)
+	{
+		const int begin{ m_BucketStarts[bucket] };
+		const int end{ m_BucketStarts[bucket + 1] };
+		for (int sortedIdx = begin; sortedIdx < end; ++sortedIdx)
+		{
+			// Draw every cell of the bucket once, at its first point
+			const int cellX{ ToCell(m_SortedPositionsX[sortedIdx]) };
+			const int cellY{ ToCell(m_SortedPositionsY[sortedIdx]) };
+			int nrOfPoints{ 0 };
+			bool isDrawn{ false };
+			for (int otherIdx = begin; otherIdx < end && !isDrawn; ++otherIdx)
+			{
+				if (ToCell(m_SortedPositionsX[otherIdx]) != cellX || ToCell(m_SortedPositionsY[otherIdx]) != cellY)
+					continue;
+
+				isDrawn = otherIdx < sortedIdx;
+				++nrOfPoints;
+			}
+			if (isDrawn)
+				continue;
+
+			auto rectPoints = GetRectPoints(cellX * m_CellSize, cellY * m_CellSize, m_CellSize, m_CellSize);
+			DEBUGRENDERER2D->DrawPolygon(rectPoints.data(), rectPoints.size(), { .5f, 0.f, 0.f, 0.5f }, 0.f);
+			DEBUGRENDERER2D->DrawString(rectPoints[1], std::to_string(nrOfPoints).c_str());
 		}
 	}
 }
 
-void CellSpace::AddAgent(SteeringAgent* agent)
+int SpatialHash::GetBucket(int cellX, int cellY) const
 {
-	// Adds an agent to the appropriate Cell
-	m_Cells[PositionToIndex(agent->GetPosition())].agents.push_back(agent);
+	// Large primes, neighboring cells end up in unrelated buckets
+	const unsigned int hash{ static_cast<unsigned int>(cellX) * 73856093u ^ static_cast<unsigned int>(cellY) * 19349663u };
+	return static_cast<int>(hash & static_cast<unsigned int>(m_BucketMask));
 }
 
-void CellSpace::UpdateAgentCell(SteeringAgent* agent, Elite::Vector2 oldPos)
+// --- Loose Quadtree ---
+// ----------------------
+LooseQuadtree::LooseQuadtree(const Elite::Vector2& bottomLeft, float size, float minNodeSize)
+	: m_BottomLeft(bottomLeft)
+	, m_Size(size)
 {
-	// 1. Get the index of the cell the agent was in before the update
-	int oldCellIdx = PositionToIndex(oldPos);
+	int nrOfLevels{ 1 };
+	while (nrOfLevels < 8 && size / static_cast<float>(1 << nrOfLevels) >= minNodeSize)
+		++nrOfLevels;
 
-	// 2. Get the index of the cell the agent is currently in
-	int currentCellIdx = PositionToIndex(agent->GetPosition());
+	m_LevelStarts.resize(nrOfLevels + 1);
+	int nrOfNodes{ 0 };
+	for (int level = 0; level < nrOfLevels; ++level)
+	{
+		m_LevelStarts[level] = nrOfNodes;
+		nrOfNodes += 1 << (2 * level);
+	}
+	m_LevelStarts[nrOfLevels] = nrOfNodes;
+
+	m_NodeItems.resize(nrOfNodes);
+	m_NrOfLevelItems.resize(nrOfLevels);
+}
+
+int LooseQuadtree::Insert(const Elite::Vector2& pos, float radius /*= 0.f*/)
+{
+	int itemIdx{ static_cast<int>(m_ItemLocations.size()) };
+	if (m_FreeItems.empty())
+	{
+		m_ItemLocations.push_back({ -1, -1 });
+	}
+	else
+	{
+		itemIdx = m_FreeItems.back();
+		m_FreeItems.pop_back();
+	}
+
+	AddToNode(itemIdx, GetNodeIdx(GetNodeRef(pos, radius)), pos, radius);
+	return itemIdx;
+}
+
+void LooseQuadtree::Move(int itemIdx, const Elite::Vector2& pos, float radius /*= 0.f*/)
+{
+	const int nodeIdx{ GetNodeIdx(GetNodeRef(pos, radius)) };
+	const ItemLocation location{ m_ItemLocations[itemIdx] };
+	if (location.node == -1)
+		return;
 
-	// 3. If the agent is in a different cell than before, move it to the new one
-	if (oldCellIdx != currentCellIdx)
+	if (location.node == nodeIdx)
 	{
-		m_Cells[oldCellIdx].agents.remove(agent);
-		m_Cells[currentCellIdx].agents.push_back(agent);
+		NodeItem& item{ m_NodeItems[nodeIdx][location.slot] };
+		item.x = pos.x;
+		item.y = pos.y;
+		item.radius = radius;
+		m_HasRadii = m_HasRadii || radius > 0.f;
+		return;
 	}
+
+	RemoveFromNode(itemIdx);
+	AddToNode(itemIdx, nodeIdx, pos, radius);
+}
+
+void LooseQuadtree::Remove(int itemIdx)
+{
+	if (m_ItemLocations[itemIdx].node == -1)
+		return;
+
+	RemoveFromNode(itemIdx);
+	m_FreeItems.push_back(itemIdx);
 }
 
-void CellSpace::RegisterNeighbors(SteeringAgent* agent, float queryRadius)
+void LooseQuadtree::Clear()
 {
-	// Find out which Cells are in the agent's neighborhood
-	// Get indeces of the cells that are in the agent's neighborhood
-	auto indices = GetNearbyCells(agent->GetPosition(), queryRadius);
+	for (std::vector<NodeItem>& items : m_NodeItems)
+		items.clear();
+	std::fill(m_NrOfLevelItems.begin(), m_NrOfLevelItems.end(), 0);
+	m_ItemLocations.clear();
+	m_FreeItems.clear();
+	m_HasRadii = false;
+}
 
-	// Register the agents of the nearby cells
-	m_NrOfNeighbors = 0;
-	for (int idx : indices)
+void LooseQuadtree::Rebuild(const float* pPositionsX, const float* pPositionsY, int count)
+{
+	// Item i has to be point i, which only holds without removed items
+	if (count != static_cast<int>(m_ItemLocations.size()) || !m_FreeItems.empty())
 	{
-		for (SteeringAgent* pAgent : m_Cells[idx].agents)
+		Clear();
+		for (int idx = 0; idx < count; ++idx)
+			Insert({ pPositionsX[idx], pPositionsY[idx] });
+		return;
+	}
+
+	for (int idx = 0; idx < count; ++idx)
+		Move(idx, { pPositionsX[idx], pPositionsY[idx] });
+}
+
+void LooseQuadtree::Rebuild(const std::vector<SteeringAgent*>& agents)
+{
+	m_PositionsX.resize(agents.size());
+	m_PositionsY.resize(agents.size());
+	for (size_t idx = 0; idx < agents.size(); ++idx)
+	{
+		const Elite::Vector2 pos{ agents[idx]->GetPosition() };
+		m_PositionsX[idx] = pos.x;
+		m_PositionsY[idx] = pos.y;
+	}
+
+	Rebuild(m_PositionsX.data(), m_PositionsY.data(), static_cast<int>(agents.size()));
+}
+
+int LooseQuadtree::QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int* pNeighbors, int capacity) const
+{
+	int nrOfNeighbors{ 0 };
+	ForEachNode(pos, queryRadius, m_HasRadii, false, [this, &pos, queryRadius, excludeIdx, pNeighbors, capacity, &nrOfNeighbors](int nodeIdx)
+		{
+			for (const NodeItem& item : m_NodeItems[nodeIdx])
+			{
+				const float x{ item.x - pos.x };
+				const float y{ item.y - pos.y };
+				if (x * x + y * y < Elite::Square(queryRadius + item.radius) && item.itemIdx != excludeIdx)
+				{
+					if (nrOfNeighbors == capacity)
+						return false;
+					pNeighbors[nrOfNeighbors++] = item.itemIdx;
+				}
+			}
+			return true;
+		});
+	return nrOfNeighbors;
+}
+
+void LooseQuadtree::QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, std::vector<int>& neighbors) const
+{
+	neighbors.clear();
+	ForEachNode(pos, queryRadius, m_HasRadii, false, [this, &pos, queryRadius, excludeIdx, &neighbors](int nodeIdx)
 		{
-			if (pAgent != agent)
+			for (const NodeItem& item : m_NodeItems[nodeIdx])
 			{
-				m_Neighbors[m_NrOfNeighbors] = pAgent;
-				++m_NrOfNeighbors;
+				const float x{ item.x - pos.x };
+				const float y{ item.y - pos.y };
+				if (x * x + y * y < Elite::Square(queryRadius + item.radius) && item.itemIdx != excludeIdx)
+					neighbors.push_back(item.itemIdx);
 			}
+			return true;
+		});
+}
+
+int LooseQuadtree::QueryNearest(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int k, int* pNearest) const
+{
+	k = Elite::Clamp(k, 0, MaxNrOfNearest);
+	if (k == 0)
+		return 0;
+
+	// Same selection as the spatial hash. The positions of the items are inside their node, so the loose bounds don't matter
+	std::array<float, MaxNrOfNearest> distancesSquared;
+	int nrOfNearest{ 0 };
+	float radius{ queryRadius };
+	float radiusSquared{ queryRadius * queryRadius };
+	ForEachNode(pos, radius, false, true, [this, &pos, excludeIdx, k, pNearest, &distancesSquared, &nrOfNearest, &radius, &radiusSquared](int nodeIdx)
+		{
+			for (const NodeItem& item : m_NodeItems[nodeIdx])
+			{
+				const float x{ item.x - pos.x };
+				const float y{ item.y - pos.y };
+				const float distanceSquared{ x * x + y * y };
+				if (!(distanceSquared < radiusSquared) || item.itemIdx == excludeIdx)
+					continue;
+
+				int idx{ nrOfNearest < k ? nrOfNearest++ : k - 1 };
+				for (; idx > 0 && distanceSquared < distancesSquared[idx - 1]; --idx)
+				{
+					distancesSquared[idx] = distancesSquared[idx - 1];
+					pNearest[idx] = pNearest[idx - 1];
+				}
+				distancesSquared[idx] = distanceSquared;
+				pNearest[idx] = item.itemIdx;
+
+				if (nrOfNearest == k)
+				{
+					radiusSquared = distancesSquared[k - 1];
+					radius = sqrtf(radiusSquared);
+				}
+			}
+			return true;
+		});
+	return nrOfNearest;
+}
+
+void LooseQuadtree::QueryBox(const Elite::Rect& box, std::vector<int>& items) const
+{
+	// The nodes near the circle around the box, then the exact test
+	const Elite::Vector2 halfSize{ box.width * 0.5f, box.height * 0.5f };
+	const Elite::Vector2 center{ box.bottomLeft + halfSize };
+	items.clear();
+	ForEachNode(center, halfSize.Magnitude(), m_HasRadii, false, [this, &box, &items](int nodeIdx)
+		{
+			for (const NodeItem& item : m_NodeItems[nodeIdx])
+			{
+				const float distanceX{ max(max(box.bottomLeft.x - item.x, item.x - (box.bottomLeft.x + box.width)), 0.f) };
+				const float distanceY{ max(max(box.bottomLeft.y - item.y, item.y - (box.bottomLeft.y + box.height)), 0.f) };
+				if (distanceX * distanceX + distanceY * distanceY <= item.radius * item.radius)
+					items.push_back(item.itemIdx);
+			}
+			return true;
+		});
+}
+
+void LooseQuadtree::RenderCells() const
+{
+	for (int level = 0; level < GetNrOfLevels(); ++level)
+	{
+		const float nodeSize{ GetNodeSize(level) };
+		for (int nodeIdx = m_LevelStarts[level]; nodeIdx < m_LevelStarts[level + 1]; ++nodeIdx)
+		{
+			if (m_NodeItems[nodeIdx].empty())
+				continue;
+
+			const int offset{ nodeIdx - m_LevelStarts[level] };
+			auto rectPoints = GetRectPoints(m_BottomLeft.x + (offset & ((1 << level) - 1)) * nodeSize, m_BottomLeft.y + (offset >> level) * nodeSize, nodeSize, nodeSize);
+			DEBUGRENDERER2D->DrawPolygon(rectPoints.data(), rectPoints.size(), { .5f, 0.f, 0.f, 0.5f }, 0.f);
+			DEBUGRENDERER2D->DrawString(rectPoints[1], std::to_string(m_NodeItems[nodeIdx].size()).c_str());
 		}
 	}
 }
 
-std::vector<int> CellSpace::GetNearbyCells(const Elite::Vector2 pos, float queryRadius) const
+LooseQuadtree::NodeRef LooseQuadtree::GetNodeRef(const Elite::Vector2& pos, float radius) const
+{
+	const float x{ (pos.x - m_BottomLeft.x) / m_Size };
+	const float y{ (pos.y - m_BottomLeft.y) / m_Size };
+	if (!(x >= 0.f && x < 1.f && y >= 0.f && y < 1.f))
+		return { 0, 0, 0 };
+
+	// The deepest level where the item sticks out less than half a node
+	int level{ GetNrOfLevels() - 1 };
+	while (level > 0 && 2.f * radius > GetNodeSize(level))
+		--level;
+
+	const int nrOfNodes{ 1 << level };
+	return { level, min(static_cast<int>(x * nrOfNodes), nrOfNodes - 1), min(static_cast<int>(y * nrOfNodes), nrOfNodes - 1) };
+}
+
+void LooseQuadtree::AddToNode(int itemIdx, int nodeIdx, const Elite::Vector2& pos, float radius)
+{
+	std::vector<NodeItem>& items{ m_NodeItems[nodeIdx] };
+	m_ItemLocations[itemIdx] = { nodeIdx, static_cast<int>(items.size()) };
+	items.push_back({ pos.x, pos.y, radius, itemIdx });
+	m_HasRadii = m_HasRadii || radius > 0.f;
+	++m_NrOfLevelItems[GetLevel(nodeIdx)];
+}
+
+void LooseQuadtree::RemoveFromNode(int itemIdx)
+{
+	// The last item of the node takes the slot
+	ItemLocation& location{ m_ItemLocations[itemIdx] };
+	std::vector<NodeItem>& items{ m_NodeItems[location.node] };
+	items[location.slot] = items.back();
+	m_ItemLocations[items[location.slot].itemIdx].slot = location.slot;
+	items.pop_back();
+
+	--m_NrOfLevelItems[GetLevel(location.node)];
+	location = { -1, -1 };
+}
+
+int LooseQuadtree::GetLevel(int nodeIdx) const
 {
-	// Find out which Cells are in the agent's neighborhood
-	// Get indexes of the cells that are in the agent's neighborhood
-	int left{ static_cast<int>(floor((pos.x - queryRadius) / m_CellWidth)) };
-	int right{ static_cast<int>(ceil((pos.x + queryRadius) / m_CellWidth)) };
-	int top{ static_cast<int>(floor((pos.y - queryRadius) / m_CellHeight)) };
-	int bottom{ static_cast<int>(ceil((pos.y + queryRadius) / m_CellHeight)) };
+	int level{ GetNrOfLevels() - 1 };
+	while (nodeIdx < m_LevelStarts[level])
+		--level;
+	return level;
+}
 
-	// Clamp indexes so they don't go out of bounds
-	left = Elite::Clamp(left, 0, m_NrOfCols - 1);
-	right = Elite::Clamp(right, 0, m_NrOfCols - 1);
-	top = Elite::Clamp(top, 0, m_NrOfRows - 1);
-	bottom = Elite::Clamp(bottom, 0, m_NrOfRows - 1);
+template<typename VisitNode>
+void LooseQuadtree::ForEachNode(const Elite::Vector2& pos, const float& queryRadius, bool isLoose, bool isNearestFirst, VisitNode visitNode) const
+{
+	// The root also holds the items outside the square, it is always visited
+	if (!m_NodeItems[0].empty() && !visitNode(0))
+		return;
 
-	// Get the cell indexes in the neighborhood
-	std::vector<int> cellIndexes;
-	cellIndexes.reserve(m_NrOfRows * m_NrOfCols);
-	for (int row = top; row <= bottom; ++row)
+	// The deepest level first. The nodes of a level near the query are a range of its grid, clamped to the square.
+	// queryRadius is read again for every node, visitNode may shrink it
+	for (int level = GetNrOfLevels() - 1; level > 0; --level)
 	{
-		for (int col = left; col <= right; ++col)
+		if (m_NrOfLevelItems[level] == 0)
+			continue;
+
+		const float nodeSize{ GetNodeSize(level) };
+		const float margin{ isLoose ? nodeSize * 0.5f : 0.f }; //Items stick out of their node by up to half its size
+		const int nrOfNodes{ 1 << level };
+		auto toNode = [this, nodeSize, nrOfNodes](float coordinate, float origin)
+		{
+			return static_cast<int>(Elite::Clamp(floorf((coordinate - origin) / nodeSize), 0.f, static_cast<float>(nrOfNodes - 1)));
+		};
+		const int left{ toNode(pos.x - queryRadius - margin, m_BottomLeft.x) };
+		const int right{ toNode(pos.x + queryRadius + margin, m_BottomLeft.x) };
+		const int bottom{ toNode(pos.y - queryRadius - margin, m_BottomLeft.y) };
+		const int top{ toNode(pos.y + queryRadius + margin, m_BottomLeft.y) };
+
+		auto getDistanceSquared = [this, &pos, nodeSize](int nodeX, int nodeY)
+		{
+			const float nodeLeft{ m_BottomLeft.x + nodeX * nodeSize };
+			const float nodeBottom{ m_BottomLeft.y + nodeY * nodeSize };
+			const float distanceX{ max(max(nodeLeft - pos.x, pos.x - (nodeLeft + nodeSize)), 0.f) };
+			const float distanceY{ max(max(nodeBottom - pos.y, pos.y - (nodeBottom + nodeSize)), 0.f) };
+			return distanceX * distanceX + distanceY * distanceY;
+		};
+
+		// Nearest first, like the spatial hash, so a shrinking radius skips the far nodes
+		const int nrOfNodesInRange{ (right - left + 1) * (top - bottom + 1) };
+		if (isNearestFirst && nrOfNodesInRange <= 64)
+		{
+			std::array<std::pair<float, int>, 64> nodes;
+			int nrOfNodesWithItems{ 0 };
+			for (int nodeY = bottom; nodeY <= top; ++nodeY)
+			{
+				for (int nodeX = left; nodeX <= right; ++nodeX)
+				{
+					const int nodeIdx{ GetNodeIdx({ level, nodeX, nodeY }) };
+					if (!m_NodeItems[nodeIdx].empty())
+						nodes[nrOfNodesWithItems++] = { getDistanceSquared(nodeX, nodeY), nodeIdx };
+				}
+			}
+			std::sort(nodes.begin(), nodes.begin() + nrOfNodesWithItems);
+
+			for (int idx = 0; idx < nrOfNodesWithItems && nodes[idx].first < Elite::Square(queryRadius + margin); ++idx)
+			{
+				if (!visitNode(nodes[idx].second))
+					return;
+			}
+			continue;
+		}
+
+		for (int nodeY = bottom; nodeY <= top; ++nodeY)
 		{
-			cellIndexes.push_back(row * m_NrOfCols + col);
+			for (int nodeX = left; nodeX <= right; ++nodeX)
+			{
+				const int nodeIdx{ GetNodeIdx({ level, nodeX, nodeY }) };
+				if (!m_NodeItems[nodeIdx].empty() && getDistanceSquared(nodeX, nodeY) < Elite::Square(queryRadius + margin) && !visitNode(nodeIdx))
+					return;
+			}
 		}
 	}
+}
+
+// --- Obstacle Grid ---
+// ---------------------
+ObstacleGrid::ObstacleGrid(float cellSize)
+	: m_CellSize{ cellSize }
+	, m_InvCellSize{ 1.f / cellSize }
+{
+}
+
+void ObstacleGrid::Build(const Elite::Vector2* pCenters, const float* pRadii, int count)
+{
+	m_CentersX.resize(count);
+	m_CentersY.resize(count);
+	m_Radii.assign(pRadii, pRadii + count);
+
+	Elite::Vector2 bottomLeft{ FLT_MAX, FLT_MAX };
+	Elite::Vector2 topRight{ -FLT_MAX, -FLT_MAX };
+	for (int circleIdx = 0; circleIdx < count; ++circleIdx)
+	{
+		m_CentersX[circleIdx] = pCenters[circleIdx].x;
+		m_CentersY[circleIdx] = pCenters[circleIdx].y;
+		bottomLeft.x = min(bottomLeft.x, pCenters[circleIdx].x - pRadii[circleIdx]);
+		bottomLeft.y = min(bottomLeft.y, pCenters[circleIdx].y - pRadii[circleIdx]);
+		topRight.x = max(topRight.x, pCenters[circleIdx].x + pRadii[circleIdx]);
+		topRight.y = max(topRight.y, pCenters[circleIdx].y + pRadii[circleIdx]);
+	}
 
-	return cellIndexes;
+	// Sweeps outside the bounds are clamped to the border cells, which is right: nothing is outside
+	m_BottomLeft = count > 0 ? bottomLeft : Elite::ZeroVector2;
+	const int maxNrOfCells{ 1 << 20 };
+	if (count > 0 && (topRight.x - bottomLeft.x) * (topRight.y - bottomLeft.y) * m_InvCellSize * m_InvCellSize > maxNrOfCells)
+	{
+		m_CellSize = sqrtf((topRight.x - bottomLeft.x) * (topRight.y - bottomLeft.y) / maxNrOfCells);
+		m_InvCellSize = 1.f / m_CellSize;
+	}
+	m_NrOfCols = count > 0 ? static_cast<int>((topRight.x - bottomLeft.x) * m_InvCellSize) + 1 : 1;
+	m_NrOfRows = count > 0 ? static_cast<int>((topRight.y - bottomLeft.y) * m_InvCellSize) + 1 : 1;
+
+	// Counting sort of the (circle, cell) pairs, like the spatial hash
+	m_CellStarts.assign(m_NrOfCols * m_NrOfRows + 1, 0);
+	for (int circleIdx = 0; circleIdx < count; ++circleIdx)
+		ForEachOverlappedCell(circleIdx, [this](int cellIdx) { ++m_CellStarts[cellIdx + 1]; });
+
+	for (size_t cellIdx = 1; cellIdx < m_CellStarts.size(); ++cellIdx)
+		m_CellStarts[cellIdx] += m_CellStarts[cellIdx - 1];
+
+	m_CellCircles.resize(m_CellStarts.back());
+	std::vector<int> nextSlots(m_CellStarts.begin(), m_CellStarts.end() - 1);
+	for (int circleIdx = 0; circleIdx < count; ++circleIdx)
+		ForEachOverlappedCell(circleIdx, [this, &nextSlots, circleIdx](int cellIdx) { m_CellCircles[nextSlots[cellIdx]++] = circleIdx; });
 }
 
-void CellSpace::EmptyCells()
+void ObstacleGrid::Build(const std::vector<Obstacle*>& obstacles)
 {
-	for (Cell& c : m_Cells)
-		c.agents.clear();
+	std::vector<Elite::Vector2> centers(obstacles.size());
+	std::vector<float> radii(obstacles.size());
+	for (size_t idx = 0; idx < obstacles.size(); ++idx)
+	{
+		centers[idx] = obstacles[idx]->GetCenter();
+		radii[idx] = obstacles[idx]->GetRadius();
+	}
+	Build(centers.data(), radii.data(), static_cast<int>(obstacles.size()));
 }
 
-void CellSpace::RenderCells() const
+int ObstacleGrid::SweepCircle(const Elite::Vector2& start, const Elite::Vector2& end, float radius, float& hitFraction) const
 {
-	for (const auto& c : m_Cells)
+	const int left{ ToCol(min(start.x, end.x) - radius) };
+	const int right{ ToCol(max(start.x, end.x) + radius) };
+	const int bottom{ ToRow(min(start.y, end.y) - radius) };
+	const int top{ ToRow(max(start.y, end.y) + radius) };
+
+	// The segment against every circle grown by radius: the smallest t in [0, 1] with |start + t * sweep - center| = combined radius
+	// A circle in several cells is tested again, it gives the same t
+	const Elite::Vector2 sweep{ end - start };
+	const float sweepSquared{ sweep.MagnitudeSquared() };
+	int hitCircle{ -1 };
+	hitFraction = 1.f;
+	for (int row = bottom; row <= top; ++row)
 	{
-		auto rectPoints = c.GetRectPoints();
-		DEBUGRENDERER2D->DrawPolygon(rectPoints.data(), rectPoints.size(), { .5f, 0.f, 0.f, 0.5f }, 0.f);
+		for (int col = left; col <= right; ++col)
+		{
+			const int cellIdx{ row * m_NrOfCols + col };
+			for (int slot = m_CellStarts[cellIdx]; slot < m_CellStarts[cellIdx + 1]; ++slot)
+			{
+				const int circleIdx{ m_CellCircles[slot] };
+				const float toStartX{ start.x - m_CentersX[circleIdx] };
+				const float toStartY{ start.y - m_CentersY[circleIdx] };
+				const float distanceSquared{ toStartX * toStartX + toStartY * toStartY - Elite::Square(m_Radii[circleIdx] + radius) };
+				if (distanceSquared <= 0.f)
+				{
+					hitFraction = 0.f;
+					return circleIdx;
+				}
+
+				const float halfB{ toStartX * sweep.x + toStartY * sweep.y };
+				const float discriminant{ halfB * halfB - sweepSquared * distanceSquared };
+				if (halfB >= 0.f || discriminant < 0.f) //Moving away or passing by
+					continue;
 
-		DEBUGRENDERER2D->DrawString(c.GetRectPoints()[1], std::to_string(c.agents.size()).c_str());
+				const float t{ (-halfB - sqrtf(discriminant)) / sweepSquared };
+				if (t <= hitFraction)
+				{
+					hitFraction = t;
+					hitCircle = circleIdx;
+				}
+			}
+		}
 	}
+	return hitCircle;
 }
 
-int CellSpace::PositionToIndex(const Elite::Vector2 pos) const
+void ObstacleGrid::RenderCells() const
 {
-	// Returns the index of the Cell the position is in
-	int row{ static_cast<int>(pos.y / m_CellHeight) };
-	int col{ static_cast<int>(pos.x / m_CellWidth) };
+	for (int row = 0; row < m_NrOfRows; ++row)
+	{
+		for (int col = 0; col < m_NrOfCols; ++col)
+		{
+			const int cellIdx{ row * m_NrOfCols + col };
+			const int nrOfCircles{ m_CellStarts[cellIdx + 1] - m_CellStarts[cellIdx] };
+			if (nrOfCircles == 0)
+				continue;
 
-	Elite::ClampRef(row, 0, m_NrOfRows - 1);
-	Elite::ClampRef(col, 0, m_NrOfRows - 1);
+			auto rectPoints = GetRectPoints(m_BottomLeft.x + col * m_CellSize, m_BottomLeft.y + row * m_CellSize, m_CellSize, m_CellSize);
+			DEBUGRENDERER2D->DrawPolygon(rectPoints.data(), rectPoints.size(), { 0.f, .5f, 0.f, 0.5f }, 0.f);
+			DEBUGRENDERER2D->DrawString(rectPoints[1], std::to_string(nrOfCircles).c_str());
+		}
+	}
+}
 
-	return abs(row * m_NrOfCols + col);
+template<typename VisitCell>
+void ObstacleGrid::ForEachOverlappedCell(int circleIdx, VisitCell visitCell) const
+{
+	const float x{ m_CentersX[circleIdx] };
+	const float y{ m_CentersY[circleIdx] };
+	const float radius{ m_Radii[circleIdx] };
+	for (int row = ToRow(y - radius); row <= ToRow(y + radius); ++row)
+	{
+		for (int col = ToCol(x - radius); col <= ToCol(x + radius); ++col)
+		{
+			// Skip the corner cells of the bounding box that the circle misses
+			const float cellLeft{ m_BottomLeft.x + col * m_CellSize };
+			const float cellBottom{ m_BottomLeft.y + row * m_CellSize };
+			const float distanceX{ max(max(cellLeft - x, x - (cellLeft + m_CellSize)), 0.f) };
+			const float distanceY{ max(max(cellBottom - y, y - (cellBottom + m_CellSize)), 0.f) };
+			if (distanceX * distanceX + distanceY * distanceY <= radius * radius)
+				visitCell(row * m_NrOfCols + col);
+		}
+	}
 }
@@ -2,72 +2,186 @@
 // Copyright 2019-2020
 // Authors: Yosha Vandaele
 /*=============================================================================*/
-// SpacePartitioning.h: Contains Cell and Cellspace which are used to partition a space in segments.
-// Cells contain pointers to all the agents within.
-// These are used to avoid unnecessary distance comparisons to agents that are far away.
+// SpacePartitioning.h: Partitions of space, used to avoid unnecessary distance comparisons to agents that are far away.
+// SpatialHash is a grid without bounds, rebuilt from scratch every frame.
+// LooseQuadtree adapts to clustered points and moves them only when they change node.
+// SpatialHash and LooseQuadtree share Rebuild, QueryNeighbors, QueryNearest and RenderCells,
+// so code that looks up neighbors can take either as a template parameter.
+// ObstacleGrid holds static obstacles, built once and swept through by the obstacle avoidance.
 
 // Heavily based on chapter 3 of "Programming Game AI by Example" - Mat Buckland
 /*=============================================================================*/
 
 #pragma once
-#include <list>
 #include <vector>
-#include <iterator>
 #include "framework\EliteMath\EVector2.h"
 #include "framework\EliteGeometry\EGeometry2DTypes.h"
 
 class SteeringAgent;
-
-// --- Cell ---
-// ------------
-struct Cell
+class Obstacle;
+
+// --- Spatial Hash ---
+// --------------------
+// Grid of cellSize squares over an unbounded world, the cell coordinates are hashed to a fixed amount of buckets.
+// Rebuild sorts the points by bucket with a counting sort (counts, prefix sum, scatter), so every bucket is
+// a contiguous slice of one index array and of the sorted positions. Nothing is allocated once the buffers are big enough.
+class SpatialHash final
 {
-	Cell(float left, float bottom, float width, float height);
+public:
+	SpatialHash(float cellSize, int nrOfBuckets = 4096); //nrOfBuckets is rounded up to a power of two
+
+	void Rebuild(const float* pPositionsX, const float* pPositionsY, int count);
+	void Rebuild(const std::vector<SteeringAgent*>& agents); //Point i is agent i
 
-	std::vector<Elite::Vector2> GetRectPoints() const;
+	//The indices of the points within queryRadius of pos, except excludeIdx, are written to pNeighbors. Returns how many, at most capacity.
+	//Safe to call from multiple threads between two rebuilds.
+	int QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int* pNeighbors, int capacity) const;
+	//Same, written to neighbors (cleared first, keeps its capacity)
+	void QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, std::vector<int>& neighbors) const;
+	//Only the k (at most MaxNrOfNearest) nearest of those, nearest first. A partial selection in a buffer of k while the points
+	//are filtered, so no list of all the points in range is made. Returns how many.
+	static const int MaxNrOfNearest = 32;
+	int QueryNearest(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int k, int* pNearest) const;
 
-	// all the agents currently in this cell
-	std::list<SteeringAgent*> agents;
-	Elite::Rect boundingBox;
+	float GetCellSize() const { return m_CellSize; }
+	int GetNrOfPoints() const { return static_cast<int>(m_SortedIndices.size()); }
+
+	void RenderCells() const; //The cells that contain points
+
+private:
+	float m_CellSize;
+	float m_InvCellSize;
+	int m_BucketMask;
+
+	std::vector<int> m_BucketStarts; //Bucket b holds the sorted points [m_BucketStarts[b], m_BucketStarts[b + 1])
+	std::vector<int> m_PointBuckets; //Scratch of Rebuild
+	std::vector<int> m_SortedIndices;
+	std::vector<float> m_SortedPositionsX;
+	std::vector<float> m_SortedPositionsY;
+	std::vector<float> m_PositionsX; //Scratch of the agent rebuild
+	std::vector<float> m_PositionsY;
+
+	int ToCell(float coordinate) const { return static_cast<int>(floorf(coordinate * m_InvCellSize)); }
+	int GetBucket(int cellX, int cellY) const;
+	template<typename AddNeighbor>
+	void ForEachNeighbor(const Elite::Vector2& pos, float queryRadius, int excludeIdx, AddNeighbor addNeighbor) const; //addNeighbor(pointIdx, distanceSquared), stops when it returns false
+	template<typename AddNeighbor>
+	bool FilterPoints(int begin, int end, const Elite::Vector2& pos, const float& queryRadiusSquared, int excludeIdx, AddNeighbor& addNeighbor) const; //SIMD when available
 };
 
-// --- Partitioned Space ---
-// -------------------------
-class CellSpace
+// --- Loose Quadtree ---
+// ----------------------
+// Quadtree over a square. Every node also holds items that stick out of it by up to half its size, its loose bounds are twice as big,
+// so an item is stored in one node: the deepest one that is at least twice its radius, found from its position without walking the tree.
+// The nodes of a level are a full grid and every node keeps its items in an array, so insert, move and remove cost O(levels)
+// and allocate nothing once the arrays are big enough. Queries go level by level like in a hierarchical grid, through the nodes near the query,
+// and skip the levels without items. Items outside the square are kept in the root, correct but checked by every query.
+class LooseQuadtree final
 {
 public:
-	CellSpace(float width, float height, int rows, int cols, int maxEntities);
+	LooseQuadtree(const Elite::Vector2& bottomLeft, float size, float minNodeSize); //The nodes of the deepest level are at least minNodeSize, at most 8 levels
 
-	void AddAgent(SteeringAgent* agent);
-	void UpdateAgentCell(SteeringAgent* agent, Elite::Vector2 oldPos);
+	int Insert(const Elite::Vector2& pos, float radius = 0.f); //Returns the index of the item, the index of a removed item is reused
+	void Move(int itemIdx, const Elite::Vector2& pos, float radius = 0.f); //Only changes node when the item leaves its node
+	void Remove(int itemIdx);
+	void Clear();
 
-	void RegisterNeighbors(SteeringAgent* agent, float queryRadius);
-	const std::vector<SteeringAgent*>& GetNeighbors() const { return m_Neighbors; }
-	int GetNrOfNeighbors() const { return m_NrOfNeighbors; }
+	//Point i is item i. Moves the items when the count didn't change, inserts them all otherwise
+	void Rebuild(const float* pPositionsX, const float* pPositionsY, int count);
+	void Rebuild(const std::vector<SteeringAgent*>& agents); //Point i is agent i
 
-	//empties the cells of entities
-	void EmptyCells();
+	//The indices of the items that overlap the circle (for points: within queryRadius of pos), except excludeIdx, are written to pNeighbors.
+	//Returns how many, at most capacity. Safe to call from multiple threads while nothing is inserted, moved or removed.
+	int QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int* pNeighbors, int capacity) const;
+	//Same, written to neighbors (cleared first, keeps its capacity)
+	void QueryNeighbors(const Elite::Vector2& pos, float queryRadius, int excludeIdx, std::vector<int>& neighbors) const;
+	//The k (at most MaxNrOfNearest) items nearest to pos, by their position, within queryRadius, nearest first. Returns how many.
+	static const int MaxNrOfNearest = 32;
+	int QueryNearest(const Elite::Vector2& pos, float queryRadius, int excludeIdx, int k, int* pNearest) const;
+	//The items whose circle (position and radius, a point without radii) overlaps the box, cleared first
+	void QueryBox(const Elite::Rect& box, std::vector<int>& items) const;
 
-	void RenderCells()const;
+	int GetNrOfLevels() const { return static_cast<int>(m_LevelStarts.size()) - 1; }
+	int GetNrOfItems() const { return static_cast<int>(m_ItemLocations.size() - m_FreeItems.size()); }
+
+	void RenderCells() const; //The nodes that contain items
 
 private:
-	// Cells and properties
-	std::vector<Cell> m_Cells;
+	struct NodeItem
+	{
+		float x, y, radius;
+		int itemIdx;
+	};
+	struct ItemLocation
+	{
+		int node, slot; //node -1: removed
+	};
+	struct NodeRef
+	{
+		int level, x, y;
+	};
+
+	Elite::Vector2 m_BottomLeft;
+	float m_Size;
+
+	std::vector<int> m_LevelStarts; //Level l holds the nodes [m_LevelStarts[l], m_LevelStarts[l + 1]), row by row
+	std::vector<std::vector<NodeItem>> m_NodeItems;
+	std::vector<int> m_NrOfLevelItems;
+	std::vector<ItemLocation> m_ItemLocations;
+	std::vector<int> m_FreeItems;
+	bool m_HasRadii = false; //An item with a radius was added since the last clear, queries have to look in the loose bounds
+	std::vector<float> m_PositionsX; //Scratch of the agent rebuild
+	std::vector<float> m_PositionsY;
+
+	float GetNodeSize(int level) const { return m_Size / static_cast<float>(1 << level); }
+	int GetNodeIdx(const NodeRef& node) const { return m_LevelStarts[node.level] + (node.y << node.level) + node.x; }
+	NodeRef GetNodeRef(const Elite::Vector2& pos, float radius) const;
+	void AddToNode(int itemIdx, int nodeIdx, const Elite::Vector2& pos, float radius);
+	void RemoveFromNode(int itemIdx);
+	int GetLevel(int nodeIdx) const;
+	template<typename VisitNode>
+	void ForEachNode(const Elite::Vector2& pos, const float& queryRadius, bool isLoose, bool isNearestFirst, VisitNode visitNode) const; //Nodes that may hold items within queryRadius, visitNode(nodeIdx) stops when it returns false
+};
+
+// --- Obstacle Grid ---
+// ---------------------
+// Grid over the bounds of static circular obstacles, built once. Every cell lists the obstacles that overlap it,
+// the lists are slices of one index array. A sweep only checks the obstacles of the cells around it,
+// so for sweeps of about a cell the cost doesn't grow with the number of obstacles.
+class ObstacleGrid final
+{
+public:
+	explicit ObstacleGrid(float cellSize); //Bigger cells when the bounds would need more than a million
 
-	float m_SpaceWidth;
-	float m_SpaceHeight;
+	void Build(const Elite::Vector2* pCenters, const float* pRadii, int count);
+	void Build(const std::vector<Obstacle*>& obstacles); //Circle i is obstacle i
 
-	int m_NrOfRows;
-	int m_NrOfCols;
+	//A circle of radius moving from start to end: returns the first circle it hits, -1 if none.
+	//hitFraction is how far along the way, 0 when it already overlaps at start. Safe to call from multiple threads between two builds.
+	int SweepCircle(const Elite::Vector2& start, const Elite::Vector2& end, float radius, float& hitFraction) const;
 
-	float m_CellWidth;
-	float m_CellHeight;
+	Elite::Vector2 GetCenter(int circleIdx) const { return { m_CentersX[circleIdx], m_CentersY[circleIdx] }; }
+	float GetRadius(int circleIdx) const { return m_Radii[circleIdx]; }
+	int GetNrOfCircles() const { return static_cast<int>(m_Radii.size()); }
+	float GetCellSize() const { return m_CellSize; }
 
-	// Members to avoid memory allocation on every frame
-	std::vector<SteeringAgent*> m_Neighbors;
-	int m_NrOfNeighbors;
+	void RenderCells() const; //The cells that hold obstacles
 
-	// Helper functions
-	int PositionToIndex(const Elite::Vector2 pos) const;
-	std::vector<int> GetNearbyCells(const Elite::Vector2 pos, float queryRadius) const;
+private:
+	float m_CellSize;
+	float m_InvCellSize;
+	Elite::Vector2 m_BottomLeft{};
+	int m_NrOfCols = 0;
+	int m_NrOfRows = 0;
+
+	std::vector<int> m_CellStarts; //Cell c (row by row) holds the circles [m_CellStarts[c], m_CellStarts[c + 1]) of m_CellCircles
+	std::vector<int> m_CellCircles;
+	std::vector<float> m_CentersX;
+	std::vector<float> m_CentersY;
+	std::vector<float> m_Radii;
+
+	int ToCol(float x) const { return Elite::Clamp(static_cast<int>(floorf((x - m_BottomLeft.x) * m_InvCellSize)), 0, m_NrOfCols - 1); }
+	int ToRow(float y) const { return Elite::Clamp(static_cast<int>(floorf((y - m_BottomLeft.y) * m_InvCellSize)), 0, m_NrOfRows - 1); }
+	template<typename VisitCell>
+	void ForEachOverlappedCell(int circleIdx, VisitCell visitCell) const; //The cells the circle overlaps, visitCell(cellIdx)
 };
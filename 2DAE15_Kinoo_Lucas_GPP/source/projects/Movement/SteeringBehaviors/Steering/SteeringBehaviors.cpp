@@ -5,21 +5,129 @@
 #include "SteeringBehaviors.h"
 #include "../SteeringAgent.h"
 #include "../Obstacle.h"
+#include "../SpacePartitioning/SpacePartitioning.h"
 #include "framework/EliteMath/EMatrix2x3.h"
 
+//BATCH HELPERS
+//*************
+AgentSpan::AgentSpan(const KinematicAgentPool& pool, int first, int count, SteeringAgent* const* ppAgents /*= nullptr*/)
+	: pPositionsX(pool.GetPositionsX() + first)
+	, pPositionsY(pool.GetPositionsY() + first)
+	, pLinearVelocitiesX(pool.GetLinearVelocitiesX() + first)
+	, pLinearVelocitiesY(pool.GetLinearVelocitiesY() + first)
+	, pOrientations(pool.GetOrientations() + first)
+	, pMaxLinearSpeeds(pool.GetMaxLinearSpeeds() + first)
+	, ppAgents(ppAgents)
+	, Count(count)
+{
+}
+
+SteeringState& AgentSpan::GetState(int idx) const
+{
+	return pStates ? pStates[idx] : ppAgents[idx]->GetSteeringState();
+}
+
+AgentSpan AgentSpan::Slice(int first, int count) const
+{
+	AgentSpan slice{ *this };
+	slice.pPositionsX += first;
+	slice.pPositionsY += first;
+	slice.pLinearVelocitiesX += first;
+	slice.pLinearVelocitiesY += first;
+	slice.pOrientations += first;
+	slice.pMaxLinearSpeeds += first;
+	slice.ppAgents = ppAgents ? ppAgents + first : nullptr;
+	slice.pStates = pStates ? pStates + first : nullptr;
+	slice.Count = count;
+	return slice;
+}
+
+namespace
+{
+	//Desired velocity of Seek, with the same operations as Seek::CalculateSteering (Vector2::Normalize without the branch)
+	//so the batched behaviors give exactly the same results as the ones per agent
+	inline void SeekVelocity(float targetX, float targetY, float positionX, float positionY, float maxLinearSpeed, Elite::Vector2& linearVelocity)
+	{
+		const float x{ targetX - positionX };
+		const float y{ targetY - positionY };
+		const float magnitude{ sqrtf(x * x + y * y) };
+		const float invMagnitude{ magnitude > FLT_EPSILON ? 1.f / magnitude : 0.f };
+		linearVelocity.x = x * invMagnitude * maxLinearSpeed;
+		linearVelocity.y = y * invMagnitude * maxLinearSpeed;
+	}
+
+	//Only write the linear and angular velocity
+	void SeekTowards(const Elite::Vector2& target, const AgentSpan& agents, SteeringOutput* pOutputs)
+	{
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+		{
+			SeekVelocity(target.x, target.y, agents.pPositionsX[idx], agents.pPositionsY[idx], agents.pMaxLinearSpeeds[idx], pOutputs[idx].LinearVelocity);
+			pOutputs[idx].AngularVelocity = 0.f;
+		}
+	}
+
+	//Target of each agent stored in the linear velocity of its output (overwritten by the result)
+	void SeekTowardsOutputs(const AgentSpan& agents, SteeringOutput* pOutputs)
+	{
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+		{
+			const Elite::Vector2 target{ pOutputs[idx].LinearVelocity };
+			SeekVelocity(target.x, target.y, agents.pPositionsX[idx], agents.pPositionsY[idx], agents.pMaxLinearSpeeds[idx], pOutputs[idx].LinearVelocity);
+			pOutputs[idx].AngularVelocity = 0.f;
+		}
+	}
+
+	void SetValid(const AgentSpan& agents, SteeringOutput* pOutputs, bool isValid)
+	{
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+			pOutputs[idx].IsValid = isValid;
+	}
+
+	void NegateLinearVelocities(const AgentSpan& agents, SteeringOutput* pOutputs)
+	{
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+			pOutputs[idx].LinearVelocity = -pOutputs[idx].LinearVelocity;
+	}
+}
+
+//ISTEERINGBEHAVIOR
+//*****************
+void ISteeringBehavior::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+		pOutputs[idx] = CalculateSteering(deltaT, agents.ppAgents[idx]);
+}
+
 //SEEK
 //****
 SteeringOutput Seek::CalculateSteering(float deltaT, SteeringAgent* pAgent)
+{
+	return SeekTo(m_Target.Position, pAgent);
+}
+
+SteeringOutput Seek::SeekTo(const Elite::Vector2& target, const SteeringAgent* pAgent)
 {
 	SteeringOutput steering{};
 
-	steering.LinearVelocity = m_Target.Position - pAgent->GetPosition(); //Desired Velocity
+	steering.LinearVelocity = target - pAgent->GetPosition(); //Desired Velocity
 	steering.LinearVelocity.Normalize(); //Normalize Desired Velocity
 	steering.LinearVelocity *= pAgent->GetMaxLinearSpeed(); //Rescale to Max Speed
 
 	return steering;
 }
 
+void Seek::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	SeekTowards(m_Target.Position, agents, pOutputs);
+	SetValid(agents, pOutputs, true);
+}
+
+void Seek::SeekOutputTargets(const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	SeekTowardsOutputs(agents, pOutputs);
+	SetValid(agents, pOutputs, true);
+}
+
 //FLEE
 //****
 SteeringOutput Flee::CalculateSteering(float deltaT, SteeringAgent* pAgent)
@@ -31,6 +139,12 @@ SteeringOutput Flee::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 	return steering;
 }
 
+void Flee::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	Seek::CalculateSteeringBatch(deltaT, agents, pOutputs);
+	NegateLinearVelocities(agents, pOutputs);
+}
+
 //ARRIVE
 //****
 SteeringOutput Arrive::CalculateSteering(float deltaT, SteeringAgent* pAgent)
@@ -45,7 +159,7 @@ SteeringOutput Arrive::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 		steering.LinearVelocity *= pAgent->GetMaxLinearSpeed() * (distance - m_SlowRadius) / m_TargetRadius;
 	}
 
-	if (pAgent->CanRenderBehavior())
+	if (ELITE_STEERING_DEBUG_RENDERING && pAgent->CanRenderBehavior())
 	{
 		DEBUGRENDERER2D->DrawCircle(pAgent->GetPosition(), m_SlowRadius, { 1.f, 0.25f, 0.f, 0.5f }, 0.40f);
 
@@ -56,6 +170,27 @@ SteeringOutput Arrive::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 	return steering;
 }
 
+void Arrive::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	Seek::CalculateSteeringBatch(deltaT, agents, pOutputs);
+
+	//Inside the target radius: normalize the seek velocity again and scale it down with the distance
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		const float toTargetX{ m_Target.Position.x - agents.pPositionsX[idx] };
+		const float toTargetY{ m_Target.Position.y - agents.pPositionsY[idx] };
+		const float distance{ sqrtf(toTargetX * toTargetX + toTargetY * toTargetY) };
+
+		Elite::Vector2& linearVelocity{ pOutputs[idx].LinearVelocity };
+		const float magnitude{ sqrtf(linearVelocity.x * linearVelocity.x + linearVelocity.y * linearVelocity.y) };
+		const float invMagnitude{ magnitude > FLT_EPSILON ? 1.f / magnitude : 0.f };
+		const float scale{ agents.pMaxLinearSpeeds[idx] * (distance - m_SlowRadius) / m_TargetRadius };
+		const bool isInside{ distance < m_TargetRadius };
+		linearVelocity.x = isInside ? linearVelocity.x * invMagnitude * scale : linearVelocity.x;
+		linearVelocity.y = isInside ? linearVelocity.y * invMagnitude * scale : linearVelocity.y;
+	}
+}
+
 //FACE
 //****
 SteeringOutput Face::CalculateSteering(float deltaT, SteeringAgent* pAgent)
@@ -72,18 +207,36 @@ SteeringOutput Face::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 	return steering;
 }
 
+void Face::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	if (agents.ppAgents)
+	{
+		for (int idx{ 0 }; idx < agents.Count; ++idx)
+			agents.ppAgents[idx]->SetAutoOrient(false);
+	}
+
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		const float angle{ atan2f(m_Target.Position.y - agents.pPositionsY[idx], m_Target.Position.x - agents.pPositionsX[idx]) };
+		pOutputs[idx].LinearVelocity = Elite::ZeroVector2;
+		pOutputs[idx].AngularVelocity = angle - Elite::ClampedAngle(agents.pOrientations[idx]);
+		pOutputs[idx].IsValid = true;
+	}
+}
+
 //WANDER
 //****
 SteeringOutput Wander::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 {
+	SteeringState& state{ pAgent->GetSteeringState() };
 	const Elite::Vector2 circleCenter{ pAgent->GetPosition() + pAgent->GetLinearVelocity().GetNormalized() * m_OffsetDistance };
 
-	m_WanderAngle += (Elite::randomFloat(0, 1) * m_MaxAngleChange - m_MaxAngleChange * .5f);
-	Elite::ClampRef(m_WanderAngle, Elite::ToRadians(-90), Elite::ToRadians(90));
+	state.WanderAngle += (state.Random.NextFloat() * m_MaxAngleChange - m_MaxAngleChange * .5f);
+	Elite::ClampRef(state.WanderAngle, Elite::ToRadians(-90), Elite::ToRadians(90));
 
-	m_Target.Position = (circleCenter + Elite::Vector2{ cosf(m_WanderAngle), sinf(m_WanderAngle) } *m_Radius);
+	state.Target.Position = (circleCenter + Elite::Vector2{ cosf(state.WanderAngle), sinf(state.WanderAngle) } *m_Radius);
 
-	if (pAgent->CanRenderBehavior())
+	if (ELITE_STEERING_DEBUG_RENDERING && pAgent->CanRenderBehavior())
 	{
 		// Draw desired velocity again to display it above the line to circle center
 		//DEBUGRENDERER2D->DrawDirection(pAgent->GetPosition(), pAgent->GetLinearVelocity(), pAgent->GetLinearVelocity().Magnitude(), {1.f, 0.f, 1.f, 0.5f}, 0.40f);
@@ -92,33 +245,78 @@ SteeringOutput Wander::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 		DEBUGRENDERER2D->DrawCircle(circleCenter, m_Radius, { 0.f, 0.f, 1.f, 0.5f }, 0.40f);
 
 		// Draw target
-		DEBUGRENDERER2D->DrawSolidCircle(m_Target.Position, 0.1f, {}, { 0.f, 1.f, 0.f }, 0.40f);
+		DEBUGRENDERER2D->DrawSolidCircle(state.Target.Position, 0.1f, {}, { 0.f, 1.f, 0.f }, 0.40f);
 
 		// Draw line to circle center
 		DEBUGRENDERER2D->DrawDirection(pAgent->GetPosition(), pAgent->GetLinearVelocity(), m_OffsetDistance, { 0.f, 0.f, 1.f, 0.5f }, 0.40f);
 	}
 
-	return Seek::CalculateSteering(deltaT, pAgent);
+	return SeekTo(state.Target.Position, pAgent);
+}
+
+void Wander::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		SteeringState& state{ agents.GetState(idx) };
+		const Elite::Vector2 position{ agents.pPositionsX[idx], agents.pPositionsY[idx] };
+		const Elite::Vector2 linearVelocity{ agents.pLinearVelocitiesX[idx], agents.pLinearVelocitiesY[idx] };
+		const Elite::Vector2 circleCenter{ position + linearVelocity.GetNormalized() * m_OffsetDistance };
+
+		state.WanderAngle += (state.Random.NextFloat() * m_MaxAngleChange - m_MaxAngleChange * .5f);
+		Elite::ClampRef(state.WanderAngle, Elite::ToRadians(-90), Elite::ToRadians(90));
+
+		state.Target.Position = (circleCenter + Elite::Vector2{ cosf(state.WanderAngle), sinf(state.WanderAngle) } *m_Radius);
+		pOutputs[idx].LinearVelocity = state.Target.Position;
+	}
+
+	SeekTowardsOutputs(agents, pOutputs);
+	SetValid(agents, pOutputs, true);
 }
 
 //PURSUIT
 //****
 SteeringOutput Pursuit::CalculateSteering(float deltaT, SteeringAgent* pAgent)
+{
+	SteeringState& state{ pAgent->GetSteeringState() };
+	state.Target.Position = PredictTarget(pAgent->GetPosition(), pAgent->GetMaxLinearSpeed());
+
+	if (ELITE_STEERING_DEBUG_RENDERING && pAgent->CanRenderBehavior())
+	{
+		DEBUGRENDERER2D->DrawSolidCircle(state.Target.Position, 0.25f, {}, { 1.f, 0.f, 1.f }, 0.40f);
+	}
+
+	return SeekTo(state.Target.Position, pAgent);
+}
+
+void Pursuit::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	PredictTargets(agents, pOutputs);
+	SeekTowardsOutputs(agents, pOutputs);
+	SetValid(agents, pOutputs, true);
+}
+
+Elite::Vector2 Pursuit::PredictTarget(const Elite::Vector2& position, float maxLinearSpeed) const
 {
 	// The code below works super well! But it's not the same as in the provided solution
-	//m_Target.Position = m_Target.Position + m_Target.LinearVelocity * m_Target.GetDirection() * (pAgent->GetPosition() - m_Target.Position).Magnitude() / pAgent->GetMaxLinearSpeed();
+	//return m_Target.Position + m_Target.LinearVelocity * m_Target.GetDirection() * (position - m_Target.Position).Magnitude() / maxLinearSpeed;
 
 	if (m_Target.LinearVelocity.Magnitude() > 0.f)
 	{
-		m_Target.Position += m_Target.GetDirection() * (m_Target.Position - pAgent->GetPosition()).Magnitude() / pAgent->GetMaxLinearSpeed();
+		return m_Target.Position + m_Target.GetDirection() * (m_Target.Position - position).Magnitude() / maxLinearSpeed;
 	}
 
-	if (pAgent->CanRenderBehavior())
+	return m_Target.Position;
+}
+
+void Pursuit::PredictTargets(const AgentSpan& agents, SteeringOutput* pOutputs) const
+{
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
 	{
-		DEBUGRENDERER2D->DrawSolidCircle(m_Target.Position, 0.25f, {}, { 1.f, 0.f, 1.f }, 0.40f);
+		SteeringState& state{ agents.GetState(idx) };
+		state.Target.Position = PredictTarget({ agents.pPositionsX[idx], agents.pPositionsY[idx] }, agents.pMaxLinearSpeeds[idx]);
+		pOutputs[idx].LinearVelocity = state.Target.Position;
 	}
-
-	return Seek::CalculateSteering(deltaT, pAgent);
 }
 
 //EVADE
@@ -129,10 +327,84 @@ SteeringOutput Evade::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 	steering.LinearVelocity = -steering.LinearVelocity;
 	steering.IsValid = true;
 
-	if ((pAgent->GetPosition() - m_Target.Position).Magnitude() > m_EvadeRadius)
+	if ((pAgent->GetPosition() - pAgent->GetSteeringState().Target.Position).Magnitude() > m_EvadeRadius)
 	{
 		steering.IsValid = false;
 	}
 
 	return steering;
 }
+
+void Evade::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	PredictTargets(agents, pOutputs);
+
+	//Only valid for the agents close to their target
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		const float toTargetX{ agents.pPositionsX[idx] - pOutputs[idx].LinearVelocity.x };
+		const float toTargetY{ agents.pPositionsY[idx] - pOutputs[idx].LinearVelocity.y };
+		pOutputs[idx].IsValid = !(sqrtf(toTargetX * toTargetX + toTargetY * toTargetY) > m_EvadeRadius);
+	}
+
+	SeekTowardsOutputs(agents, pOutputs);
+	NegateLinearVelocities(agents, pOutputs);
+}
+
+//OBSTACLE AVOIDANCE
+//****
+SteeringOutput ObstacleAvoidance::CalculateSteering(float deltaT, SteeringAgent* pAgent)
+{
+	Elite::Vector2 lookAheadEnd{};
+	const SteeringOutput steering{ Avoid(pAgent->GetPosition(), pAgent->GetLinearVelocity(), pAgent->GetMaxLinearSpeed(), lookAheadEnd) };
+
+	if (ELITE_STEERING_DEBUG_RENDERING && pAgent->CanRenderBehavior())
+	{
+		DEBUGRENDERER2D->DrawSegment(pAgent->GetPosition(), lookAheadEnd, steering.IsValid ? Elite::Color{ 1.f, 0.f, 0.f } : Elite::Color{ 0.f, 1.f, 0.f }, 0.40f);
+		if (steering.IsValid)
+			DEBUGRENDERER2D->DrawCircle(lookAheadEnd, m_AgentRadius, { 1.f, 0.f, 0.f, 0.5f }, 0.40f);
+	}
+
+	return steering;
+}
+
+void ObstacleAvoidance::CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs)
+{
+	Elite::Vector2 lookAheadEnd{};
+	for (int idx{ 0 }; idx < agents.Count; ++idx)
+	{
+		pOutputs[idx] = Avoid({ agents.pPositionsX[idx], agents.pPositionsY[idx] }, { agents.pLinearVelocitiesX[idx], agents.pLinearVelocitiesY[idx] },
+			agents.pMaxLinearSpeeds[idx], lookAheadEnd);
+	}
+}
+
+SteeringOutput ObstacleAvoidance::Avoid(const Elite::Vector2& position, const Elite::Vector2& linearVelocity, float maxLinearSpeed, Elite::Vector2& lookAheadEnd) const
+{
+	lookAheadEnd = position;
+	const float speed{ linearVelocity.Magnitude() };
+	if (!m_pObstacles || speed <= FLT_EPSILON) //Standing still doesn't hit anything
+		return SteeringOutput{ Elite::ZeroVector2, 0.f, false };
+
+	const Elite::Vector2 direction{ linearVelocity / speed };
+	lookAheadEnd = position + direction * (m_MinLookAhead + m_LookAheadTime * speed);
+
+	float hitFraction{};
+	const int obstacleIdx{ m_pObstacles->SweepCircle(position, lookAheadEnd, m_AgentRadius, hitFraction) };
+	if (obstacleIdx < 0)
+		return SteeringOutput{ Elite::ZeroVector2, 0.f, false };
+
+	// Already touching: straight out. Otherwise seek the point beside the obstacle on the side the agent would touch it,
+	// twice the combined radius from its center. Straight at the center there is no side, take the left one
+	lookAheadEnd = position + hitFraction * (lookAheadEnd - position);
+	const Elite::Vector2 center{ m_pObstacles->GetCenter(obstacleIdx) };
+	if (hitFraction <= 0.f)
+		return SteeringOutput{ (position - center).GetNormalized() * maxLinearSpeed };
+
+	const Elite::Vector2 toTouch{ lookAheadEnd - center };
+	Elite::Vector2 side{ toTouch - toTouch.Dot(direction) * direction };
+	if (side.MagnitudeSquared() <= FLT_EPSILON * toTouch.MagnitudeSquared())
+		side = Elite::Vector2{ -direction.y, direction.x };
+
+	const Elite::Vector2 target{ center + side.GetNormalized() * 2.f * (m_pObstacles->GetRadius(obstacleIdx) + m_AgentRadius) };
+	return SteeringOutput{ (target - position).GetNormalized() * maxLinearSpeed };
+}
@@ -13,8 +13,17 @@
 #include "../SteeringHelpers.h"
 class SteeringAgent;
 class Obstacle;
+class ObstacleGrid;
+
+//Debug rendering of the behaviors. Define ELITE_STEERING_DEBUG_RENDERING as 0 for a variant without it (e.g. for profiling),
+//the CanRenderBehavior checks of the steering are then compiled out.
+#ifndef ELITE_STEERING_DEBUG_RENDERING
+#define ELITE_STEERING_DEBUG_RENDERING 1
+#endif
 
 #pragma region **ISTEERINGBEHAVIOR** (BASE)
+//Behaviors don't change their members while steering, what they remember of an agent is kept in its SteeringState.
+//So one behavior can steer many agents, also from multiple threads, as long as its settings and target are set in between.
 class ISteeringBehavior
 {
 public:
@@ -22,6 +31,10 @@ public:
 	virtual ~ISteeringBehavior() = default;
 
 	virtual SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) = 0;
+	//Batched version: pOutputs[i] is the steering of agent i of the span, one virtual call for all of them.
+	//The default calls CalculateSteering for every agent (needs agents.ppAgents), the behaviors below loop over the arrays of the span.
+	//Same results as CalculateSteering, but without debug rendering.
+	virtual void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs);
 
 	//Seek Functions
 	void SetTarget(const TargetData& target) { m_Target = target; }
@@ -48,6 +61,12 @@ public:
 
 	//Seek Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
+
+protected:
+	static SteeringOutput SeekTo(const Elite::Vector2& target, const SteeringAgent* pAgent);
+	//Seeks the target stored in the linear velocity of each output (overwritten by the result), for behaviors with a target per agent
+	static void SeekOutputTargets(const AgentSpan& agents, SteeringOutput* pOutputs);
 };
 
 ///////////////////////////////////////
@@ -61,6 +80,7 @@ public:
 
 	//Flee Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
 };
 
 ///////////////////////////////////////
@@ -74,6 +94,7 @@ public:
 
 	//Arrive Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
 	void SetSlowRadius(float radius) { m_SlowRadius = radius; }
 	void SetTargetRadius(float radius) { m_TargetRadius = radius; }
 
@@ -93,6 +114,7 @@ public:
 
 	//Face Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
 };
 
 ///////////////////////////////////////
@@ -106,6 +128,7 @@ public:
 
 	//Wander Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
 
 	void SetMaxAngleChange(const float& rad) { m_MaxAngleChange = rad; }
 	void SetWanderOffset(const float& offset) { m_OffsetDistance = offset; }
@@ -115,7 +138,6 @@ private:
 	float m_MaxAngleChange{ Elite::ToRadians(45.f) }; //Max WanderAngle change per frame
 	float m_OffsetDistance{ 6.f }; //Offset (Agent Direction)
 	float m_Radius{ 4.f }; //WanderRadius
-	float m_WanderAngle{ 0.f }; //Internal
 };
 
 ///////////////////////////////////////
@@ -129,6 +151,11 @@ public:
 
 	//Pursuit Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
+
+protected:
+	Elite::Vector2 PredictTarget(const Elite::Vector2& position, float maxLinearSpeed) const;
+	void PredictTargets(const AgentSpan& agents, SteeringOutput* pOutputs) const; //Stores the target of each agent in the linear velocity of its output and its state
 };
 
 ///////////////////////////////////////
@@ -142,9 +169,39 @@ public:
 
 	//Pursuit Behavior
 	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
 
 private:
 	const float m_EvadeRadius{ 10.f };
 };
 
+///////////////////////////////////////
+//OBSTACLE AVOIDANCE
+//****
+//Sweeps the agent along its velocity through a grid of static obstacles. Only valid when an obstacle is ahead,
+//put it first in a PrioritySteering (or in a BlendedSteering, where it adds nothing when the way is free).
+class ObstacleAvoidance : public ISteeringBehavior
+{
+public:
+	explicit ObstacleAvoidance(const ObstacleGrid* pObstacles = nullptr) : m_pObstacles(pObstacles) {}
+	virtual ~ObstacleAvoidance() = default;
+
+	//Obstacle Avoidance Behavior
+	SteeringOutput CalculateSteering(float deltaT, SteeringAgent* pAgent) override;
+	void CalculateSteeringBatch(float deltaT, const AgentSpan& agents, SteeringOutput* pOutputs) override;
+
+	void SetObstacles(const ObstacleGrid* pObstacles) { m_pObstacles = pObstacles; }
+	void SetAgentRadius(float radius) { m_AgentRadius = radius; } //The same for every agent, the batch has no radii
+	void SetLookAhead(float minDistance, float time) { m_MinLookAhead = minDistance; m_LookAheadTime = time; } //Looks minDistance + time * speed ahead
+
+private:
+	const ObstacleGrid* m_pObstacles;
+	float m_AgentRadius{ 1.f };
+	float m_MinLookAhead{ 2.f };
+	float m_LookAheadTime{ 1.f };
+
+	//Steers away from the first obstacle ahead, invalid when there is none. lookAheadEnd is where the sweep ended
+	SteeringOutput Avoid(const Elite::Vector2& position, const Elite::Vector2& linearVelocity, float maxLinearSpeed, Elite::Vector2& lookAheadEnd) const;
+};
+
 #endif
@@ -10,33 +10,42 @@ void SteeringAgent::Update(float dt)
 	{
 		auto output = m_pSteeringBehavior->CalculateSteering(dt, this);
 
-		//Linear Movement
-		//***************
-		auto linVel{ GetLinearVelocity() };
-		auto steeringForce{ output.LinearVelocity - linVel };
-		auto acceleration{ steeringForce / GetMass() };
-
 		if (m_RenderBehavior)
 		{
+			auto linVel{ GetLinearVelocity() };
+			auto acceleration{ (output.LinearVelocity - linVel) / GetMass() };
+
 			DEBUGRENDERER2D->DrawDirection(GetPosition(), acceleration, 7, { 0, 1, 1, 0.5f }, 0.40f);
 			DEBUGRENDERER2D->DrawDirection(GetPosition(), linVel + acceleration, 7, { 0, 1, 0, 0.5f }, 0.40f);
 			DEBUGRENDERER2D->DrawDirection(GetPosition(), linVel, 7, { 1, 0, 1, 0.5f }, 0.40f);
 		}
-		SetLinearVelocity(linVel + (acceleration * dt));
 
-		//Angular Movement
-		//****************
-		if (m_AutoOrient)
-		{
-			auto desiredOrientation = Elite::VectorToOrientation(GetLinearVelocity());
-			SetRotation(desiredOrientation);
-		}
-		else
-		{
-			if (output.AngularVelocity > m_MaxAngularSpeed)
-				output.AngularVelocity = m_MaxAngularSpeed;
-			SetAngularVelocity(output.AngularVelocity);
-		}
+		ApplySteering(output, dt);
+	}
+}
+
+void SteeringAgent::ApplySteering(SteeringOutput output, float dt)
+{
+	//Linear Movement
+	//***************
+	//At most all the way to the desired velocity, long steps (level of detail) would overshoot it
+	auto linVel{ GetLinearVelocity() };
+	auto steeringForce{ output.LinearVelocity - linVel };
+	auto blend{ min(dt / GetMass(), 1.f) };
+	SetLinearVelocity(linVel + (steeringForce * blend));
+
+	//Angular Movement
+	//****************
+	if (m_AutoOrient)
+	{
+		auto desiredOrientation = Elite::VectorToOrientation(GetLinearVelocity());
+		SetRotation(desiredOrientation);
+	}
+	else
+	{
+		if (output.AngularVelocity > m_MaxAngularSpeed)
+			output.AngularVelocity = m_MaxAngularSpeed;
+		SetAngularVelocity(output.AngularVelocity);
 	}
 }
 
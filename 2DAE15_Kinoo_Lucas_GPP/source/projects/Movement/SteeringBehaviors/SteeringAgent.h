@@ -20,14 +20,16 @@ public:
 	//--- Constructor & Destructor ---
 	SteeringAgent() = default;
 	SteeringAgent(float radius) : BaseAgent(radius) {};
+	SteeringAgent(KinematicAgentPool* pKinematicPool, float radius = 1.f) : BaseAgent(pKinematicPool, radius) { SetMaxLinearSpeed(m_MaxLinearSpeed); };
 	virtual ~SteeringAgent() = default;
 
 	//--- Agent Functions ---
 	void Update(float dt) override;
 	void Render(float dt) override;
+	void ApplySteering(SteeringOutput output, float dt); //Moves the agent like Update does, with a steering output calculated elsewhere (batched)
 
 	float GetMaxLinearSpeed() const { return m_MaxLinearSpeed; }
-	void SetMaxLinearSpeed(float maxLinSpeed) { m_MaxLinearSpeed = maxLinSpeed; }
+	void SetMaxLinearSpeed(float maxLinSpeed) { m_MaxLinearSpeed = maxLinSpeed; if (m_pKinematicPool) m_pKinematicPool->SetMaxLinearSpeed(m_PoolIdx, maxLinSpeed); }
 
 	float GetMaxAngularSpeed() const { return m_MaxAngularSpeed; }
 	void SetMaxAngularSpeed(float maxAngSpeed) { m_MaxAngularSpeed = maxAngSpeed; }
@@ -43,9 +45,18 @@ public:
 	void SetRenderBehavior(bool isEnabled) { m_RenderBehavior = isEnabled; }
 	bool CanRenderBehavior() const { return m_RenderBehavior; }
 
+	//State of the agent for the steering behaviors. Stored in the agent, unless it is moved to storage next to other agents (nullptr moves it back)
+	SteeringState& GetSteeringState() { return m_pSteeringState ? *m_pSteeringState : m_SteeringState; }
+	void SetSteeringState(SteeringState* pState) { m_pSteeringState = pState; }
+
 protected:
+	//Auto orienting agents face their velocity, their angular velocity isn't used
+	float GetRenderRotation() const override { return m_AutoOrient ? Elite::VectorToOrientation(GetLinearVelocity()) : BaseAgent::GetRenderRotation(); }
+
 	//--- Datamembers ---
 	ISteeringBehavior* m_pSteeringBehavior = nullptr;
+	SteeringState m_SteeringState{ Elite::GetRandomStream().NextUInt() };
+	SteeringState* m_pSteeringState = nullptr;
 
 	float m_MaxLinearSpeed = 10.f;
 	float m_MaxAngularSpeed = 10.f;
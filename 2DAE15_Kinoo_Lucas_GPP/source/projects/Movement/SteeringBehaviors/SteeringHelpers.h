@@ -128,6 +128,45 @@ struct SteeringOutput
 	}
 };
 
+//SteeringState
+//What the behaviors remember of an agent between frames. It is kept per agent instead of in the behaviors,
+//so one behavior can steer any number of agents, also from multiple threads.
+struct SteeringState
+{
+	TargetData Target = {}; //Last target the agent was steered to by a behavior that picks its own (wander point, predicted target)
+	float WanderAngle = 0.f;
+	Elite::RandomStream Random; //Random stream of the agent
+
+	//Stream of the global random seed, equal streams give equal numbers
+	explicit SteeringState(unsigned int stream = 0) : Random(Elite::GetRandomSeed(), stream) {}
+};
+
+//AgentSpan
+//Structure of arrays view on a range of agents, the input of the batched steering functions (ISteeringBehavior::CalculateSteeringBatch)
+class SteeringAgent;
+class KinematicAgentPool;
+struct AgentSpan
+{
+	const float* pPositionsX = nullptr;
+	const float* pPositionsY = nullptr;
+	const float* pLinearVelocitiesX = nullptr;
+	const float* pLinearVelocitiesY = nullptr;
+	const float* pOrientations = nullptr;
+	const float* pMaxLinearSpeeds = nullptr;
+	SteeringAgent* const* ppAgents = nullptr; //Optional, needed by behaviors without a batched version
+	SteeringState* pStates = nullptr; //Optional, the state of every agent stored next to each other. Without, the state of ppAgents is used
+	int Count = 0;
+
+	AgentSpan() = default;
+	//Agents [first, first + count) of the pool, ppAgents (optional) are the agents of those pool indices
+	AgentSpan(const KinematicAgentPool& pool, int first, int count, SteeringAgent* const* ppAgents = nullptr);
+
+	//State of agent idx of the span, behaviors that keep state per agent need pStates or ppAgents
+	SteeringState& GetState(int idx) const;
+	//Agents [first, first + count) of this span
+	AgentSpan Slice(int first, int count) const;
+};
+
 //=== TEMPORARILY ADDED HERE - IS PART OF COMBINED STEERING! ===
 struct Goal
 {
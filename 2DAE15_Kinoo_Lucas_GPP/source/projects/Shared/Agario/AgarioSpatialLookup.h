@@ -0,0 +1,130 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// AgarioSpatialLookup.h: Spatial index over the food and the agents of an Agario game,
+// for the searches of the decision making. TSpatialIndex is SpatialHash or LooseQuadtree,
+// every game picks the one that fits its world.
+/*=============================================================================*/
+#ifndef ELITE_AGARIO_SPATIAL_LOOKUP
+#define ELITE_AGARIO_SPATIAL_LOOKUP
+
+#include "AgarioAgent.h"
+#include "AgarioFood.h"
+#include "projects/Movement/SteeringBehaviors/SpacePartitioning/SpacePartitioning.h"
+
+template<typename TSpatialIndex>
+class AgarioSpatialLookup final
+{
+public:
+	//The vectors are owned by the game, point i of an index is entity i of its vector
+	AgarioSpatialLookup(TSpatialIndex foodIndex, TSpatialIndex agentIndex, const std::vector<AgarioFood*>* pFood, const std::vector<AgarioAgent*>* pAgents)
+		: m_FoodIndex{ std::move(foodIndex) }
+		, m_AgentIndex{ std::move(agentIndex) }
+		, m_pFood{ pFood }
+		, m_pAgents{ pAgents }
+	{
+	}
+
+	//Takes the positions of the entities, call again after entities are added or removed from the vectors
+	void Update();
+
+	//The food closest to pos within radius, nullptr if there is none
+	AgarioFood* FindClosestFood(const Elite::Vector2& pos, float radius) const;
+	//The agent closest to pos within radius for which isValid(pAgent) is true, nullptr if there is none. Equal distances: the first agent of the vector
+	template<typename IsValid>
+	AgarioAgent* FindClosestAgent(const Elite::Vector2& pos, float radius, IsValid isValid) const;
+	//The agents within radius of pos, in the order of the vector
+	void FindAgents(const Elite::Vector2& pos, float radius, std::vector<AgarioAgent*>& agents) const;
+
+private:
+	TSpatialIndex m_FoodIndex;
+	TSpatialIndex m_AgentIndex;
+	const std::vector<AgarioFood*>* m_pFood;
+	const std::vector<AgarioAgent*>* m_pAgents;
+
+	// Members to avoid memory allocation on every search
+	std::vector<float> m_PositionsX;
+	std::vector<float> m_PositionsY;
+	mutable std::vector<int> m_Indices;
+
+	template<typename T_AgarioType>
+	void Rebuild(TSpatialIndex& spatialIndex, const std::vector<T_AgarioType*>& entities);
+	void FindAgentIndices(const Elite::Vector2& pos, float radius) const; //Into m_Indices, sorted, without agents that were destroyed since the update
+};
+
+template<typename TSpatialIndex>
+inline void AgarioSpatialLookup<TSpatialIndex>::Update()
+{
+	Rebuild(m_FoodIndex, *m_pFood);
+	Rebuild(m_AgentIndex, *m_pAgents);
+}
+
+template<typename TSpatialIndex>
+inline AgarioFood* AgarioSpatialLookup<TSpatialIndex>::FindClosestFood(const Elite::Vector2& pos, float radius) const
+{
+	int foodIdx{ -1 };
+	if (m_FoodIndex.QueryNearest(pos, radius, -1, 1, &foodIdx) == 0)
+		return nullptr;
+
+	return (*m_pFood)[foodIdx];
+}
+
+template<typename TSpatialIndex>
+template<typename IsValid>
+inline AgarioAgent* AgarioSpatialLookup<TSpatialIndex>::FindClosestAgent(const Elite::Vector2& pos, float radius, IsValid isValid) const
+{
+	FindAgentIndices(pos, radius);
+
+	AgarioAgent* pClosestAgent{ nullptr };
+	float closestDistSqr{ FLT_MAX };
+	for (int agentIdx : m_Indices)
+	{
+		AgarioAgent* pAgent{ (*m_pAgents)[agentIdx] };
+		const float distSqr{ pAgent->GetPosition().DistanceSquared(pos) };
+		if (distSqr < closestDistSqr && isValid(pAgent))
+		{
+			closestDistSqr = distSqr;
+			pClosestAgent = pAgent;
+		}
+	}
+	return pClosestAgent;
+}
+
+template<typename TSpatialIndex>
+inline void AgarioSpatialLookup<TSpatialIndex>::FindAgents(const Elite::Vector2& pos, float radius, std::vector<AgarioAgent*>& agents) const
+{
+	FindAgentIndices(pos, radius);
+
+	agents.clear();
+	for (int agentIdx : m_Indices)
+		agents.push_back((*m_pAgents)[agentIdx]);
+}
+
+template<typename TSpatialIndex>
+template<typename T_AgarioType>
+inline void AgarioSpatialLookup<TSpatialIndex>::Rebuild(TSpatialIndex& spatialIndex, const std::vector<T_AgarioType*>& entities)
+{
+	m_PositionsX.resize(entities.size());
+	m_PositionsY.resize(entities.size());
+	for (size_t idx{ 0 }; idx < entities.size(); ++idx)
+	{
+		const Elite::Vector2 pos{ entities[idx]->GetPosition() };
+		m_PositionsX[idx] = pos.x;
+		m_PositionsY[idx] = pos.y;
+	}
+
+	spatialIndex.Rebuild(m_PositionsX.data(), m_PositionsY.data(), static_cast<int>(entities.size()));
+}
+
+template<typename TSpatialIndex>
+inline void AgarioSpatialLookup<TSpatialIndex>::FindAgentIndices(const Elite::Vector2& pos, float radius) const
+{
+	m_AgentIndex.QueryNeighbors(pos, radius, -1, m_Indices);
+
+	// The game deletes agents while it updates them and only then removes them from the vector
+	m_Indices.erase(std::remove_if(m_Indices.begin(), m_Indices.end(),
+		[this](int agentIdx) { return agentIdx >= static_cast<int>(m_pAgents->size()) || (*m_pAgents)[agentIdx] == nullptr; }), m_Indices.end());
+	std::sort(m_Indices.begin(), m_Indices.end());
+}
+
+#endif
@@ -14,9 +14,18 @@ BaseAgent::BaseAgent(float radius) : m_Radius(radius)
 	m_pRigidBody->AddShape(&shape);
 }
 
+BaseAgent::BaseAgent(KinematicAgentPool* pKinematicPool, float radius)
+	: m_pKinematicPool(pKinematicPool)
+	, m_PoolIdx(pKinematicPool->AddAgent())
+	, m_Radius(radius)
+{
+}
+
 BaseAgent::~BaseAgent()
 {
 	SAFE_DELETE(m_pRigidBody);
+	if (m_pKinematicPool)
+		m_pKinematicPool->RemoveAgent(m_PoolIdx);
 }
 
 void BaseAgent::Update(float dt)
@@ -25,12 +34,32 @@ void BaseAgent::Update(float dt)
 
 void BaseAgent::Render(float dt)
 {
-	auto o = GetRotation();
-	auto p = GetPosition();
+	//Keep the state of the last two steps. Several steps since the last render (or a teleport, like looping
+	//around the world) have no previous step to start from, the agent is drawn at its current state then.
+	auto const step = TIMER->GetNrOfUpdateSteps();
+	if (!m_HasRenderState || step != m_RenderStep)
+	{
+		auto const position = GetPosition();
+		auto const maxStepDistance = 2.f * GetLinearVelocity().Magnitude() * TIMER->GetFixedDeltaT() + m_Radius;
+		auto const hasPreviousStep = m_HasRenderState && step == m_RenderStep + 1
+			&& Elite::DistanceSquared(position, m_CurrentRenderPosition) <= maxStepDistance * maxStepDistance;
+		m_PreviousRenderPosition = hasPreviousStep ? m_CurrentRenderPosition : position;
+		m_PreviousRenderRotation = hasPreviousStep ? m_CurrentRenderRotation : GetRenderRotation();
+		m_CurrentRenderPosition = position;
+		m_CurrentRenderRotation = GetRenderRotation();
+		m_RenderStep = step;
+		m_HasRenderState = true;
+	}
+
+	//With fixed steps the real time is between the last two steps, draw the agent that far from the previous one to the last one.
+	//This draws the state up to a step late, but never ahead of the simulation.
+	auto const alpha = TIMER->GetRenderAlpha();
+	auto o = m_PreviousRenderRotation + Elite::ClampedAngle(m_CurrentRenderRotation - m_PreviousRenderRotation) * alpha;
+	auto p = Elite::Lerp(m_PreviousRenderPosition, m_CurrentRenderPosition, alpha);
 	auto r = Elite::ToRadians(150.f);
 
 	//EliteDebugRenderer2D::GetInstance()->DrawSolidCircle(GetPosition(), m_Radius, { 0,0 }, m_BodyColor);
-	DEBUGRENDERER2D->DrawSolidCircle(GetPosition(), m_Radius, { 0,0 }, m_BodyColor);
+	DEBUGRENDERER2D->DrawSolidCircle(p, m_Radius, { 0,0 }, m_BodyColor);
 
 	std::vector<Elite::Vector2> points;
 	points.push_back(Elite::Vector2(static_cast<float>(cos(o)) * m_Radius, static_cast<float>(sin(o)) * m_Radius) + p);
@@ -1,10 +1,12 @@
 #ifndef BASE_AGENT_H
 #define BASE_AGENT_H
+#include "KinematicAgentPool.h"
 
 class BaseAgent
 {
 public:
 	BaseAgent(float radius = 1.f);
+	BaseAgent(KinematicAgentPool* pKinematicPool, float radius = 1.f); //No rigid body, the state is stored in the pool (no collisions)
 	virtual ~BaseAgent();
 
 	virtual void Update(float dt);
@@ -15,37 +17,53 @@ public:
 	void TrimToWorld(const Elite::Vector2& bottomLeft, const Elite::Vector2& topRight, bool isWorldLooping = true) const;
 
 	//Get - Set
-	Elite::Vector2 GetPosition() const { return m_pRigidBody->GetPosition(); }
-	void SetPosition(const Elite::Vector2& pos) const { m_pRigidBody->SetPosition(pos); }
+	Elite::Vector2 GetPosition() const { return m_pKinematicPool ? m_pKinematicPool->GetPosition(m_PoolIdx) : m_pRigidBody->GetPosition(); }
+	void SetPosition(const Elite::Vector2& pos) const { if (m_pKinematicPool) m_pKinematicPool->SetPosition(m_PoolIdx, pos); else m_pRigidBody->SetPosition(pos); }
 
 	float GetRotation() const {
-		return Elite::ClampedAngle(m_pRigidBody->GetRotation().x);
+		return Elite::ClampedAngle(m_pKinematicPool ? m_pKinematicPool->GetOrientation(m_PoolIdx) : m_pRigidBody->GetRotation().x);
 	}
-	void SetRotation(float rot) const { m_pRigidBody->SetRotation({ rot, 0.0f }); }
+	void SetRotation(float rot) const { if (m_pKinematicPool) m_pKinematicPool->SetOrientation(m_PoolIdx, rot); else m_pRigidBody->SetRotation({ rot, 0.0f }); }
 
-	Elite::Vector2 GetLinearVelocity() const { return m_pRigidBody->GetLinearVelocity(); }
-	void SetLinearVelocity(const Elite::Vector2& linVel) const { m_pRigidBody->SetLinearVelocity(linVel); }
+	Elite::Vector2 GetLinearVelocity() const { return m_pKinematicPool ? m_pKinematicPool->GetLinearVelocity(m_PoolIdx) : m_pRigidBody->GetLinearVelocity(); }
+	void SetLinearVelocity(const Elite::Vector2& linVel) const { if (m_pKinematicPool) m_pKinematicPool->SetLinearVelocity(m_PoolIdx, linVel); else m_pRigidBody->SetLinearVelocity(linVel); }
 
-	float GetAngularVelocity() const { return m_pRigidBody->GetAngularVelocity().x; }
-	void SetAngularVelocity(float angVel) const { m_pRigidBody->SetAngularVelocity({ angVel,0.f }); }
+	float GetAngularVelocity() const { return m_pKinematicPool ? m_pKinematicPool->GetAngularVelocity(m_PoolIdx) : m_pRigidBody->GetAngularVelocity().x; }
+	void SetAngularVelocity(float angVel) const { if (m_pKinematicPool) m_pKinematicPool->SetAngularVelocity(m_PoolIdx, angVel); else m_pRigidBody->SetAngularVelocity({ angVel,0.f }); }
 
-	float GetMass() const { return m_pRigidBody->GetMass(); }
-	void SetMass(float mass) const { m_pRigidBody->SetMass(mass); }
+	float GetMass() const { return m_pKinematicPool ? m_pKinematicPool->GetMass(m_PoolIdx) : m_pRigidBody->GetMass(); }
+	void SetMass(float mass) const { if (m_pKinematicPool) m_pKinematicPool->SetMass(m_PoolIdx, mass); else m_pRigidBody->SetMass(mass); }
 
 	const Elite::Color& GetBodyColor() const { return m_BodyColor; }
 	void SetBodyColor(const Elite::Color& col) { m_BodyColor = col; }
 
-	Elite::RigidBodyUserData GetUserData() const { return m_pRigidBody->GetUserData(); }
-	void SetUserData(Elite::RigidBodyUserData userData) { m_pRigidBody->SetUserData(userData); }
+	//Only agents with a rigid body have user data
+	Elite::RigidBodyUserData GetUserData() const { return m_pRigidBody ? m_pRigidBody->GetUserData() : Elite::RigidBodyUserData{}; }
+	void SetUserData(Elite::RigidBodyUserData userData) { if (m_pRigidBody) m_pRigidBody->SetUserData(userData); }
 
 	float GetRadius() const { return m_Radius; }
 
+	KinematicAgentPool* GetKinematicPool() const { return m_pKinematicPool; }
+	int GetPoolIdx() const { return m_PoolIdx; }
+
 protected:
+	//Orientation drawn for the current state
+	virtual float GetRenderRotation() const { return GetRotation(); }
+
 	RigidBody* m_pRigidBody = nullptr;
+	KinematicAgentPool* m_pKinematicPool = nullptr;
+	int m_PoolIdx = -1;
 	float m_Radius = 1.f;
 	Elite::Color m_BodyColor = { 1,1,0,1 };
 
 private:
+	//Drawn state of the last two update steps, to interpolate between with fixed steps (stored by Render)
+	Elite::Vector2 m_PreviousRenderPosition = {};
+	Elite::Vector2 m_CurrentRenderPosition = {};
+	float m_PreviousRenderRotation = 0.f;
+	float m_CurrentRenderRotation = 0.f;
+	unsigned int m_RenderStep = 0;
+	bool m_HasRenderState = false;
 
 	//C++ make the class non-copyable
 	BaseAgent(const BaseAgent&) {};
@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "KinematicAgentPool.h"
+
+KinematicAgentPool::KinematicAgentPool(float linearDamping /*= 0.01f*/, float angularDamping /*= 0.1f*/)
+	: m_LinearDamping(linearDamping)
+	, m_AngularDamping(angularDamping)
+{
+}
+
+int KinematicAgentPool::AddAgent(const Elite::Vector2& position /*= Elite::ZeroVector2*/, float orientation /*= 0.f*/)
+{
+	int agentIdx{ GetSize() };
+	if (!m_FreeIndices.empty())
+	{
+		agentIdx = m_FreeIndices.back();
+		m_FreeIndices.pop_back();
+	}
+	else
+	{
+		m_PositionsX.push_back(0.f);
+		m_PositionsY.push_back(0.f);
+		m_LinearVelocitiesX.push_back(0.f);
+		m_LinearVelocitiesY.push_back(0.f);
+		m_Orientations.push_back(0.f);
+		m_AngularVelocities.push_back(0.f);
+		m_Masses.push_back(1.f);
+		m_MaxLinearSpeeds.push_back(0.f);
+	}
+
+	SetPosition(agentIdx, position);
+	SetOrientation(agentIdx, orientation);
+	return agentIdx;
+}
+
+void KinematicAgentPool::RemoveAgent(int agentIdx)
+{
+	//Reset the slot so it stands still until it is reused
+	SetLinearVelocity(agentIdx, Elite::ZeroVector2);
+	SetAngularVelocity(agentIdx, 0.f);
+	SetMass(agentIdx, 1.f);
+	SetMaxLinearSpeed(agentIdx, 0.f);
+	m_FreeIndices.push_back(agentIdx);
+}
+
+void KinematicAgentPool::Reserve(size_t amount)
+{
+	m_PositionsX.reserve(amount);
+	m_PositionsY.reserve(amount);
+	m_LinearVelocitiesX.reserve(amount);
+	m_LinearVelocitiesY.reserve(amount);
+	m_Orientations.reserve(amount);
+	m_AngularVelocities.reserve(amount);
+	m_Masses.reserve(amount);
+	m_MaxLinearSpeeds.reserve(amount);
+}
+
+void KinematicAgentPool::Integrate(float deltaT)
+{
+	//Same order as a Box2D step: damp the velocities, then move with the new velocities
+	const float linearDampingFactor{ 1.f / (1.f + deltaT * m_LinearDamping) };
+	const float angularDampingFactor{ 1.f / (1.f + deltaT * m_AngularDamping) };
+
+	//Plain loops over the arrays, so the compiler can vectorize them
+	const int size{ GetSize() };
+	float* pPositionsX{ m_PositionsX.data() };
+	float* pPositionsY{ m_PositionsY.data() };
+	float* pVelocitiesX{ m_LinearVelocitiesX.data() };
+	float* pVelocitiesY{ m_LinearVelocitiesY.data() };
+	for (int idx{ 0 }; idx < size; ++idx)
+	{
+		pVelocitiesX[idx] *= linearDampingFactor;
+		pVelocitiesY[idx] *= linearDampingFactor;
+		pPositionsX[idx] += pVelocitiesX[idx] * deltaT;
+		pPositionsY[idx] += pVelocitiesY[idx] * deltaT;
+	}
+
+	float* pOrientations{ m_Orientations.data() };
+	float* pAngularVelocities{ m_AngularVelocities.data() };
+	for (int idx{ 0 }; idx < size; ++idx)
+	{
+		pAngularVelocities[idx] *= angularDampingFactor;
+		pOrientations[idx] += pAngularVelocities[idx] * deltaT;
+	}
+}
+
+void KinematicAgentPool::TrimToWorld(const Elite::Vector2& bottomLeft, const Elite::Vector2& topRight, bool isWorldLooping /*= true*/)
+{
+	//Same rules as BaseAgent::TrimToWorld, for every agent
+	const int size{ GetSize() };
+	float* pPositionsX{ m_PositionsX.data() };
+	float* pPositionsY{ m_PositionsY.data() };
+	if (isWorldLooping)
+	{
+		for (int idx{ 0 }; idx < size; ++idx)
+		{
+			const float x{ pPositionsX[idx] };
+			const float y{ pPositionsY[idx] };
+			pPositionsX[idx] = x > topRight.x ? bottomLeft.x : (x < bottomLeft.x ? topRight.x : x);
+			pPositionsY[idx] = y > topRight.y ? bottomLeft.y : (y < bottomLeft.y ? topRight.y : y);
+		}
+	}
+	else
+	{
+		for (int idx{ 0 }; idx < size; ++idx)
+		{
+			pPositionsX[idx] = Elite::Clamp(pPositionsX[idx], bottomLeft.x, topRight.x);
+			pPositionsY[idx] = Elite::Clamp(pPositionsY[idx], bottomLeft.y, topRight.y);
+		}
+	}
+}
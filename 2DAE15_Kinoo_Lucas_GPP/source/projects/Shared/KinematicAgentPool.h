@@ -0,0 +1,69 @@
+#ifndef KINEMATIC_AGENT_POOL_H
+#define KINEMATIC_AGENT_POOL_H
+
+//Agents without a rigid body: their state is stored as structure of arrays and integrated in one loop.
+//Meant for agents that don't need collisions (flocks, crowds), agents that do keep using a Box2D rigid body.
+//The integration matches the one of Box2D for a dynamic body without contacts (velocity damping, then position).
+class KinematicAgentPool final
+{
+public:
+	KinematicAgentPool(float linearDamping = 0.01f, float angularDamping = 0.1f);
+
+	int AddAgent(const Elite::Vector2& position = Elite::ZeroVector2, float orientation = 0.f);
+	void RemoveAgent(int agentIdx); //The index is reused by the next added agent
+	void Reserve(size_t amount);
+
+	int GetSize() const { return static_cast<int>(m_PositionsX.size()); } //Including removed agents, which don't move
+	int GetNrOfAgents() const { return GetSize() - static_cast<int>(m_FreeIndices.size()); }
+
+	void Integrate(float deltaT);
+	void TrimToWorld(const Elite::Vector2& bottomLeft, const Elite::Vector2& topRight, bool isWorldLooping = true);
+
+	//Get - Set
+	Elite::Vector2 GetPosition(int agentIdx) const { return { m_PositionsX[agentIdx], m_PositionsY[agentIdx] }; }
+	void SetPosition(int agentIdx, const Elite::Vector2& pos) { m_PositionsX[agentIdx] = pos.x; m_PositionsY[agentIdx] = pos.y; }
+
+	float GetOrientation(int agentIdx) const { return m_Orientations[agentIdx]; }
+	void SetOrientation(int agentIdx, float orientation) { m_Orientations[agentIdx] = orientation; }
+
+	Elite::Vector2 GetLinearVelocity(int agentIdx) const { return { m_LinearVelocitiesX[agentIdx], m_LinearVelocitiesY[agentIdx] }; }
+	void SetLinearVelocity(int agentIdx, const Elite::Vector2& linVel) { m_LinearVelocitiesX[agentIdx] = linVel.x; m_LinearVelocitiesY[agentIdx] = linVel.y; }
+
+	float GetAngularVelocity(int agentIdx) const { return m_AngularVelocities[agentIdx]; }
+	void SetAngularVelocity(int agentIdx, float angVel) { m_AngularVelocities[agentIdx] = angVel; }
+
+	//Like Box2D, a mass of zero or less becomes 1
+	float GetMass(int agentIdx) const { return m_Masses[agentIdx]; }
+	void SetMass(int agentIdx, float mass) { m_Masses[agentIdx] = mass > 0.f ? mass : 1.f; }
+
+	float GetMaxLinearSpeed(int agentIdx) const { return m_MaxLinearSpeeds[agentIdx]; }
+	void SetMaxLinearSpeed(int agentIdx, float maxLinSpeed) { m_MaxLinearSpeeds[agentIdx] = maxLinSpeed; }
+
+	//Raw arrays (GetSize() elements each), for batched processing
+	const float* GetPositionsX() const { return m_PositionsX.data(); }
+	const float* GetPositionsY() const { return m_PositionsY.data(); }
+	const float* GetLinearVelocitiesX() const { return m_LinearVelocitiesX.data(); }
+	const float* GetLinearVelocitiesY() const { return m_LinearVelocitiesY.data(); }
+	const float* GetOrientations() const { return m_Orientations.data(); }
+	const float* GetMaxLinearSpeeds() const { return m_MaxLinearSpeeds.data(); }
+
+private:
+	//Datamembers
+	std::vector<float> m_PositionsX;
+	std::vector<float> m_PositionsY;
+	std::vector<float> m_LinearVelocitiesX;
+	std::vector<float> m_LinearVelocitiesY;
+	std::vector<float> m_Orientations;
+	std::vector<float> m_AngularVelocities;
+	std::vector<float> m_Masses;
+	std::vector<float> m_MaxLinearSpeeds;
+	std::vector<int> m_FreeIndices;
+
+	float m_LinearDamping = 0.01f;
+	float m_AngularDamping = 0.1f;
+
+	//C++ make the class non-copyable
+	KinematicAgentPool(const KinematicAgentPool&) = delete;
+	KinematicAgentPool& operator=(const KinematicAgentPool&) = delete;
+};
+#endif
@@ -168,6 +168,8 @@ extern bool gRequestShutdown;
 ===========================================================================*/
 #pragma region FrameworkIncludes
 #include "framework/EliteHelpers/ESingleton.h"
+#include "framework/EliteHelpers/ESpan.h"
+#include "framework/EliteHelpers/EJobSystem.h"
 #include "framework/EliteMath/EMath.h"
 #include "framework/ElitePhysics/EPhysics.h"
 #include "framework/EliteInput/EInputCodes.h"
@@ -186,6 +188,7 @@ extern bool gRequestShutdown;
 #define DEBUGRENDERER2D EliteDebugRenderer2D::GetInstance()
 #define PHYSICSWORLD PhysicsWorld::GetInstance()
 #define LEVELLOADER LevelLoader::GetInstance()
+#define JOBSYSTEM Elite::JobSystem::GetInstance()
 
 /* --- PLATFORM SPECIFIC INCLUDES --- */
 #pragma region PlatformIncludes